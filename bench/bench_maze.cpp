@@ -0,0 +1,262 @@
+#include "bench_maze.hpp"
+
+#include <stdio.h>
+#include <time.h>
+#include <unistd.h>
+#include <vector>
+
+using namespace std;
+
+/**
+ * Returns the current time of a monotonic clock
+ * @returns time in seconds
+ */
+double BenchMaze::now() {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/**
+ * Returns the resident memory of the process, read from /proc
+ * @returns bytes resident, 0 if it can't be read
+ */
+long BenchMaze::residentBytes() {
+	FILE* pFile = fopen("/proc/self/statm", "r");
+	if (pFile == NULL) { return 0; }
+
+	long size = 0, resident = 0;
+	if (fscanf(pFile, "%ld %ld", &size, &resident) != 2) { resident = 0; }
+	fclose(pFile);
+	return resident * sysconf(_SC_PAGESIZE);
+}
+
+/**
+ * Creates a maze of the size provided where each cell is randomly
+ * made solid. The start and end corners are always left empty.
+ * @param dim - size of the maze
+ * @param solidPercent - chance out of 100 of a cell being solid
+ * @param seed - seed of the random walls, same seed same maze
+ * @param storage - how the maze's cells will be stored
+ * @param layout - order of the cells within the grid
+ * @returns the new maze, owned by the caller
+ */
+Maze* BenchMaze::createRandomMaze(Maze::tDimension dim, int solidPercent, unsigned int seed,
+		Maze::eStorage storage, Maze::eLayout layout) {
+	Maze* pMaze = new Maze(dim, storage, layout);
+
+	// Simple LCG so the same seed builds the same maze on every platform
+	unsigned int rnd = seed;
+	for (int x=0; x < dim.width; x++) {
+		for (int y=0; y < dim.height; y++) {
+			for (int z=0; z < dim.depth; z++) {
+				rnd = rnd * 1103515245 + 12345;
+				Maze::eCell state = ((int)((rnd >> 16) % 100) < solidPercent) ? Maze::CELL_SOLID : Maze::CELL_EMPTY;
+				if (state != pMaze->getDefaultState()) {
+					pMaze->updateCell(Maze::tCoord(x, y, z), state);
+				}
+			}
+		}
+	}
+
+	pMaze->updateCell(Maze::tCoord(0, 0, 0), Maze::CELL_EMPTY);
+	pMaze->updateCell(Maze::tCoord(dim.width - 1, dim.height - 1, dim.depth - 1), Maze::CELL_EMPTY);
+	return pMaze;
+}
+
+/**
+ * Creates a maze of the size provided that is solid rock except for
+ * straight tunnels dug along random axes. Tunnels always connect to
+ * the cell at the origin, so they form one connected network.
+ * @param dim - size of the maze
+ * @param numTunnels - number of tunnels to dig
+ * @param seed - seed of the random tunnels, same seed same maze
+ * @param storage - how the maze's cells will be stored
+ * @returns the new maze, owned by the caller
+ */
+Maze* BenchMaze::createTunnelMaze(Maze::tDimension dim, int numTunnels, unsigned int seed, Maze::eStorage storage) {
+	Maze* pMaze = new Maze(dim, storage);
+
+	// Start solid no matter what the storage's default is
+	if (pMaze->getDefaultState() != Maze::CELL_SOLID) {
+		for (int x=0; x < dim.width; x++) {
+			for (int y=0; y < dim.height; y++) {
+				for (int z=0; z < dim.depth; z++) {
+					pMaze->updateCell(Maze::tCoord(x, y, z), Maze::CELL_SOLID);
+				}
+			}
+		}
+	}
+
+	// Each tunnel starts at the end of the previous one, so all are connected
+	unsigned int rnd = seed;
+	Maze::tCoord loc = Maze::tCoord(0, 0, 0);
+	pMaze->updateCell(loc, Maze::CELL_EMPTY);
+	for (int tunnel=0; tunnel < numTunnels; tunnel++) {
+		rnd = rnd * 1103515245 + 12345;
+		Maze::eDirection dir = (Maze::eDirection)((rnd >> 16) % Maze::NUM_DIRECTIONS);
+		rnd = rnd * 1103515245 + 12345;
+		int length = 4 + (rnd >> 16) % 60;
+
+		for (int step=0; step < length; step++) {
+			Maze::tCoord next = loc + Maze::step(dir);
+			if (!pMaze->isValidCoord(next)) { break; }
+			loc = next;
+			pMaze->updateCell(loc, Maze::CELL_EMPTY);
+		}
+	}
+
+	return pMaze;
+}
+
+/**
+ * Creates a labyrinth of the size provided, a single route between any
+ * two of its passages. Passages are carved between the cells with even
+ * coordinates by a depth first walk, so every wall between them that
+ * the walk didn't cross is left solid.
+ * @param dim - size of the maze
+ * @param seed - seed of the walk, same seed same maze
+ * @returns the new maze, owned by the caller
+ */
+Maze* BenchMaze::createLabyrinth(Maze::tDimension dim, unsigned int seed) {
+	Maze* pMaze = new Maze(dim);
+	for (int x=0; x < dim.width; x++) {
+		for (int y=0; y < dim.height; y++) {
+			for (int z=0; z < dim.depth; z++) {
+				if (x % 2 != 0 || y % 2 != 0 || z % 2 != 0) {
+					pMaze->updateCell(Maze::tCoord(x, y, z), Maze::CELL_SOLID);
+				}
+			}
+		}
+	}
+
+	// Cells on the walk are marked by opening the wall they were entered through
+	Maze::tDimension rooms = Maze::tDimension((dim.width + 1) / 2, (dim.height + 1) / 2, (dim.depth + 1) / 2);
+	vector<bool> visited(rooms.width * rooms.height * rooms.depth, false);
+	vector<Maze::tCoord> walk;
+	walk.push_back(Maze::tCoord(0, 0, 0));
+	visited[0] = true;
+
+	unsigned int rnd = seed;
+	while (!walk.empty()) {
+		Maze::tCoord room = walk.back();
+
+		// Pick a random unvisited neighboring room to carve into
+		int options[Maze::NUM_DIRECTIONS];
+		int numOptions = 0;
+		for (int dir=0; dir < Maze::NUM_DIRECTIONS; dir++) {
+			Maze::tCoord next = room + Maze::step((Maze::eDirection)dir);
+			if (next.x < 0 || next.y < 0 || next.z < 0) { continue; }
+			if (next.x >= rooms.width || next.y >= rooms.height || next.z >= rooms.depth) { continue; }
+			if (visited[(next.x * rooms.height + next.y) * rooms.depth + next.z]) { continue; }
+			options[numOptions++] = dir;
+		}
+		if (numOptions == 0) {
+			walk.pop_back();
+			continue;
+		}
+
+		rnd = rnd * 1103515245 + 12345;
+		Maze::tCoord offset = Maze::step((Maze::eDirection)options[(rnd >> 16) % numOptions]);
+		Maze::tCoord next = room + offset;
+		pMaze->updateCell(Maze::tCoord(room.x * 2 + offset.x, room.y * 2 + offset.y, room.z * 2 + offset.z),
+			Maze::CELL_EMPTY);
+		visited[(next.x * rooms.height + next.y) * rooms.depth + next.z] = true;
+		walk.push_back(next);
+	}
+
+	return pMaze;
+}
+
+/**
+ * Creates a maze by tiling the maze of a config file along every axis.
+ * Every other tile is mirrored so the cells on the edges of neighboring
+ * tiles line up. Bots and exits of the config are left as empty cells.
+ * @param cfg - loaded config of the maze to tile
+ * @param tiles - number of tiles along each axis
+ * @returns the new maze, owned by the caller, or NULL if the config is empty
+ */
+Maze* BenchMaze::createTiledMaze(EnvConfig &cfg, int tiles) {
+	Maze::tDimension dim = cfg.getDim();
+	if (dim.width <= 0 || dim.height <= 0 || dim.depth <= 0) { return NULL; }
+	Maze* pMaze = new Maze(Maze::tDimension(dim.width * tiles, dim.height * tiles, dim.depth * tiles));
+
+	EnvConfig::tMazeRows rows = cfg.getMazeRows();
+	for (int row=0; row < (int)rows.size(); row++) {
+		for (int x=0; x < (int)rows[row].size(); x++) {
+			if (rows[row][x] != Maze::CELL_SOLID) { continue; }
+
+			Maze::tCoord coord = EnvConfig::calcCoordFromRowDim(x, row, dim);
+			for (int tx=0; tx < tiles; tx++) {
+				for (int ty=0; ty < tiles; ty++) {
+					for (int tz=0; tz < tiles; tz++) {
+						pMaze->updateCell(tiledCoord(dim, Maze::tCoord(tx, ty, tz), coord), Maze::CELL_SOLID);
+					}
+				}
+			}
+		}
+	}
+
+	return pMaze;
+}
+
+/**
+ * Returns the coordinate in a tiled maze of a coordinate in one of the tiles.
+ * @param dim - size of a single tile
+ * @param tile - tile the coordinate is in
+ * @param coord - coordinate within the config's maze
+ * @returns the coordinate in the tiled maze
+ */
+Maze::tCoord BenchMaze::tiledCoord(Maze::tDimension dim, Maze::tCoord tile, Maze::tCoord coord) {
+	int x = (tile.x % 2) ? dim.width - 1 - coord.x : coord.x;
+	int y = (tile.y % 2) ? dim.height - 1 - coord.y : coord.y;
+	int z = (tile.z % 2) ? dim.depth - 1 - coord.z : coord.z;
+	return Maze::tCoord(tile.x * dim.width + x, tile.y * dim.height + y, tile.z * dim.depth + z);
+}
+
+/**
+ * Returns the number of bytes used to store the grid's cells
+ * @param pGrid - grid to measure
+ * @returns bytes of cell storage
+ */
+long BenchMaze::gridBytes(Maze::tGrid* pGrid) {
+	switch (pGrid->storage) {
+		case Maze::STORAGE_PACKED:
+			return pGrid->walls.numWords() * sizeof(BitLayer::tWord);
+		case Maze::STORAGE_SPARSE:
+			return pGrid->chunks.size() * sizeof(Maze::tCell*) +
+				pGrid->numChunks * (1 << (3 * Maze::BRICK_BITS)) * sizeof(Maze::tCell);
+		default:
+			return pGrid->size * sizeof(Maze::tCell);
+	}
+}
+
+/**
+ * Counts the cells reachable from the coordinate provided by flooding
+ * the grid breadth first through open neighbors.
+ * @param pGrid - grid to flood
+ * @param start - cell to start flooding from
+ * @returns number of cells reached
+ */
+long BenchMaze::floodCount(Maze::tGrid* pGrid, Maze::tCoord start) {
+	vector<char> visited(pGrid->size, 0);
+	vector<Maze::tIndex> queue;
+	queue.reserve(pGrid->size);
+
+	Maze::tIndex first = pGrid->index(start);
+	visited[first] = 1;
+	queue.push_back(first);
+
+	for (size_t head=0; head < queue.size(); head++) {
+		Maze::tIndex idx = queue[head];
+		for (int dir=0; dir < Maze::NUM_DIRECTIONS; dir++) {
+			Maze::tIndex next = pGrid->neighbor(idx, (Maze::eDirection)dir);
+			if (!visited[next] && pGrid->isOpen(next)) {
+				visited[next] = 1;
+				queue.push_back(next);
+			}
+		}
+	}
+
+	return queue.size();
+}
@@ -0,0 +1,98 @@
+#ifndef _BENCH_MAZE_HPP_
+#define _BENCH_MAZE_HPP_
+
+#include "maze.hpp"
+#include "env_config.hpp"
+
+/**
+ * Helpers shared by the benchmarks to build large generated mazes
+ * and time the work done on them.
+ */
+namespace BenchMaze {
+
+	/**
+	 * Returns the current time of a monotonic clock
+	 * @returns time in seconds
+	 */
+	double now();
+
+	/**
+	 * Returns the resident memory of the process, read from /proc
+	 * @returns bytes resident, 0 if it can't be read
+	 */
+	long residentBytes();
+
+	/**
+	 * Creates a maze of the size provided where each cell is randomly
+	 * made solid. The start and end corners are always left empty.
+	 * @param dim - size of the maze
+	 * @param solidPercent - chance out of 100 of a cell being solid
+	 * @param seed - seed of the random walls, same seed same maze
+	 * @param storage - how the maze's cells will be stored
+	 * @param layout - order of the cells within the grid
+	 * @returns the new maze, owned by the caller
+	 */
+	Maze* createRandomMaze(Maze::tDimension dim, int solidPercent, unsigned int seed,
+		Maze::eStorage storage=Maze::STORAGE_CELLS, Maze::eLayout layout=Maze::LAYOUT_LINEAR);
+
+	/**
+	 * Creates a maze of the size provided that is solid rock except for
+	 * straight tunnels dug along random axes. Tunnels always connect to
+	 * the cell at the origin, so they form one connected network.
+	 * @param dim - size of the maze
+	 * @param numTunnels - number of tunnels to dig
+	 * @param seed - seed of the random tunnels, same seed same maze
+	 * @param storage - how the maze's cells will be stored
+	 * @returns the new maze, owned by the caller
+	 */
+	Maze* createTunnelMaze(Maze::tDimension dim, int numTunnels, unsigned int seed,
+		Maze::eStorage storage=Maze::STORAGE_CELLS);
+
+	/**
+	 * Creates a labyrinth of the size provided, a single route between any
+	 * two of its passages. Passages are carved between the cells with even
+	 * coordinates by a depth first walk, so every wall between them that
+	 * the walk didn't cross is left solid.
+	 * @param dim - size of the maze
+	 * @param seed - seed of the walk, same seed same maze
+	 * @returns the new maze, owned by the caller
+	 */
+	Maze* createLabyrinth(Maze::tDimension dim, unsigned int seed);
+
+	/**
+	 * Creates a maze by tiling the maze of a config file along every axis.
+	 * Every other tile is mirrored so the cells on the edges of neighboring
+	 * tiles line up. Bots and exits of the config are left as empty cells.
+	 * @param cfg - loaded config of the maze to tile
+	 * @param tiles - number of tiles along each axis
+	 * @returns the new maze, owned by the caller, or NULL if the config is empty
+	 */
+	Maze* createTiledMaze(EnvConfig &cfg, int tiles);
+
+	/**
+	 * Returns the coordinate in a tiled maze of a coordinate in one of the tiles.
+	 * @param dim - size of a single tile
+	 * @param tile - tile the coordinate is in
+	 * @param coord - coordinate within the config's maze
+	 * @returns the coordinate in the tiled maze
+	 */
+	Maze::tCoord tiledCoord(Maze::tDimension dim, Maze::tCoord tile, Maze::tCoord coord);
+
+	/**
+	 * Returns the number of bytes used to store the grid's cells
+	 * @param pGrid - grid to measure
+	 * @returns bytes of cell storage
+	 */
+	long gridBytes(Maze::tGrid* pGrid);
+
+	/**
+	 * Counts the cells reachable from the coordinate provided by flooding
+	 * the grid breadth first through open neighbors.
+	 * @param pGrid - grid to flood
+	 * @param start - cell to start flooding from
+	 * @returns number of cells reached
+	 */
+	long floodCount(Maze::tGrid* pGrid, Maze::tCoord start);
+}
+
+#endif // !defined(_BENCH_MAZE_HPP_)
@@ -0,0 +1,1163 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+#include "maze.hpp"
+#include "pathfind.hpp"
+#include "clustergraph.hpp"
+#include "distancefield.hpp"
+#include "parallelbfs.hpp"
+#include "wavefront.hpp"
+#include "routecache.hpp"
+#include "packedroute.hpp"
+#include "junctiongraph.hpp"
+#include "bench_maze.hpp"
+
+using namespace std;
+
+/**
+ * Compares flooding 3D heavy mazes with the cells stored in the linear,
+ * Morton, and brick layouts.
+ */
+void benchLayouts() {
+	Maze::eLayout layouts[] = { Maze::LAYOUT_LINEAR, Maze::LAYOUT_MORTON, Maze::LAYOUT_BRICK };
+	const char* names[] = { "linear", "morton", "brick" };
+	Maze::eStorage storages[] = { Maze::STORAGE_CELLS, Maze::STORAGE_PACKED };
+	const char* storageNames[] = { "cells", "packed" };
+	Maze::tDimension dims[] = { Maze::tDimension(128, 128, 128), Maze::tDimension(64, 256, 64) };
+
+	printf("== layouts: flood fill of a maze with 20%% random walls\n");
+	printf("%-14s %-8s %-8s %10s %10s %10s\n", "maze", "storage", "layout", "build ms", "flood ms", "cells");
+	for (int d=0; d < 2; d++) {
+		for (int s=0; s < 2; s++) {
+			for (int l=0; l < 3; l++) {
+				double start = BenchMaze::now();
+				Maze* pMaze = BenchMaze::createRandomMaze(dims[d], 20, 42, storages[s], layouts[l]);
+				double built = BenchMaze::now();
+				long reached = BenchMaze::floodCount(pMaze->getGrid(), Maze::tCoord(0, 0, 0));
+				double flooded = BenchMaze::now();
+
+				printf("%-14s %-8s %-8s %10.1f %10.1f %10ld\n", dims[d].String().c_str(), storageNames[s], names[l],
+					(built - start) * 1000, (flooded - built) * 1000, reached);
+				delete pMaze;
+			}
+		}
+	}
+	printf("\n");
+}
+
+/**
+ * Compares the memory and speed of the storage options on a huge maze
+ * that is almost entirely solid rock.
+ */
+void benchStorage() {
+	Maze::eStorage storages[] = { Maze::STORAGE_CELLS, Maze::STORAGE_PACKED, Maze::STORAGE_SPARSE };
+	const char* names[] = { "cells", "packed", "sparse" };
+	Maze::tDimension dim = Maze::tDimension(512, 64, 512);
+
+	printf("== storage: %s maze of solid rock with 2000 tunnels\n", dim.String().c_str());
+	printf("%-8s %10s %12s %10s %10s\n", "storage", "build ms", "bytes", "flood ms", "cells");
+	for (int s=0; s < 3; s++) {
+		double start = BenchMaze::now();
+		Maze* pMaze = BenchMaze::createTunnelMaze(dim, 2000, 7, storages[s]);
+		double built = BenchMaze::now();
+		long reached = BenchMaze::floodCount(pMaze->getGrid(), Maze::tCoord(0, 0, 0));
+		double flooded = BenchMaze::now();
+
+		printf("%-8s %10.1f %12ld %10.1f %10ld\n", names[s], (built - start) * 1000,
+			BenchMaze::gridBytes(pMaze->getGrid()), (flooded - built) * 1000, reached);
+		delete pMaze;
+	}
+	printf("\n");
+}
+
+/**
+ * Compares the PathTree search with the breadth first search over flat
+ * arrays, finding routes across open cubes corner to corner.
+ */
+void benchSearch() {
+	PathFind::eStrategy strategies[] = { PathFind::SEARCH_TREE, PathFind::SEARCH_BFS };
+	const char* names[] = { "tree", "bfs" };
+	int sizes[] = { 3, 4, 5, 64 };
+
+	printf("== search: corner to corner route across an open cube\n");
+	printf("%-14s %-8s %10s %10s %10s\n", "maze", "search", "search ms", "expanded", "route");
+	for (int d=0; d < 4; d++) {
+		Maze::tDimension dim = Maze::tDimension(sizes[d], sizes[d], sizes[d]);
+		Maze maze(dim);
+		for (int s=0; s < 2; s++) {
+			// The tree search never finishes on the large cube
+			if (strategies[s] == PathFind::SEARCH_TREE && sizes[d] > 5) { continue; }
+
+			PathFind pathfinder;
+			pathfinder.setGrid(maze.getGrid());
+			pathfinder.setStrategy(strategies[s]);
+			pathfinder.setLoc(Maze::tCoord(0, 0, 0));
+
+			double start = BenchMaze::now();
+			PathFind::tRoute route = pathfinder.findRoute(Maze::tCoord(dim.width-1, dim.height-1, dim.depth-1));
+			double searched = BenchMaze::now();
+
+			printf("%-14s %-8s %10.2f %10ld %10d\n", dim.String().c_str(), names[s],
+				(searched - start) * 1000, pathfinder.getExpandedCount(), (int)route.size());
+		}
+	}
+	printf("\n");
+}
+
+/**
+ * Compares breadth first search with A* on open, randomly walled, and
+ * tunnel mazes, routing from the origin to the open cell furthest along
+ * the grid.
+ */
+void benchAStar() {
+	PathFind::eStrategy strategies[] = { PathFind::SEARCH_BFS, PathFind::SEARCH_ASTAR };
+	const char* names[] = { "bfs", "astar" };
+	const char* mazeNames[] = { "open", "walls", "tunnels" };
+	Maze* mazes[] = {
+		new Maze(Maze::tDimension(128, 128, 128)),
+		BenchMaze::createRandomMaze(Maze::tDimension(128, 128, 128), 20, 42),
+		BenchMaze::createTunnelMaze(Maze::tDimension(256, 64, 256), 400, 7)
+	};
+
+	printf("== astar: route from the origin to the furthest open cell\n");
+	printf("%-8s %-14s %-8s %10s %10s %10s\n", "maze", "size", "search", "search ms", "expanded", "route");
+	for (int m=0; m < 3; m++) {
+		Maze::tGrid* pGrid = mazes[m]->getGrid();
+
+		// Find the open cell furthest along the grid to route to
+		Maze::tCoord dest;
+		for (Maze::tIndex idx=pGrid->size - 1; idx >= 0; idx--) {
+			if (pGrid->isOpen(idx)) {
+				dest = pGrid->coord(idx);
+				break;
+			}
+		}
+
+		for (int s=0; s < 2; s++) {
+			PathFind pathfinder;
+			pathfinder.setGrid(pGrid);
+			pathfinder.setStrategy(strategies[s]);
+			pathfinder.setLoc(Maze::tCoord(0, 0, 0));
+
+			double start = BenchMaze::now();
+			PathFind::tRoute route = pathfinder.findRoute(dest);
+			double searched = BenchMaze::now();
+
+			printf("%-8s %-14s %-8s %10.2f %10ld %10d\n", mazeNames[m], pGrid->dim.String().c_str(),
+				names[s], (searched - start) * 1000, pathfinder.getExpandedCount(), (int)route.size());
+		}
+		delete mazes[m];
+	}
+	printf("\n");
+}
+
+/**
+ * Compares breadth first search with the bidirectional search on the
+ * test config mazes tiled into large mazes. Routes are found from a bot's
+ * start to the exit corner to corner across the whole maze, and between
+ * tiles inside of the maze.
+ */
+void benchBidirectional() {
+	const char* configs[] = { "test/configs/input00", "test/configs/input01" };
+	int tiles[] = { 8, 24 };
+	PathFind::eStrategy strategies[] = { PathFind::SEARCH_BFS, PathFind::SEARCH_BIDIRECTIONAL };
+	const char* names[] = { "bfs", "bidir" };
+	const char* queries[] = { "corner", "inner" };
+
+	printf("== bidirectional: start to exit across the test configs tiled in every axis\n");
+	printf("%-22s %-14s %-8s %-8s %10s %10s %10s\n", "config", "size", "query", "search", "search ms", "expanded", "route");
+	for (int c=0; c < 2; c++) {
+		EnvConfig cfg;
+		char fileName[100] = {0x00};
+		strncpy(fileName, configs[c], sizeof(fileName) - 1);
+		if (!cfg.parseEnv(fileName)) {
+			printf("Failed to load %s\n", configs[c]);
+			continue;
+		}
+
+		for (int t=0; t < 2; t++) {
+			Maze* pMaze = BenchMaze::createTiledMaze(cfg, tiles[t]);
+
+			for (int q=0; q < 2; q++) {
+				// Corner to corner, or from a quarter of the way in to three quarters
+				int first = (q == 0) ? 0 : tiles[t] / 4;
+				int last = (q == 0) ? tiles[t] - 1 : tiles[t] * 3 / 4 - 1;
+				Maze::tCoord from = BenchMaze::tiledCoord(cfg.getDim(), Maze::tCoord(first, first, first),
+					cfg.getBotCoords().begin()->second);
+				Maze::tCoord dest = BenchMaze::tiledCoord(cfg.getDim(), Maze::tCoord(last, last, last), cfg.getExitCoord());
+
+				for (int s=0; s < 2; s++) {
+					PathFind pathfinder;
+					pathfinder.setGrid(pMaze->getGrid());
+					pathfinder.setStrategy(strategies[s]);
+					pathfinder.setLoc(from);
+
+					double start = BenchMaze::now();
+					PathFind::tRoute route = pathfinder.findRoute(dest);
+					double searched = BenchMaze::now();
+
+					printf("%-22s %-14s %-8s %-8s %10.2f %10ld %10d\n", configs[c], pMaze->getGrid()->dim.String().c_str(),
+						queries[q], names[s], (searched - start) * 1000, pathfinder.getExpandedCount(), (int)route.size());
+				}
+			}
+			delete pMaze;
+		}
+	}
+	printf("\n");
+}
+
+/**
+ * Compares A* with the jump point search on mazes of large open halls
+ * connected by doors, routing from one corner to the opposite one. The
+ * jump point search's cost is in the cells its jumps scan as much as in
+ * the jump points it expands, so both are reported.
+ */
+void benchJumpPoint() {
+	PathFind::eStrategy strategies[] = { PathFind::SEARCH_ASTAR, PathFind::SEARCH_JUMP_POINT };
+	const char* names[] = { "astar", "jps" };
+	int halls[] = { 1, 3, 5 };
+
+	printf("== jump point: corner to corner through open halls connected by doors\n");
+	printf("%-14s %-6s %-8s %10s %10s %12s %10s\n", "maze", "halls", "search", "search ms", "expanded",
+		"jump scanned", "route");
+	for (int h=0; h < 3; h++) {
+		Maze::tDimension dim = Maze::tDimension(128, 64, 128);
+		Maze maze(dim);
+
+		// Split the maze into halls with walls across X, each with a door
+		// in alternating corners so the route has to cross every hall.
+		for (int wall=1; wall < halls[h]; wall++) {
+			int x = wall * dim.width / halls[h];
+			for (int y=0; y < dim.height; y++) {
+				for (int z=0; z < dim.depth; z++) {
+					maze.updateCell(Maze::tCoord(x, y, z), Maze::CELL_SOLID);
+				}
+			}
+			int doorZ = (wall % 2) ? dim.depth - 2 : 1;
+			maze.updateCell(Maze::tCoord(x, dim.height / 2, doorZ), Maze::CELL_EMPTY);
+		}
+
+		for (int s=0; s < 2; s++) {
+			PathFind pathfinder;
+			pathfinder.setGrid(maze.getGrid());
+			pathfinder.setStrategy(strategies[s]);
+			pathfinder.setLoc(Maze::tCoord(0, 0, 0));
+
+			double start = BenchMaze::now();
+			PathFind::tRoute route = pathfinder.findRoute(Maze::tCoord(dim.width-1, dim.height-1, dim.depth-1));
+			double searched = BenchMaze::now();
+
+			printf("%-14s %-6d %-8s %10.2f %10ld %12ld %10d\n", dim.String().c_str(), halls[h], names[s],
+				(searched - start) * 1000, pathfinder.getExpandedCount(), pathfinder.getScannedCount(),
+				(int)route.size());
+		}
+	}
+	printf("\n");
+}
+
+/**
+ * Measures building the cluster graph of a large randomly walled maze
+ * once, then compares routes between random cells found through it with
+ * breadth first search.
+ */
+void benchHierarchical() {
+	Maze::tDimension dims[] = { Maze::tDimension(64, 64, 64), Maze::tDimension(128, 128, 128) };
+	int numQueries = 20;
+
+	printf("== hierarchical: cluster graph of 16^3 clusters over a maze with 20%% random walls\n");
+	printf("%-14s %10s %10s %10s %12s %12s %12s %10s\n", "maze", "build ms", "portals", "edges",
+		"hpa query ms", "bfs query ms", "hpa expanded", "length");
+	for (int d=0; d < 2; d++) {
+		Maze* pMaze = BenchMaze::createRandomMaze(dims[d], 20, 42);
+		Maze::tGrid* pGrid = pMaze->getGrid();
+
+		double start = BenchMaze::now();
+		ClusterGraph graph(pGrid);
+		graph.build();
+		double built = BenchMaze::now();
+
+		PathFind hierarchical;
+		hierarchical.setGrid(pGrid);
+		hierarchical.setClusterGraph(&graph);
+		hierarchical.setStrategy(PathFind::SEARCH_HIERARCHICAL);
+		PathFind bfs;
+		bfs.setGrid(pGrid);
+
+		// Route between random open cells, timing each search separately
+		unsigned int rnd = 11;
+		double hpaTime = 0;
+		double bfsTime = 0;
+		long expanded = 0;
+		long hpaLength = 0;
+		long bfsLength = 0;
+		int found = 0;
+		for (int q=0; q < numQueries; q++) {
+			Maze::tCoord ends[2];
+			for (int e=0; e < 2; e++) {
+				do {
+					rnd = rnd * 1103515245 + 12345;
+					int x = (rnd >> 8) % dims[d].width;
+					rnd = rnd * 1103515245 + 12345;
+					int y = (rnd >> 8) % dims[d].height;
+					rnd = rnd * 1103515245 + 12345;
+					ends[e] = Maze::tCoord(x, y, (rnd >> 8) % dims[d].depth);
+				} while (pMaze->getState(ends[e]) != Maze::CELL_EMPTY);
+			}
+
+			hierarchical.setLoc(ends[0]);
+			double queryStart = BenchMaze::now();
+			PathFind::tRoute route = hierarchical.findRoute(ends[1]);
+			double queried = BenchMaze::now();
+			bfs.setLoc(ends[0]);
+			PathFind::tRoute bfsRoute = bfs.findRoute(ends[1]);
+			double bfsQueried = BenchMaze::now();
+
+			if (route.empty() || bfsRoute.empty()) { continue; }
+			hpaTime += queried - queryStart;
+			bfsTime += bfsQueried - queried;
+			expanded += hierarchical.getExpandedCount();
+			hpaLength += route.size();
+			bfsLength += bfsRoute.size();
+			found++;
+		}
+
+		if (found > 0) {
+			printf("%-14s %10.1f %10ld %10ld %12.3f %12.3f %12ld %9.1f%%\n", dims[d].String().c_str(), (built - start) * 1000,
+				graph.getNumPortals(), graph.getNumEdges(), hpaTime * 1000 / found, bfsTime * 1000 / found,
+				expanded / found, 100.0 * hpaLength / bfsLength);
+		}
+		delete pMaze;
+	}
+	printf("\n");
+}
+
+/**
+ * Compares setting up the routes of many bots to one exit with a search
+ * per bot, and with one distance field shared by all of the bots.
+ */
+void benchDistanceField() {
+	Maze::tDimension dim = Maze::tDimension(128, 128, 128);
+	int numBots[] = { 10, 100, 300 };
+	Maze* pMaze = BenchMaze::createRandomMaze(dim, 20, 42);
+	Maze::tGrid* pGrid = pMaze->getGrid();
+	Maze::tCoord exit = Maze::tCoord(dim.width - 1, dim.height - 1, dim.depth - 1);
+
+	printf("== distance field: routes for many bots to one exit of a %s maze with 20%% random walls\n",
+		dim.String().c_str());
+	printf("%-6s %12s %12s %12s %10s\n", "bots", "bfs ms", "field ms", "build ms", "routed");
+	for (int n=0; n < 3; n++) {
+		// Place the bots on random open cells
+		vector<Maze::tCoord> bots;
+		unsigned int rnd = 5;
+		while ((int)bots.size() < numBots[n]) {
+			rnd = rnd * 1103515245 + 12345;
+			int x = (rnd >> 8) % dim.width;
+			rnd = rnd * 1103515245 + 12345;
+			int y = (rnd >> 8) % dim.height;
+			rnd = rnd * 1103515245 + 12345;
+			Maze::tCoord loc = Maze::tCoord(x, y, (rnd >> 8) % dim.depth);
+			if (pMaze->getState(loc) == Maze::CELL_EMPTY) { bots.push_back(loc); }
+		}
+
+		double start = BenchMaze::now();
+		PathFind pathfinder;
+		pathfinder.setGrid(pGrid);
+		int routed = 0;
+		for (size_t b=0; b < bots.size(); b++) {
+			pathfinder.setLoc(bots[b]);
+			routed += pathfinder.findRoute(exit).empty() ? 0 : 1;
+		}
+		double searched = BenchMaze::now();
+
+		DistanceField field(pGrid);
+		field.build(exit);
+		double built = BenchMaze::now();
+		pathfinder.setDistanceField(&field);
+		pathfinder.setStrategy(PathFind::SEARCH_DISTANCE_FIELD);
+		for (size_t b=0; b < bots.size(); b++) {
+			pathfinder.setLoc(bots[b]);
+			pathfinder.findRoute(exit);
+		}
+		double looked = BenchMaze::now();
+
+		printf("%-6d %12.1f %12.1f %12.1f %10d\n", numBots[n], (searched - start) * 1000, (looked - searched) * 1000,
+			(built - searched) * 1000, routed);
+	}
+	delete pMaze;
+	printf("\n");
+}
+
+/**
+ * Compares replanning from scratch with breadth first search against
+ * repairing the incremental search, while a bot walks to the exit and
+ * every few steps the next cell of its route is walled off.
+ */
+void benchIncremental() {
+	Maze::tDimension dims[] = { Maze::tDimension(64, 64, 64), Maze::tDimension(128, 128, 128) };
+	PathFind::eStrategy strategies[] = { PathFind::SEARCH_BFS, PathFind::SEARCH_INCREMENTAL };
+	const char* names[] = { "bfs", "incremental" };
+
+	printf("== incremental: replanning as a bot's route is walled off in mazes with 20%% random walls\n");
+	printf("%-14s %-12s %8s %8s %12s %12s %12s\n", "maze", "search", "moves", "replans", "first ms", "replan ms", "expanded");
+	for (int d=0; d < 2; d++) {
+		for (int s=0; s < 2; s++) {
+			Maze* pMaze = BenchMaze::createRandomMaze(dims[d], 20, 42);
+			Maze::tCoord loc = Maze::tCoord(0, 0, 0);
+			Maze::tCoord exit = Maze::tCoord(dims[d].width - 1, dims[d].height - 1, dims[d].depth - 1);
+			pMaze->updateCell(loc, Maze::CELL_EMPTY);
+			pMaze->updateCell(exit, Maze::CELL_EMPTY);
+
+			PathFind pathfinder;
+			pathfinder.setGrid(pMaze->getGrid());
+			pathfinder.setStrategy(strategies[s]);
+			pathfinder.setLoc(loc);
+
+			double start = BenchMaze::now();
+			PathFind::tRoute route = pathfinder.findRoute(exit);
+			double first = BenchMaze::now() - start;
+
+			int moves = 0;
+			int replans = 0;
+			long expanded = 0;
+			double replanTime = 0;
+			while (!route.empty() && moves < 10000) {
+				if (moves % 4 == 3 && route.top() != exit) {
+					pMaze->updateCell(route.top(), Maze::CELL_SOLID);
+
+					start = BenchMaze::now();
+					route = pathfinder.findRoute(exit);
+					replanTime += BenchMaze::now() - start;
+					expanded += pathfinder.getExpandedCount();
+					replans++;
+					if (route.empty()) { break; }
+				}
+
+				loc = route.top();
+				route.pop();
+				pathfinder.setLoc(loc);
+				moves++;
+			}
+
+			printf("%-14s %-12s %8d %8d %12.2f %12.3f %12ld\n", dims[d].String().c_str(), names[s], moves, replans,
+				first * 1000, replans > 0 ? replanTime * 1000 / replans : 0, replans > 0 ? expanded / replans : 0);
+			delete pMaze;
+		}
+	}
+	printf("\n");
+}
+
+/**
+ * Compares rejecting bots that can't reach the exit by searching against
+ * checking the maze's connected areas first. A wall splits the maze in
+ * two, so about half of the bots are on the far side from the exit.
+ */
+void benchReachability() {
+	Maze::tDimension dim = Maze::tDimension(128, 128, 128);
+	int numBots[] = { 10, 100, 1000 };
+	Maze* pMaze = BenchMaze::createRandomMaze(dim, 20, 42);
+	Maze::tGrid* pGrid = pMaze->getGrid();
+	for (int y=0; y < dim.height; y++) {
+		for (int z=0; z < dim.depth; z++) {
+			pMaze->updateCell(Maze::tCoord(dim.width / 2, y, z), Maze::CELL_SOLID);
+		}
+	}
+	Maze::tCoord exit = Maze::tCoord(dim.width - 1, dim.height - 1, dim.depth - 1);
+	pMaze->updateCell(exit, Maze::CELL_EMPTY);
+
+	printf("== reachability: rejecting bots walled off from the exit of a %s maze with 20%% random walls\n",
+		dim.String().c_str());
+	printf("%-6s %12s %12s %12s %10s\n", "bots", "search ms", "areas ms", "label ms", "escapable");
+	for (int n=0; n < 3; n++) {
+		// Place the bots on random open cells
+		vector<Maze::tCoord> bots;
+		unsigned int rnd = 9;
+		while ((int)bots.size() < numBots[n]) {
+			rnd = rnd * 1103515245 + 12345;
+			int x = (rnd >> 8) % dim.width;
+			rnd = rnd * 1103515245 + 12345;
+			int y = (rnd >> 8) % dim.height;
+			rnd = rnd * 1103515245 + 12345;
+			Maze::tCoord loc = Maze::tCoord(x, y, (rnd >> 8) % dim.depth);
+			if (pMaze->getState(loc) == Maze::CELL_EMPTY) { bots.push_back(loc); }
+		}
+
+		// Only the bots that can't escape are searched for, the routes of
+		// the others cost the same either way.
+		double start = BenchMaze::now();
+		PathFind pathfinder;
+		pathfinder.setGrid(pGrid);
+		int escapable = 0;
+		for (size_t b=0; b < bots.size() && numBots[n] <= 100; b++) {
+			if (bots[b].x >= dim.width / 2) { continue; }
+			pathfinder.setLoc(bots[b]);
+			pathfinder.findRoute(exit);
+		}
+		double searched = BenchMaze::now();
+
+		// Walling off a cell makes the maze label its areas again
+		pMaze->updateCell(Maze::tCoord(0, 0, 0), Maze::CELL_EMPTY);
+		pMaze->updateCell(Maze::tCoord(0, 0, 0), Maze::CELL_SOLID);
+		pMaze->isReachable(exit, exit);
+		double labeled = BenchMaze::now();
+		for (size_t b=0; b < bots.size(); b++) {
+			escapable += pMaze->isReachable(bots[b], exit) ? 1 : 0;
+		}
+		double checked = BenchMaze::now();
+
+		if (numBots[n] <= 100) {
+			printf("%-6d %12.1f %12.3f %12.1f %10d\n", numBots[n], (searched - start) * 1000,
+				(checked - labeled) * 1000, (labeled - searched) * 1000, escapable);
+		} else {
+			printf("%-6d %12s %12.3f %12.1f %10d\n", numBots[n], "-", (checked - labeled) * 1000,
+				(labeled - searched) * 1000, escapable);
+		}
+	}
+	delete pMaze;
+	printf("\n");
+}
+
+/**
+ * Compares the serial breadth first search with the parallel search on
+ * 1, 2, 4, 8, and 16 threads, routing corner to corner across open and
+ * randomly walled mazes. The second search of each is timed, so the
+ * parallel search's snapshot of the solid cells is already taken.
+ */
+void benchParallel() {
+	int threads[] = { 1, 2, 4, 8, 16 };
+	const char* mazeNames[] = { "open", "walls" };
+	Maze::tDimension dim = Maze::tDimension(256, 256, 256);
+	Maze* mazes[] = {
+		new Maze(dim),
+		BenchMaze::createRandomMaze(dim, 20, 42)
+	};
+	Maze::tCoord from = Maze::tCoord(0, 0, 0);
+	Maze::tCoord dest = Maze::tCoord(dim.width - 1, dim.height - 1, dim.depth - 1);
+
+	printf("== parallel: corner to corner route across a %s maze\n", dim.String().c_str());
+	printf("%-8s %-8s %10s %10s %10s %10s\n", "maze", "threads", "search ms", "bottom up", "expanded", "route");
+	for (int m=0; m < 2; m++) {
+		PathFind pathfinder;
+		pathfinder.setGrid(mazes[m]->getGrid());
+		pathfinder.setLoc(from);
+		pathfinder.findRoute(dest);
+
+		double start = BenchMaze::now();
+		PathFind::tRoute route = pathfinder.findRoute(dest);
+		double searched = BenchMaze::now();
+		printf("%-8s %-8s %10.1f %10s %10ld %10d\n", mazeNames[m], "serial", (searched - start) * 1000, "-",
+			pathfinder.getExpandedCount(), (int)route.size());
+
+		for (int t=0; t < 5; t++) {
+			ParallelBfs parallel(mazes[m]->getGrid(), threads[t]);
+			parallel.findRoute(from, dest);
+
+			start = BenchMaze::now();
+			ParallelBfs::tRoute route = parallel.findRoute(from, dest);
+			searched = BenchMaze::now();
+			printf("%-8s %-8d %10.1f %10d %10ld %10d\n", mazeNames[m], threads[t], (searched - start) * 1000,
+				parallel.getBottomUpLevels(), parallel.getExpandedCount(), (int)route.size());
+		}
+		delete mazes[m];
+	}
+	printf("\n");
+}
+
+/**
+ * Compares the scalar breadth first flood with the packed word at a time
+ * flood, counting the reachable cells and building distances from the
+ * origin of open, randomly walled, and tunnel mazes.
+ */
+void benchWaveFront() {
+	const char* mazeNames[] = { "open", "walls", "tunnels" };
+	Maze* mazes[] = {
+		new Maze(Maze::tDimension(128, 128, 128)),
+		BenchMaze::createRandomMaze(Maze::tDimension(128, 128, 128), 20, 42),
+		BenchMaze::createTunnelMaze(Maze::tDimension(256, 64, 256), 400, 7)
+	};
+	Maze::tCoord from = Maze::tCoord(0, 0, 0);
+
+	printf("== wavefront: flood and distances from the origin, scalar vs packed words\n");
+	printf("%-8s %-14s %10s %10s %10s %10s %10s %10s\n", "maze", "size", "flood ms", "wave ms",
+		"field ms", "wdist ms", "cells", "levels");
+	for (int m=0; m < 3; m++) {
+		Maze::tGrid* pGrid = mazes[m]->getGrid();
+		WaveFront wave(pGrid);
+		wave.flood(from);
+
+		double start = BenchMaze::now();
+		long reached = BenchMaze::floodCount(pGrid, from);
+		double flooded = BenchMaze::now();
+		long waveReached = wave.flood(from);
+		double waved = BenchMaze::now();
+
+		DistanceField field(pGrid);
+		field.build(from);
+		double built = BenchMaze::now();
+		vector<int> dist;
+		wave.distances(from, dist);
+		double measured = BenchMaze::now();
+
+		if (waveReached != reached) {
+			printf("%-8s flooded %ld cells, expected %ld\n", mazeNames[m], waveReached, reached);
+		}
+		printf("%-8s %-14s %10.1f %10.1f %10.1f %10.1f %10ld %10d\n", mazeNames[m], pGrid->dim.String().c_str(),
+			(flooded - start) * 1000, (waved - flooded) * 1000, (built - waved) * 1000, (measured - built) * 1000,
+			reached, wave.getLevels());
+		delete mazes[m];
+	}
+	printf("\n");
+}
+
+/**
+ * Compares routing bots to the nearest of many exits by searching for
+ * every exit, by one search per bot that stops at the first exit reached,
+ * and by one distance field built out from all of the exits.
+ */
+void benchExits() {
+	Maze::tDimension dim = Maze::tDimension(128, 128, 128);
+	int numExits = 32;
+	int numBots = 50;
+	Maze* pMaze = BenchMaze::createRandomMaze(dim, 20, 42);
+
+	// Exits and bots on random open cells
+	Maze::tCoords exits, bots;
+	unsigned int rnd = 5;
+	while ((int)(exits.size() + bots.size()) < numExits + numBots) {
+		rnd = rnd * 1103515245 + 12345;
+		int x = (rnd >> 8) % dim.width;
+		rnd = rnd * 1103515245 + 12345;
+		int y = (rnd >> 8) % dim.height;
+		rnd = rnd * 1103515245 + 12345;
+		Maze::tCoord loc = Maze::tCoord(x, y, (rnd >> 8) % dim.depth);
+		if (pMaze->getState(loc) != Maze::CELL_EMPTY) { continue; }
+		if ((int)exits.size() < numExits) { exits.push_back(loc); } else { bots.push_back(loc); }
+	}
+
+	printf("== exits: routing %d bots to the nearest of %d exits in a %s maze with 20%% random walls\n",
+		numBots, numExits, dim.String().c_str());
+	printf("%-10s %10s %12s\n", "search", "total ms", "route steps");
+
+	PathFind pathfinder;
+	pathfinder.setGrid(pMaze->getGrid());
+	double start = BenchMaze::now();
+	long steps = 0;
+	for (size_t b=0; b < bots.size(); b++) {
+		pathfinder.setLoc(bots[b]);
+		long shortest = -1;
+		for (size_t e=0; e < exits.size(); e++) {
+			long len = pathfinder.findRoute(exits[e]).size();
+			if (len > 0 && (shortest < 0 || len < shortest)) { shortest = len; }
+		}
+		steps += shortest;
+	}
+	double perExit = BenchMaze::now();
+	printf("%-10s %10.1f %12ld\n", "per exit", (perExit - start) * 1000, steps);
+
+	steps = 0;
+	for (size_t b=0; b < bots.size(); b++) {
+		Maze::tCoord dest;
+		pathfinder.setLoc(bots[b]);
+		steps += pathfinder.findNearestRoute(exits, dest).size();
+	}
+	double nearest = BenchMaze::now();
+	printf("%-10s %10.1f %12ld\n", "nearest", (nearest - perExit) * 1000, steps);
+
+	DistanceField field(pMaze->getGrid());
+	field.build(exits);
+	pathfinder.setStrategy(PathFind::SEARCH_DISTANCE_FIELD);
+	pathfinder.setDistanceField(&field);
+	steps = 0;
+	for (size_t b=0; b < bots.size(); b++) {
+		Maze::tCoord dest;
+		pathfinder.setLoc(bots[b]);
+		steps += pathfinder.findNearestRoute(exits, dest).size();
+	}
+	double fielded = BenchMaze::now();
+	printf("%-10s %10.1f %12ld\n", "field", (fielded - nearest) * 1000, steps);
+
+	delete pMaze;
+	printf("\n");
+}
+
+/**
+ * Compares replaying the same bots through a maze several times with and
+ * without a route cache. Every replay asks for the same routes, so only
+ * the first needs to search.
+ */
+void benchRouteCache() {
+	Maze::tDimension dim = Maze::tDimension(128, 128, 128);
+	int numBots = 50;
+	int numReplays = 5;
+	Maze* pMaze = BenchMaze::createRandomMaze(dim, 20, 42);
+	Maze::tCoord exit = Maze::tCoord(dim.width - 1, dim.height - 1, dim.depth - 1);
+
+	Maze::tCoords bots;
+	unsigned int rnd = 3;
+	while ((int)bots.size() < numBots) {
+		rnd = rnd * 1103515245 + 12345;
+		int x = (rnd >> 8) % dim.width;
+		rnd = rnd * 1103515245 + 12345;
+		int y = (rnd >> 8) % dim.height;
+		rnd = rnd * 1103515245 + 12345;
+		Maze::tCoord loc = Maze::tCoord(x, y, (rnd >> 8) % dim.depth);
+		if (pMaze->getState(loc) == Maze::CELL_EMPTY) { bots.push_back(loc); }
+	}
+
+	printf("== routecache: %d replays of %d bots routing to the exit of a %s maze with 20%% random walls\n",
+		numReplays, numBots, dim.String().c_str());
+	printf("%-8s %10s %10s %10s\n", "cache", "total ms", "hits", "misses");
+	for (int c=0; c < 2; c++) {
+		RouteCache cache(pMaze->getGrid());
+		PathFind pathfinder;
+		pathfinder.setGrid(pMaze->getGrid());
+		pathfinder.setRouteCache(c == 0 ? NULL : &cache);
+
+		double start = BenchMaze::now();
+		for (int r=0; r < numReplays; r++) {
+			for (size_t b=0; b < bots.size(); b++) {
+				pathfinder.setLoc(bots[b]);
+				pathfinder.findRoute(exit);
+			}
+		}
+		double replayed = BenchMaze::now();
+
+		printf("%-8s %10.1f %10ld %10ld\n", c == 0 ? "none" : "lru", (replayed - start) * 1000,
+			cache.getHits(), cache.getMisses());
+	}
+	delete pMaze;
+	printf("\n");
+}
+
+/**
+ * Compares the memory and walk time of routes kept as a stack of cells
+ * with routes packed three bits per step.
+ */
+void benchPackedRoute() {
+	Maze::tDimension dim = Maze::tDimension(128, 128, 128);
+	int numWalks = 1000;
+	Maze* pMaze = BenchMaze::createRandomMaze(dim, 20, 42);
+	Maze::tCoord from = Maze::tCoord(0, 0, 0);
+	Maze::tCoord exit = Maze::tCoord(dim.width - 1, dim.height - 1, dim.depth - 1);
+
+	PathFind pathfinder;
+	pathfinder.setGrid(pMaze->getGrid());
+	pathfinder.setLoc(from);
+	PathFind::tRoute found = pathfinder.findRoute(exit);
+
+	printf("== packedroute: %d walks of a %d step route across a %s maze with 20%% random walls\n",
+		numWalks, (int)found.size(), dim.String().c_str());
+	printf("%-8s %10s %10s\n", "route", "bytes", "walk ms");
+
+	long checksum = 0;
+	double start = BenchMaze::now();
+	for (int w=0; w < numWalks; w++) {
+		PathFind::tRoute route = found;
+		while (!route.empty()) {
+			checksum += route.top().x;
+			route.pop();
+		}
+	}
+	double walked = BenchMaze::now();
+	printf("%-8s %10d %10.1f\n", "stack", (int)(found.size() * sizeof(Maze::tCoord)), (walked - start) * 1000);
+
+	PackedRoute packed(from, found);
+	start = BenchMaze::now();
+	for (int w=0; w < numWalks; w++) {
+		PackedRoute route = packed;
+		while (!route.done()) {
+			route.advance();
+			checksum += route.getLoc().x;
+		}
+	}
+	walked = BenchMaze::now();
+	printf("%-8s %10d %10.1f\n", "packed", (int)packed.bytes(), (walked - start) * 1000);
+
+	delete pMaze;
+	printf("(checksum %ld)\n\n", checksum);
+}
+
+/**
+ * Compares breadth first searches before and after filling the dead ends
+ * of a labyrinth, a tunnel maze, and a maze of random walls.
+ */
+void benchDeadEnds() {
+	const char* names[] = { "labyrinth", "tunnels", "random" };
+	Maze::tDimension dims[] = { Maze::tDimension(127, 31, 127), Maze::tDimension(256, 64, 256),
+		Maze::tDimension(128, 128, 128) };
+	int numExits = 2;
+
+	printf("== deadends: breadth first routes from the origin to %d exits\n", numExits);
+	printf("%-10s %-14s %10s %10s %10s %12s %10s\n", "maze", "size", "open", "filled", "fill ms", "expanded", "route ms");
+	for (int m=0; m < 3; m++) {
+		Maze* pMaze = NULL;
+		if (m == 0) { pMaze = BenchMaze::createLabyrinth(dims[m], 42); }
+		else if (m == 1) { pMaze = BenchMaze::createTunnelMaze(dims[m], 400, 7); }
+		else { pMaze = BenchMaze::createRandomMaze(dims[m], 30, 42); }
+		Maze::tCoord from = Maze::tCoord(0, 0, 0);
+		pMaze->occupy(from);
+
+		long open = 0;
+		Maze::tDimension dim = dims[m];
+		for (int x=0; x < dim.width; x++) {
+			for (int y=0; y < dim.height; y++) {
+				for (int z=0; z < dim.depth; z++) {
+					if (pMaze->getState(Maze::tCoord(x, y, z)) != Maze::CELL_SOLID) { open++; }
+				}
+			}
+		}
+
+		// Exits on random cells reachable from the origin
+		Maze::tCoords exits;
+		unsigned int rnd = 5;
+		while ((int)exits.size() < numExits) {
+			rnd = rnd * 1103515245 + 12345;
+			int x = (rnd >> 8) % dim.width;
+			rnd = rnd * 1103515245 + 12345;
+			int y = (rnd >> 8) % dim.height;
+			rnd = rnd * 1103515245 + 12345;
+			Maze::tCoord loc = Maze::tCoord(x, y, (rnd >> 8) % dim.depth);
+			if (pMaze->getState(loc) == Maze::CELL_EMPTY && pMaze->isReachable(from, loc)) {
+				pMaze->updateCell(loc, Maze::CELL_EXIT);
+				exits.push_back(loc);
+			}
+		}
+
+		PathFind pathfinder;
+		pathfinder.setGrid(pMaze->getGrid());
+		pathfinder.setLoc(from);
+		pathfinder.findRoute(exits[0]);
+		for (int fill=0; fill < 2; fill++) {
+			double start = BenchMaze::now();
+			long filled = fill ? pMaze->fillDeadEnds() : 0;
+			double filledAt = BenchMaze::now();
+
+			long expanded = 0;
+			for (size_t e=0; e < exits.size(); e++) {
+				pathfinder.findRoute(exits[e]);
+				expanded += pathfinder.getExpandedCount();
+			}
+			double routed = BenchMaze::now();
+
+			printf("%-10s %-14s %10ld %10ld %10.1f %12ld %10.1f\n", names[m], dim.String().c_str(), open, filled,
+				(filledAt - start) * 1000, expanded, (routed - filledAt) * 1000);
+		}
+		delete pMaze;
+	}
+	printf("\n");
+}
+
+/**
+ * Compares routes found by searching the cells of a labyrinth and a
+ * tunnel maze with routes found over their contracted junction graphs.
+ */
+void benchJunction() {
+	const char* names[] = { "labyrinth", "tunnels" };
+	Maze::tDimension dims[] = { Maze::tDimension(127, 31, 127), Maze::tDimension(256, 64, 256) };
+	PathFind::eStrategy strategies[] = { PathFind::SEARCH_BFS, PathFind::SEARCH_ASTAR, PathFind::SEARCH_JUNCTION };
+	const char* strategyNames[] = { "bfs", "astar", "junction" };
+	int numRoutes = 50;
+
+	printf("== junction: %d routes between random open cells\n", numRoutes);
+	printf("%-10s %-14s %-9s %10s %10s %10s %12s %10s\n", "maze", "size", "search", "nodes", "edges", "build ms",
+		"expanded", "route ms");
+	for (int m=0; m < 2; m++) {
+		Maze* pMaze = (m == 0) ? BenchMaze::createLabyrinth(dims[m], 42) :
+			BenchMaze::createTunnelMaze(dims[m], 400, 7);
+		Maze::tDimension dim = dims[m];
+
+		// Pairs of open cells in the same connected area
+		Maze::tCoords ends;
+		unsigned int rnd = 9;
+		while ((int)ends.size() < numRoutes * 2) {
+			rnd = rnd * 1103515245 + 12345;
+			int x = (rnd >> 8) % dim.width;
+			rnd = rnd * 1103515245 + 12345;
+			int y = (rnd >> 8) % dim.height;
+			rnd = rnd * 1103515245 + 12345;
+			Maze::tCoord loc = Maze::tCoord(x, y, (rnd >> 8) % dim.depth);
+			if (pMaze->isReachable(Maze::tCoord(0, 0, 0), loc)) { ends.push_back(loc); }
+		}
+
+		double start = BenchMaze::now();
+		JunctionGraph graph(pMaze->getGrid());
+		graph.build();
+		double built = BenchMaze::now();
+
+		for (int s=0; s < 3; s++) {
+			PathFind pathfinder;
+			pathfinder.setGrid(pMaze->getGrid());
+			pathfinder.setStrategy(strategies[s]);
+			pathfinder.setJunctionGraph(&graph);
+
+			long expanded = 0;
+			long steps = 0;
+			double routeStart = BenchMaze::now();
+			for (int r=0; r < numRoutes; r++) {
+				pathfinder.setLoc(ends[r * 2]);
+				steps += pathfinder.findRoute(ends[r * 2 + 1]).size();
+				expanded += pathfinder.getExpandedCount();
+			}
+			double routed = BenchMaze::now();
+
+			bool junction = strategies[s] == PathFind::SEARCH_JUNCTION;
+			printf("%-10s %-14s %-9s %10ld %10ld %10.1f %12ld %10.1f  (%ld steps)\n", names[m], dim.String().c_str(),
+				strategyNames[s], junction ? graph.getNumNodes() : 0, junction ? graph.getNumEdges() : 0,
+				junction ? (built - start) * 1000 : 0.0, expanded, (routed - routeStart) * 1000, steps);
+		}
+		delete pMaze;
+	}
+	printf("\n");
+}
+
+/**
+ * Soaks the tree search with a million routes between random open cells
+ * of a small labyrinth, reporting the throughput and the growth of the
+ * process's resident memory as the routes are found. The tree holds every
+ * route without a loop, so the labyrinth keeps it to one node per cell.
+ */
+void benchTreeArena() {
+	Maze::tDimension dim = Maze::tDimension(15, 3, 15);
+	long numQueries = 1000000;
+	long reportEvery = numQueries / 4;
+
+	Maze* pMaze = BenchMaze::createLabyrinth(dim, 42);
+	Maze::tCoords ends;
+	unsigned int rnd = 5;
+	while (ends.size() < 512) {
+		rnd = rnd * 1103515245 + 12345;
+		int x = (rnd >> 8) % dim.width;
+		rnd = rnd * 1103515245 + 12345;
+		int y = (rnd >> 8) % dim.height;
+		rnd = rnd * 1103515245 + 12345;
+		Maze::tCoord loc = Maze::tCoord(x, y, (rnd >> 8) % dim.depth);
+		if (pMaze->isReachable(Maze::tCoord(0, 0, 0), loc)) { ends.push_back(loc); }
+	}
+
+	PathFind pathfinder;
+	pathfinder.setGrid(pMaze->getGrid());
+	pathfinder.setStrategy(PathFind::SEARCH_TREE);
+
+	printf("== treearena: %ld tree searches between random open cells of a %s maze\n", numQueries,
+		dim.String().c_str());
+	printf("%10s %12s %12s %12s\n", "queries", "queries/s", "rss KB", "rss grown KB");
+	long startRss = BenchMaze::residentBytes();
+	long steps = 0;
+	double start = BenchMaze::now();
+	double last = start;
+	for (long q=0; q < numQueries; q++) {
+		// Drop the kept tree so every query builds its own
+		pathfinder.clearRoutes();
+		pathfinder.setLoc(ends[(q * 2) % ends.size()]);
+		steps += pathfinder.findRoute(ends[(q * 2 + 1) % ends.size()]).size();
+
+		if ((q + 1) % reportEvery == 0) {
+			double now = BenchMaze::now();
+			long rss = BenchMaze::residentBytes();
+			printf("%10ld %12.0f %12ld %12ld\n", q + 1, reportEvery / (now - last), rss / 1024,
+				(rss - startRss) / 1024);
+			last = now;
+		}
+	}
+	printf("total %.1f s, %ld steps\n", BenchMaze::now() - start, steps);
+	delete pMaze;
+	printf("\n");
+}
+
+/**
+ * Times the tree search across labyrinths of growing size. A labyrinth has
+ * a single route between any two cells, so the routes, and the branches
+ * of the tree, wind back and forth across the whole maze.
+ */
+void benchTreeDepth() {
+	Maze::tDimension dims[] = { Maze::tDimension(31, 3, 31), Maze::tDimension(63, 3, 63),
+		Maze::tDimension(127, 3, 127), Maze::tDimension(255, 1, 255) };
+	int numRuns = 5;
+
+	printf("== treedepth: tree search between opposite corners of a labyrinth, best of %d\n", numRuns);
+	printf("%-14s %10s %10s %10s\n", "size", "steps", "expanded", "route ms");
+	for (int d=0; d < 4; d++) {
+		Maze::tDimension dim = dims[d];
+		Maze* pMaze = BenchMaze::createLabyrinth(dim, 42);
+
+		PathFind pathfinder;
+		pathfinder.setGrid(pMaze->getGrid());
+		pathfinder.setStrategy(PathFind::SEARCH_TREE);
+		pathfinder.setLoc(Maze::tCoord(0, 0, 0));
+		Maze::tCoord dest = Maze::tCoord(dim.width - 1, dim.height - 1, dim.depth - 1);
+
+		double best = 0;
+		long steps = 0;
+		for (int r=0; r < numRuns; r++) {
+			// Drop the kept tree so every run searches from scratch
+			pathfinder.clearRoutes();
+			double start = BenchMaze::now();
+			steps = pathfinder.findRoute(dest).size();
+			double routed = BenchMaze::now();
+			if (r == 0 || routed - start < best) { best = routed - start; }
+		}
+
+		printf("%-14s %10ld %10ld %10.2f\n", dim.String().c_str(), steps, pathfinder.getExpandedCount(), best * 1000);
+		delete pMaze;
+	}
+	printf("\n");
+}
+
+/**
+ * Compares looking up the nodes of cells in the tree search's tree through
+ * its index with searching the tree breadth first for them.
+ */
+void benchTreeNode() {
+	Maze::tDimension dims[] = { Maze::tDimension(63, 3, 63), Maze::tDimension(127, 3, 127) };
+	int numLookups = 200;
+
+	printf("== treenode: %d lookups of random cells in the tree of a labyrinth\n", numLookups);
+	printf("%-14s %10s %-8s %12s %10s\n", "size", "nodes", "lookup", "found", "ms");
+	for (int d=0; d < 2; d++) {
+		Maze::tDimension dim = dims[d];
+		Maze* pMaze = BenchMaze::createLabyrinth(dim, 42);
+
+		PathFind pathfinder;
+		pathfinder.setGrid(pMaze->getGrid());
+		pathfinder.setStrategy(PathFind::SEARCH_TREE);
+		pathfinder.setLoc(Maze::tCoord(0, 0, 0));
+		pathfinder.findRoute(Maze::tCoord(dim.width - 1, dim.height - 1, dim.depth - 1));
+		PathTree* pTree = pathfinder.getTree();
+		PathTreeIndex* pIndex = pTree->getIndex();
+		long numNodes = pIndex->size();
+
+		Maze::tCoords cells;
+		unsigned int rnd = 3;
+		while ((int)cells.size() < numLookups) {
+			rnd = rnd * 1103515245 + 12345;
+			int x = (rnd >> 8) % dim.width;
+			rnd = rnd * 1103515245 + 12345;
+			int y = (rnd >> 8) % dim.height;
+			rnd = rnd * 1103515245 + 12345;
+			Maze::tCoord loc = Maze::tCoord(x, y, (rnd >> 8) % dim.depth);
+			if (pMaze->getState(loc) != Maze::CELL_SOLID) { cells.push_back(loc); }
+		}
+
+		// The same tree without its index is searched instead
+		for (int indexed=1; indexed >= 0; indexed--) {
+			if (!indexed) { pTree->setIndex(NULL); }
+			long found = 0;
+			double start = BenchMaze::now();
+			for (int l=0; l < numLookups; l++) {
+				if (pTree->getNode(cells[l]) != NULL) { found++; }
+			}
+			double looked = BenchMaze::now();
+			printf("%-14s %10ld %-8s %12ld %10.3f\n", dim.String().c_str(), numNodes, indexed ? "index" : "search",
+				found, (looked - start) * 1000);
+		}
+		delete pMaze;
+	}
+	printf("\n");
+}
+
+/**
+ * Replans the route of an entity after every step it takes along it, with
+ * the tree search re-rooting its tree, and searching again from scratch.
+ * Runs on the test config mazes as they are and tiled, and on a large
+ * labyrinth and random maze.
+ */
+void benchTreeReplan() {
+	const char* configs[] = { "test/configs/input00", "test/configs/input01" };
+	const char* names[] = { "input00", "input01", "input00 x8", "input01 x8", "labyrinth", "random" };
+
+	printf("== treereplan: tree search replanning after every step along the route\n");
+	printf("%-12s %-14s %8s %-8s %12s %12s\n", "maze", "size", "steps", "replan", "expanded", "us/step");
+	for (int m=0; m < 6; m++) {
+		Maze* pMaze = NULL;
+		Maze::tCoord from, dest;
+		if (m < 4) {
+			EnvConfig cfg;
+			char fileName[100] = {0x00};
+			strncpy(fileName, configs[m % 2], sizeof(fileName) - 1);
+			if (!cfg.parseEnv(fileName)) {
+				printf("Failed to load %s\n", configs[m % 2]);
+				continue;
+			}
+			int tiles = (m < 2) ? 1 : 8;
+			pMaze = BenchMaze::createTiledMaze(cfg, tiles);
+			from = BenchMaze::tiledCoord(cfg.getDim(), Maze::tCoord(0, 0, 0), cfg.getBotCoords().begin()->second);
+			dest = BenchMaze::tiledCoord(cfg.getDim(), Maze::tCoord(tiles - 1, tiles - 1, tiles - 1), cfg.getExitCoord());
+		} else if (m == 4) {
+			pMaze = BenchMaze::createLabyrinth(Maze::tDimension(127, 3, 127), 42);
+			dest = Maze::tCoord(126, 2, 126);
+		} else {
+			pMaze = BenchMaze::createRandomMaze(Maze::tDimension(64, 64, 64), 20, 42);
+			dest = Maze::tCoord(63, 63, 63);
+		}
+
+		for (int reuse=1; reuse >= 0; reuse--) {
+			PathFind pathfinder;
+			pathfinder.setGrid(pMaze->getGrid());
+			pathfinder.setStrategy(PathFind::SEARCH_TREE);
+			pathfinder.setLoc(from);
+			PathFind::tRoute route = pathfinder.findRoute(dest);
+			long steps = route.size();
+
+			// Take a step, and plan the rest of the route again
+			long expanded = 0;
+			double start = BenchMaze::now();
+			while (route.size() > 1) {
+				pathfinder.setLoc(route.top());
+				if (!reuse) { pathfinder.clearRoutes(); }
+				route = pathfinder.findRoute(dest);
+				expanded += pathfinder.getExpandedCount();
+			}
+			double walked = BenchMaze::now();
+
+			printf("%-12s %-14s %8ld %-8s %12ld %12.2f\n", names[m], pMaze->getGrid()->dim.String().c_str(), steps,
+				reuse ? "reroot" : "search", expanded, steps > 1 ? (walked - start) * 1e6 / (steps - 1) : 0.0);
+		}
+		delete pMaze;
+	}
+	printf("\n");
+}
+
+/**
+ * Runs the benchmarks. If a name is provided only benchmarks whose name
+ * contains it are run.
+ */
+int main(int argc, char* argv[]) {
+	const char* filter = argc > 1 ? argv[1] : "";
+
+	struct {
+		const char* name;
+		void (*run)();
+	} benches[] = {
+		{ "layouts", &benchLayouts },
+		{ "storage", &benchStorage },
+		{ "search", &benchSearch },
+		{ "astar", &benchAStar },
+		{ "bidirectional", &benchBidirectional },
+		{ "jumppoint", &benchJumpPoint },
+		{ "hierarchical", &benchHierarchical },
+		{ "distancefield", &benchDistanceField },
+		{ "incremental", &benchIncremental },
+		{ "reachability", &benchReachability },
+		{ "parallel", &benchParallel },
+		{ "wavefront", &benchWaveFront },
+		{ "exits", &benchExits },
+		{ "routecache", &benchRouteCache },
+		{ "packedroute", &benchPackedRoute },
+		{ "deadends", &benchDeadEnds },
+		{ "junction", &benchJunction },
+		{ "treearena", &benchTreeArena },
+		{ "treedepth", &benchTreeDepth },
+		{ "treenode", &benchTreeNode },
+		{ "treereplan", &benchTreeReplan }
+	};
+	int numBenches = sizeof(benches)/sizeof(benches[0]);
+
+	for (int idx=0; idx < numBenches; idx++) {
+		if (strstr(benches[idx].name, filter) != NULL) {
+			benches[idx].run();
+		}
+	}
+
+	return EXIT_SUCCESS;
+}
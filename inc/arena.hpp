@@ -0,0 +1,133 @@
+#ifndef _ARENA_HPP_
+#define _ARENA_HPP_
+
+#include <stddef.h>
+#include <new>
+#include <vector>
+
+/**
+ * Bump allocator for memory that all goes away at the same time, such as
+ * the nodes of a search tree. Memory is handed out from large blocks by
+ * moving an offset, and is only given back by release(), which frees
+ * everything allocated at once. The blocks are kept for the allocations
+ * that follow, so once an arena has grown to its working size it stops
+ * calling malloc altogether.
+ *
+ * Destructors of objects placed in the arena are never run, so they must
+ * not own anything outside of it.
+ */
+class Arena {
+public:
+	// Size of the blocks memory is allocated from
+	static const size_t BLOCK_SIZE = 64 * 1024;
+
+	/**
+	 * Initializes the arena, no memory is allocated until it is needed
+	 */
+	Arena();
+
+	/**
+	 * Frees all blocks of the arena
+	 */
+	~Arena();
+
+	/**
+	 * Allocates memory aligned for any type, that stays valid until the
+	 * arena is released.
+	 * @param bytes - number of bytes to allocate
+	 * @returns the memory allocated
+	 */
+	void* allocate(size_t bytes);
+
+	/**
+	 * Frees everything allocated from the arena at once. The blocks are
+	 * kept to allocate from again.
+	 */
+	void release();
+
+	/**
+	 * Returns the number of bytes allocated since the arena was last released
+	 */
+	size_t getBytesUsed() { return m_used; }
+
+	/**
+	 * Returns the number of bytes of the blocks held by the arena
+	 */
+	size_t getBytesReserved() { return m_reserved; }
+
+private:
+	// Alignment of every allocation
+	static const size_t ALIGN = sizeof(long double);
+
+	std::vector<char*> m_blocks;
+	std::vector<size_t> m_blockSizes;
+	// Block being allocated from, and the offset of its free space
+	size_t m_block;
+	size_t m_offset;
+	size_t m_used;
+	size_t m_reserved;
+
+	// Arenas own their blocks, and can't be copied
+	Arena(const Arena &);
+	Arena &operator=(const Arena &);
+};
+
+/**
+ * Allocator for standard containers placed in an arena. The container's
+ * memory is freed when the arena is released, so giving memory back to
+ * the allocator does nothing. Without an arena the heap is used instead.
+ */
+template <class T>
+class ArenaAllocator {
+public:
+	typedef T value_type;
+	typedef T* pointer;
+	typedef const T* const_pointer;
+	typedef T& reference;
+	typedef const T& const_reference;
+	typedef size_t size_type;
+	typedef ptrdiff_t difference_type;
+
+	template <class U>
+	struct rebind { typedef ArenaAllocator<U> other; };
+
+	/**
+	 * Initializes the allocator
+	 * @param pArena - arena to allocate from, NULL to use the heap
+	 */
+	ArenaAllocator(Arena* pArena=NULL): m_pArena(pArena) {}
+
+	template <class U>
+	ArenaAllocator(const ArenaAllocator<U> &other): m_pArena(other.getArena()) {}
+
+	pointer allocate(size_type n, const void* =0) {
+		if (m_pArena == NULL) { return (pointer)::operator new(n * sizeof(T)); }
+		return (pointer)m_pArena->allocate(n * sizeof(T));
+	}
+
+	void deallocate(pointer p, size_type) {
+		if (m_pArena == NULL) { ::operator delete(p); }
+	}
+
+	void construct(pointer p, const T &value) { new ((void*)p) T(value); }
+	void destroy(pointer p) { p->~T(); }
+
+	pointer address(reference r) const { return &r; }
+	const_pointer address(const_reference r) const { return &r; }
+	size_type max_size() const { return (size_type)-1 / sizeof(T); }
+
+	/**
+	 * Returns the arena allocated from, NULL if it is the heap
+	 */
+	Arena* getArena() const { return m_pArena; }
+
+	template <class U>
+	bool operator==(const ArenaAllocator<U> &other) const { return m_pArena == other.getArena(); }
+	template <class U>
+	bool operator!=(const ArenaAllocator<U> &other) const { return m_pArena != other.getArena(); }
+
+private:
+	Arena* m_pArena;
+};
+
+#endif // !defined(_ARENA_HPP_)
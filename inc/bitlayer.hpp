@@ -0,0 +1,134 @@
+#ifndef _BITLAYER_HPP_
+#define _BITLAYER_HPP_
+
+#include <stdint.h>
+#include <vector>
+
+/**
+ * Packed set of bits, one per grid cell. The bits are grouped into 64 bit
+ * words so that runs of neighboring cells can be read or tested with a
+ * single word operation.
+ */
+class BitLayer {
+public:
+	// Word the bits are packed into
+	typedef uint64_t tWord;
+	// Position of a bit in the layer
+	typedef long tIndex;
+
+	// Number of bits stored in each word
+	static const int WORD_BITS = 64;
+
+	/**
+	 * Initializes the layer with the number of bits provided
+	 * @param size - number of bits in the layer
+	 * @param value - initial value of all bits
+	 */
+	BitLayer(tIndex size=0, bool value=false);
+
+	/**
+	 * Resizes the layer, all bits will be reset to the value provided
+	 * @param size - number of bits in the layer
+	 * @param value - value of all bits
+	 */
+	void reset(tIndex size, bool value=false);
+
+	/**
+	 * Sets all bits in the layer to the value provided
+	 * @param value - value of all bits
+	 */
+	void fill(bool value);
+
+	/**
+	 * Returns the value of the bit at the index
+	 * @param idx - position of the bit
+	 * @returns true if the bit is set
+	 */
+	bool test(tIndex idx) const {
+		return (m_words[idx / WORD_BITS] >> (idx % WORD_BITS)) & 1;
+	}
+
+	/**
+	 * Sets the bit at the index
+	 * @param idx - position of the bit
+	 */
+	void set(tIndex idx) { m_words[idx / WORD_BITS] |= ((tWord)1 << (idx % WORD_BITS)); }
+
+	/**
+	 * Sets the bit at the index atomically, so threads may set bits that
+	 * share a word at the same time.
+	 * @param idx - position of the bit
+	 * @returns true if the bit was already set
+	 */
+	bool testAndSet(tIndex idx) {
+		tWord mask = (tWord)1 << (idx % WORD_BITS);
+		return (__sync_fetch_and_or(&m_words[idx / WORD_BITS], mask) & mask) != 0;
+	}
+
+	/**
+	 * Clears the bit at the index
+	 * @param idx - position of the bit
+	 */
+	void clear(tIndex idx) { m_words[idx / WORD_BITS] &= ~((tWord)1 << (idx % WORD_BITS)); }
+
+	/**
+	 * Sets the bit at the index to the value provided
+	 * @param idx - position of the bit
+	 * @param value - new value of the bit
+	 */
+	void assign(tIndex idx, bool value) {
+		if (value) { set(idx); } else { clear(idx); }
+	}
+
+	/**
+	 * Returns up to 64 consecutive bits starting at the index. The first
+	 * bit will be the lowest bit of the returned word.
+	 * @param idx - position of the first bit
+	 * @param count - number of bits to read, between 1 and 64
+	 * @returns the bits read
+	 */
+	tWord bits(tIndex idx, int count) const;
+
+	/**
+	 * Returns the number of bits set in the layer
+	 * @returns number of set bits
+	 */
+	tIndex count() const;
+
+	/**
+	 * Returns the number of bits in the layer
+	 */
+	tIndex size() const { return m_size; }
+
+	/**
+	 * Returns the number of words used to store the layer
+	 */
+	tIndex numWords() const { return m_words.size(); }
+
+	/**
+	 * Returns a reference to the word at the index
+	 * @param w - index of the word
+	 */
+	tWord &word(tIndex w) { return m_words[w]; }
+
+	/**
+	 * Returns the word at the index
+	 * @param w - index of the word
+	 */
+	tWord word(tIndex w) const { return m_words[w]; }
+
+private:
+	// Number of bits in the layer
+	tIndex m_size;
+
+	// Words the bits are packed into
+	std::vector<tWord> m_words;
+
+	/**
+	 * Clears the unused bits of the last word so that word wide
+	 * operations do not see bits outside of the layer.
+	 */
+	void trimLastWord();
+};
+
+#endif // !defined(_BITLAYER_HPP_)
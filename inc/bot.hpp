@@ -3,6 +3,7 @@
 
 #include "maze.hpp"
 #include "pathfind.hpp"
+#include "packedroute.hpp"
 
 #include <vector>
 #include <string>
@@ -21,9 +22,52 @@ public:
 	 * Attempts to find a rout from the bot's current location
 	 * to the coordinate specified. Using the grid to naviage through
 	 * @param dest - Coordinate of the destination
+	 * @param strategy - search algorithm used to find the route
 	 * @returns true if a route can be found,false otherwise.
 	 */
-	bool calcRoute(Maze::tCoord dest);
+	bool calcRoute(Maze::tCoord dest, PathFind::eStrategy strategy=PathFind::SEARCH_BFS);
+
+	/**
+	 * Attempts to find a route from the bot's current location to the
+	 * nearest of the destinations. If the route is later walled off the
+	 * bot heads for whichever destination is then nearest.
+	 * @param dests - Coordinates of the destinations
+	 * @param strategy - search algorithm used to find the route
+	 * @returns true if a route can be found,false otherwise.
+	 */
+	bool calcNearestRoute(const Maze::tCoords &dests, PathFind::eStrategy strategy=PathFind::SEARCH_BFS);
+
+	/**
+	 * Returns the destination the bot is heading for
+	 */
+	Maze::tCoord getDest() { return m_destLoc; }
+
+	/**
+	 * Sets the cluster graph used when finding routes with the
+	 * hierarchical search.
+	 * @param pClusters - graph of the bot's maze, not owned
+	 */
+	void setClusterGraph(ClusterGraph* pClusters) { m_pathfinder.setClusterGraph(pClusters); }
+
+	/**
+	 * Sets the distance field used when finding routes with the
+	 * distance field search.
+	 * @param pField - field of the bot's maze, not owned
+	 */
+	void setDistanceField(DistanceField* pField) { m_pathfinder.setDistanceField(pField); }
+
+	/**
+	 * Sets the junction graph used when finding routes with the
+	 * junction search.
+	 * @param pJunctions - graph of the bot's maze, not owned
+	 */
+	void setJunctionGraph(JunctionGraph* pJunctions) { m_pathfinder.setJunctionGraph(pJunctions); }
+
+	/**
+	 * Sets the cache routes are looked up in before searching
+	 * @param pCache - cache of the bot's maze, not owned
+	 */
+	void setRouteCache(RouteCache* pCache) { m_pathfinder.setRouteCache(pCache); }
 
 	/**
 	 * Returns a string of the the bot used so far along its
@@ -32,9 +76,15 @@ public:
 	 */
 	std::string getRouteUsed();
 
+	// Rounds a bot waits for another entity to leave the next cell of its
+	// route before looking for a way around it
+	static const int MAX_BLOCKED_TURNS = 3;
+
 	/**
 	 * Moves the bot one step along the route that was calculated 
-	 * earlier with calcRoute().
+	 * earlier with calcRoute(). If the next cell has been walled off
+	 * a new route is found instead of moving. If it has been occupied
+	 * for MAX_BLOCKED_TURNS rounds, a route around it is found instead.
 	 * @returns if the bot moved.
 	 */
 	bool move();
@@ -49,6 +99,9 @@ private:
 	// Current location on the grid of this bot
 	Maze::tCoord m_curLoc;
 	Maze::tCoord m_destLoc;
+	// Destinations the bot may pick the nearest of, empty if it is
+	// heading for a single destination.
+	Maze::tCoords m_dests;
 
 	// Maze reference
 	Maze* m_pMaze;
@@ -57,11 +110,14 @@ private:
 	// two coordiantes on the grid
 	PathFind m_pathfinder;
 
-	// The route to reach the destination
-	PathFind::tRoute m_route;
+	// The route to reach the destination, 3 bits per step
+	PackedRoute m_route;
+
+	// Steps taken so far, 3 bits per step
+	PackedRoute m_routeUsed;
 
-	// list of the route used
-	std::vector<char> m_routeUsed;
+	// Rounds in a row the next cell of the route has been occupied
+	int m_blockedTurns;
 };
 
 #endif // !defined(_BOT_HPP_)
@@ -0,0 +1,190 @@
+#ifndef _CLUSTERGRAPH_HPP_
+#define _CLUSTERGRAPH_HPP_
+
+#include "maze.hpp"
+
+#include <stack>
+#include <vector>
+#include <map>
+
+/**
+ * Abstract graph of a static maze for hierarchical route finding. The
+ * grid is split into cubic clusters, and the open cells where clusters
+ * connect become portals. The distances between the portals of each
+ * cluster are found once by build(), so a route is found by searching
+ * the small portal graph and then searching only the clusters the route
+ * passes through.
+ *
+ * The routes found are close to, but not always, the shortest, since
+ * they must pass through the chosen portal of each entrance.
+ */
+class ClusterGraph {
+public:
+	// Route that should be used, same as PathFind::tRoute
+	typedef std::stack<Maze::tCoord> tRoute;
+
+	/**
+	 * Initializes the graph for the grid, build() must be called before
+	 * any route can be found.
+	 * @param pGrid - grid of the maze, must outlive the graph
+	 * @param clusterSize - number of cells along each edge of a cluster
+	 */
+	ClusterGraph(Maze::tGrid* pGrid, int clusterSize=16);
+
+	/**
+	 * Finds the portals between the clusters, and the distances between
+	 * the portals of each cluster. Must be called again if the grid's
+	 * walls change.
+	 */
+	void build();
+
+	/**
+	 * Returns if build() has been called
+	 */
+	bool isBuilt() { return m_built; }
+
+	/**
+	 * Returns if build() has been called since the grid's walls last changed
+	 */
+	bool isCurrent() { return m_built && m_version == m_pGrid->version; }
+
+	/**
+	 * Finds a route through the portal graph, and fills in the cells of
+	 * the route in each cluster it passes through.
+	 * @param from - starting point of the route
+	 * @param dest - destination of the route
+	 * @returns the route, not including the starting point. Empty if the
+	 *          destination is unreachable.
+	 */
+	tRoute findRoute(Maze::tCoord from, Maze::tCoord dest);
+
+	/**
+	 * Returns the number of clusters the grid is split into
+	 */
+	int getNumClusters() { return m_numClusters.width * m_numClusters.height * m_numClusters.depth; }
+
+	/**
+	 * Returns the number of portals found by build()
+	 */
+	long getNumPortals() { return m_portals.size(); }
+
+	/**
+	 * Returns the number of edges between portals found by build()
+	 */
+	long getNumEdges();
+
+	/**
+	 * Returns the number of portals expanded by the last findRoute()
+	 */
+	long getExpandedCount() { return m_expanded; }
+
+private:
+	// Connection from a portal to another, and the steps between them
+	struct tEdge {
+		int to;
+		int cost;
+		tEdge(int t=0, int c=0): to(t), cost(c) {}
+	};
+
+	// Open cell of a cluster next to an open cell of a neighboring cluster
+	struct tPortal {
+		Maze::tCoord loc;
+		int cluster;
+		std::vector<tEdge> edges;
+		tPortal(Maze::tCoord l=Maze::tCoord(), int c=0): loc(l), cluster(c) {}
+	};
+
+	Maze::tGrid* m_pGrid;
+	int m_clusterSize;
+	Maze::tDimension m_numClusters;
+	bool m_built;
+	// Version of the grid when last built
+	unsigned long m_version;
+
+	std::vector<tPortal> m_portals;
+	// Portals of each cluster, by cluster id
+	std::vector< std::vector<int> > m_clusterPortals;
+	// Portal at each grid index, so a cell is never made a portal twice
+	std::map<Maze::tIndex, int> m_portalAt;
+
+	// Portal search scratch space. A node's cost is only valid if its
+	// stamp matches the current search, so nothing is cleared between searches.
+	std::vector<int> m_cost;
+	std::vector<int> m_parent;
+	std::vector<unsigned int> m_stamp;
+	unsigned int m_search;
+	long m_expanded;
+
+	// Cluster search scratch space, indexed by the cell's offset in the cluster
+	std::vector<int> m_localDist;
+	std::vector<unsigned char> m_localParent;
+	std::vector<Maze::tCoord> m_localQueue;
+	std::vector<Maze::tIndex> m_localCells;
+	Maze::tCoord m_localLo;
+
+	/**
+	 * Returns the id of the cluster the coordinate is in
+	 * @param coord - coordinate in the maze
+	 * @returns cluster id
+	 */
+	int clusterOf(Maze::tCoord coord);
+
+	/**
+	 * Returns the lowest coordinate of the cluster
+	 * @param cluster - cluster id
+	 * @returns coordinate of the cluster's first cell
+	 */
+	Maze::tCoord clusterOrigin(int cluster);
+
+	/**
+	 * Returns the portal at the cell, adding one if there is none
+	 * @param loc - coordinate of the portal
+	 * @param cluster - cluster the portal belongs to
+	 * @returns portal id
+	 */
+	int addPortal(Maze::tCoord loc, int cluster);
+
+	/**
+	 * Adds a portal on each side of every entrance between the cluster and
+	 * its neighbor in the direction provided. An entrance is a connected
+	 * area of the shared face where the cells on both sides are open.
+	 * @param cluster - cluster id
+	 * @param dir - direction of the neighbor cluster, EAST, UP or SOUTH
+	 */
+	void addEntrances(int cluster, Maze::eDirection dir);
+
+	/**
+	 * Searches breadth first from the cell, without leaving its cluster.
+	 * Afterwards localDist() returns the steps to each cell in the cluster.
+	 * @param cluster - cluster id
+	 * @param from - cell in the cluster to search from
+	 * @param pTarget - if provided the search stops once this cell is reached
+	 */
+	void searchCluster(int cluster, Maze::tCoord from, Maze::tCoord* pTarget=NULL);
+
+	/**
+	 * Returns the offset of a cell within the cluster last searched
+	 * @param loc - cell in the searched cluster
+	 * @returns offset of the cell in the cluster search scratch space
+	 */
+	int localIndex(Maze::tCoord loc);
+
+	/**
+	 * Returns the steps to the cell found by the last searchCluster()
+	 * @param loc - cell in the searched cluster
+	 * @returns steps to the cell, -1 if it was not reached
+	 */
+	int localDist(Maze::tCoord loc);
+
+	/**
+	 * Adds the cells of the route within a cluster between two of its cells,
+	 * not including the first cell.
+	 * @param cluster - cluster id
+	 * @param from - first cell
+	 * @param to - last cell
+	 * @param cells - route the cells are appended to in order
+	 */
+	void refine(int cluster, Maze::tCoord from, Maze::tCoord to, std::vector<Maze::tCoord> &cells);
+};
+
+#endif // !defined(_CLUSTERGRAPH_HPP_)
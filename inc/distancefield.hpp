@@ -0,0 +1,116 @@
+#ifndef _DISTANCEFIELD_HPP_
+#define _DISTANCEFIELD_HPP_
+
+#include "maze.hpp"
+
+#include <stack>
+#include <vector>
+
+/**
+ * Steps from every cell of a grid to a single destination, found with one
+ * breadth first search out from the destination. Any number of routes to
+ * the destination can then be read off by stepping to the neighbor one
+ * step closer, without searching again.
+ *
+ * The field can also be built to several destinations at once, searching
+ * out from all of them together. Each cell's steps are then to its nearest
+ * destination, and its route leads there.
+ */
+class DistanceField {
+public:
+	// Route that should be used, same as PathFind::tRoute
+	typedef std::stack<Maze::tCoord> tRoute;
+
+	/**
+	 * Initializes the field for the grid, build() must be called before
+	 * any distance can be read.
+	 * @param pGrid - grid of the maze, must outlive the field
+	 */
+	DistanceField(Maze::tGrid* pGrid);
+
+	/**
+	 * Finds the steps from every open cell to the destination. Must be
+	 * called again if the grid's walls change.
+	 * @param dest - destination all distances are measured to
+	 */
+	void build(Maze::tCoord dest);
+
+	/**
+	 * Finds the steps from every open cell to the nearest of the
+	 * destinations. Must be called again if the grid's walls change.
+	 * @param dests - destinations all distances are measured to
+	 */
+	void build(const Maze::tCoords &dests);
+
+	/**
+	 * Returns if build() has been called
+	 */
+	bool isBuilt() { return m_built; }
+
+	/**
+	 * Returns if build() has been called since the grid's walls last changed
+	 */
+	bool isCurrent() { return m_built && m_version == m_pGrid->version; }
+
+	/**
+	 * Returns the first destination the field was built for
+	 */
+	Maze::tCoord getDest() { return m_dests.empty() ? Maze::tCoord() : m_dests.front(); }
+
+	/**
+	 * Returns all of the destinations the field was built for
+	 */
+	const Maze::tCoords &getDests() { return m_dests; }
+
+	/**
+	 * Returns if the field was built for exactly the destinations provided
+	 * @param dests - destinations to compare, in the same order
+	 */
+	bool hasDests(const Maze::tCoords &dests);
+
+	/**
+	 * Returns the number of steps from the cell to the destination
+	 * @param loc - cell to measure from
+	 * @returns steps to the destination, -1 if it cannot be reached
+	 */
+	int getDistance(Maze::tCoord loc);
+
+	/**
+	 * Finds the neighbor of the cell that is one step closer to the destination
+	 * @param loc - cell to step from
+	 * @param next - set to the neighbor to step to
+	 * @returns false if the destination cannot be reached, or loc is the destination
+	 */
+	bool nextStep(Maze::tCoord loc, Maze::tCoord &next);
+
+	/**
+	 * Builds the route to the nearest destination by stepping downhill from the cell
+	 * @param from - starting point of the route
+	 * @returns the route, not including the starting point. Empty if the
+	 *          destination is unreachable.
+	 */
+	tRoute routeFrom(Maze::tCoord from);
+
+	/**
+	 * Builds the route to the nearest destination by stepping downhill from the cell
+	 * @param from - starting point of the route
+	 * @param dest - set to the destination the route leads to
+	 * @returns the route, not including the starting point. Empty if no
+	 *          destination is reachable.
+	 */
+	tRoute routeFrom(Maze::tCoord from, Maze::tCoord &dest);
+
+private:
+	Maze::tGrid* m_pGrid;
+	Maze::tCoords m_dests;
+	bool m_built;
+	// Version of the grid when last built
+	unsigned long m_version;
+
+	// Steps to the destination by grid index, -1 for unreached cells
+	std::vector<int> m_dist;
+	// Queue of cells to expand while building
+	std::vector<Maze::tIndex> m_frontier;
+};
+
+#endif // !defined(_DISTANCEFIELD_HPP_)
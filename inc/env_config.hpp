@@ -49,10 +49,17 @@ public:
 	tBotCoords getBotCoords();
 
 	/**
-	 * Returns the coordinates of the exit in the maze
+	 * Returns the coordinates of the first exit in the maze
 	 * @returns tCoord - Location of the exit in the maze
 	 */
-	Maze::tCoord getExitCoord() { return m_exitLoc.coord; };
+	Maze::tCoord getExitCoord() { return m_exitLocs.empty() ? Maze::tCoord() : m_exitLocs.front().coord; };
+
+	/**
+	 * Returns the coordinates of every exit in the maze, in the order
+	 * they appear in the config file.
+	 * @returns tCoords - Locations of the exits in the maze
+	 */
+	Maze::tCoords getExitCoords();
 
 	/**
 	 * Returns a the cells in a maze aligned in rows
@@ -77,15 +84,15 @@ private:
 	// Defines the bots' starting location in the maze
 	tBotCfgLocs m_bots;
 
-	// Defines the exit's location in the maze
-	tCfgLoc m_exitLoc;
+	// Defines the exits' locations in the maze
+	std::vector<tCfgLoc> m_exitLocs;
 
 	// Contains a list of cells separated into rows
 	tMazeRows m_rows;
 
 	/**
 	 * Reads the line character by character building a row of eCells.
-	 * If the bot or exist is found the class's config loc will be updated
+	 * If a bot or exit is found the class's config locs will be updated
 	 * with its X position and row.  Which can be used later to calculate
 	 * the Y and Z position. If an unknown cell is found it will be substituted with
  	 * an empty cell.
@@ -4,6 +4,9 @@
 #include "env_config.hpp"
 #include "maze.hpp"
 #include "bot.hpp"
+#include "clustergraph.hpp"
+#include "distancefield.hpp"
+#include "junctiongraph.hpp"
 
 #include <map>
 
@@ -11,8 +14,12 @@ class Game {
 public:
 	/**
 	 * Initializes tha game so it can be built
+	 * @param storage - How the maze's cells will be stored once built
+	 * @param layout - Order of the maze's cells within its grid
+	 * @param strategy - Search algorithm the bots find their routes with
 	 */
-	Game();
+	Game(Maze::eStorage storage=Maze::STORAGE_CELLS, Maze::eLayout layout=Maze::LAYOUT_LINEAR,
+		PathFind::eStrategy strategy=PathFind::SEARCH_DISTANCE_FIELD);
 
 	/**
 	 * Cleans up any memeory allocated remaning
@@ -39,17 +46,59 @@ public:
 	 */
 	Maze* getMaze() { return m_pMaze; }
 
+	/**
+	 * Returns the cluster graph built for the hierarchical search, NULL
+	 * if the game doesn't use it.
+	 */
+	ClusterGraph* getClusterGraph() { return m_pClusters; }
+
+	/**
+	 * Returns the distance field to the exits shared by the bots, NULL
+	 * if the game doesn't use it.
+	 */
+	DistanceField* getDistanceField() { return m_pField; }
+
+	/**
+	 * Returns the junction graph built for the junction search, NULL
+	 * if the game doesn't use it.
+	 */
+	JunctionGraph* getJunctionGraph() { return m_pJunctions; }
+
+	/**
+	 * Returns the cache of routes shared by the bots
+	 */
+	RouteCache* getRouteCache() { return m_pCache; }
+
 private:
 	typedef std::map<char, Bot*> tBots;
 
 	// Game board that the bot will move through.
 	Maze* m_pMaze;
 
+	// How the maze's cells are stored, and in what order
+	Maze::eStorage m_storage;
+	Maze::eLayout m_layout;
+
+	// Search algorithm used by the bots
+	PathFind::eStrategy m_strategy;
+
+	// Portal graph of the maze, built once the maze is for the hierarchical search
+	ClusterGraph* m_pClusters;
+
+	// Distances to the nearest exit, built once for all of the bots to share
+	DistanceField* m_pField;
+
+	// Corridors of the maze contracted between its junctions, built once for the junction search
+	JunctionGraph* m_pJunctions;
+	// Routes found by any of the bots, bots replanning around the same
+	// wall from the same cell share the search.
+	RouteCache* m_pCache;
+
 	// Map of the bot that will travel the maze
 	tBots m_bots;
 
-	// Location of the exit point on the maze
-	Maze::tCoord m_ExitCoord;
+	// Locations of the exit points on the maze, each bot leaves by its nearest
+	Maze::tCoords m_ExitCoords;
 
 	/**
 	 * Creates the bots from the entity maping provided.
@@ -59,7 +108,7 @@ private:
 
 	/**
 	 * Calculate the bot's initialize route through the maze. If a bot is unable to find
-	 * a path to the exit, it will be removed from the game.
+	 * a path to any exit, it will be removed from the game.
 	 * @returns if any of the buts were able to find a route
 	 */
 	void initBots();
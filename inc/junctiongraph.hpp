@@ -0,0 +1,185 @@
+#ifndef _JUNCTIONGRAPH_HPP_
+#define _JUNCTIONGRAPH_HPP_
+
+#include "maze.hpp"
+
+#include <stack>
+#include <vector>
+#include <queue>
+#include <functional>
+
+/**
+ * Weighted graph of a static maze with its corridors contracted. Every
+ * open cell without exactly two open neighbors is a junction or dead end
+ * and becomes a node, as do the exits and any spawn points provided to
+ * build(). The remaining cells form corridors one cell wide between the
+ * nodes, and each corridor becomes an edge weighted by its length.
+ *
+ * Routes are found by searching the nodes, so a search costs about the
+ * same however long the corridors are. The corridors the route takes are
+ * then walked to fill in the cells of the route.
+ */
+class JunctionGraph {
+public:
+	// Route that should be used, same as PathFind::tRoute
+	typedef std::stack<Maze::tCoord> tRoute;
+
+	/**
+	 * Initializes the graph for the grid, build() must be called before
+	 * any route can be found.
+	 * @param pGrid - grid of the maze, must outlive the graph
+	 */
+	JunctionGraph(Maze::tGrid* pGrid);
+
+	/**
+	 * Finds the nodes of the maze and the corridors between them. Must be
+	 * called again if the grid's walls change.
+	 * @param spawns - cells to make nodes even if they are in a corridor,
+	 *                 such as the entities' starting points
+	 */
+	void build(const Maze::tCoords &spawns=Maze::tCoords());
+
+	/**
+	 * Returns if build() has been called since the grid's walls last changed
+	 */
+	bool isCurrent() { return m_built && m_version == m_pGrid->version; }
+
+	/**
+	 * Finds the shortest route through the graph, and walks the corridors
+	 * it takes to fill in the cells of the route.
+	 * @param from - starting point of the route
+	 * @param dest - destination of the route
+	 * @returns the route, not including the starting point. Empty if the
+	 *          destination is unreachable.
+	 */
+	tRoute findRoute(Maze::tCoord from, Maze::tCoord dest);
+
+	/**
+	 * Returns the number of nodes found by build()
+	 */
+	long getNumNodes() { return m_nodes.size(); }
+
+	/**
+	 * Returns the number of corridors found by build()
+	 */
+	long getNumEdges() { return m_edges.size(); }
+
+	/**
+	 * Returns the number of nodes expanded by the last findRoute()
+	 */
+	long getExpandedCount() { return m_expanded; }
+
+private:
+	// Corridor between two nodes. Its cells are numbered from 1 at the
+	// first node's end to length - 1 at the second's.
+	struct tEdge {
+		int a, b;
+		int length;
+		// Direction of the first step from each end
+		unsigned char dirA, dirB;
+		tEdge(int _a=0, int _b=0, int l=0, unsigned char dA=0, unsigned char dB=0):
+			a(_a), b(_b), length(l), dirA(dA), dirB(dB) {}
+	};
+
+	// Junction, dead end, exit, or spawn point
+	struct tNode {
+		Maze::tIndex idx;
+		Maze::tCoord loc;
+		// Edges leading from the node
+		std::vector<int> edges;
+		tNode(Maze::tIndex i=0, Maze::tCoord l=Maze::tCoord()): idx(i), loc(l) {}
+	};
+
+	// Where a route starts or ends, a node or a cell of a corridor
+	struct tEnd {
+		int node;
+		int edge;
+		int pos;
+		tEnd(): node(-1), edge(-1), pos(0) {}
+	};
+
+	// Node queued by its estimated route length
+	typedef std::pair<int, int> tQueued;
+	typedef std::priority_queue<tQueued, std::vector<tQueued>, std::greater<tQueued> > tOpenQueue;
+
+	Maze::tGrid* m_pGrid;
+	bool m_built;
+	// Version of the grid when last built
+	unsigned long m_version;
+
+	std::vector<tNode> m_nodes;
+	std::vector<tEdge> m_edges;
+	// Node of each cell by grid index, -1 for cells that aren't nodes
+	std::vector<int> m_cellNode;
+	// Corridor of each cell by grid index and the cell's number along it,
+	// -1 for cells that aren't in a corridor
+	std::vector<int> m_cellEdge;
+	std::vector<int> m_cellPos;
+
+	// Node search scratch space. A node's cost is only valid if its stamp
+	// matches the current search, so nothing is cleared between searches.
+	std::vector<int> m_cost;
+	std::vector<int> m_parent;
+	std::vector<int> m_parentEdge;
+	std::vector<unsigned int> m_stamp;
+	unsigned int m_search;
+	long m_expanded;
+
+	/**
+	 * Walks the corridor leaving the node in the direction provided, and
+	 * adds it as an edge if it hasn't been added from its other end.
+	 * @param node - node the corridor leaves
+	 * @param dir - direction of the corridor's first step
+	 */
+	void addCorridor(int node, Maze::eDirection dir);
+
+	/**
+	 * Finds the node or corridor cell a route starts or ends at
+	 * @param idx - grid index of the cell, must be open
+	 * @returns where the route starts or ends
+	 */
+	tEnd findEnd(Maze::tIndex idx);
+
+	/**
+	 * Walks along a corridor from one of its ends, adding each cell
+	 * stepped into.
+	 * @param edge - corridor to walk
+	 * @param fromA - true to start at the first node, false for the second
+	 * @param steps - number of cells to step into
+	 * @param cells - cells the steps are appended to in order
+	 */
+	void walkEdge(int edge, bool fromA, int steps, std::vector<Maze::tIndex> &cells);
+
+	/**
+	 * Returns the number of steps between a node and a corridor cell
+	 * @param end - corridor cell
+	 * @param fromA - true for the corridor's first node, false for its second
+	 */
+	int stepsToEnd(const tEnd &end, bool fromA) {
+		return fromA ? end.pos : m_edges[end.edge].length - end.pos;
+	}
+
+	/**
+	 * Lowers the cost of a node if the cost provided is less, and queues it
+	 * @param node - node reached
+	 * @param cost - steps to the node
+	 * @param parent - node the node was reached from
+	 * @param edge - edge the node was reached by, -1 if it is the same cell
+	 * @param estimate - estimated steps from the node to the destination
+	 * @param openQ - queue of nodes to expand
+	 */
+	void relax(int node, int cost, int parent, int edge, int estimate, tOpenQueue &openQ);
+
+	/**
+	 * Adds the cells stepped into moving from one node of the search to
+	 * the next.
+	 * @param from - node moved from
+	 * @param to - node moved to
+	 * @param start - where the route starts
+	 * @param end - where the route ends
+	 * @param cells - cells of the route the steps are appended to in order
+	 */
+	void expandHop(int from, int to, const tEnd &start, const tEnd &end, std::vector<Maze::tIndex> &cells);
+};
+
+#endif // !defined(_JUNCTIONGRAPH_HPP_)
@@ -3,9 +3,14 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdint.h>
 #include <string>
 #include <utility>
 #include <vector>
+#include <set>
+#include <deque>
+
+#include "bitlayer.hpp"
 
 /**
  * Definies the maze object that the entities will travel through.
@@ -62,6 +67,14 @@ public:
 			sprintf(buff, "(%d,%d,%d)", x, y, z);
 			return std::string(buff);
 		}
+		/**
+		 * Returns the number of steps to the coordinate moving only along
+		 * the axes, the manhattan distance.
+		 * @param coord - coordinate to measure to
+		 */
+		int distance(const tCoord coord) const {
+			return abs(x - coord.x) + abs(y - coord.y) + abs(z - coord.z);
+		}
 		char direction(const tCoord coord) {
 			if (coord.z < z) { return 'N'; }
 			else if (coord.z > z) { return 'S'; }
@@ -73,28 +86,273 @@ public:
 		}
 	};
 
-	// defines a specific cell in the maze. it contains its location and state
+	// How the state of the grid's cells is stored
+	enum eStorage {
+		// One byte per cell holding the cell's state
+		STORAGE_CELLS,
+		// One bit per cell marking walls, the few exit cells
+		// are kept in a sparse set next to the wall bits.
+		STORAGE_PACKED,
+		// One byte per cell, but only for the bricks of the grid that
+		// have open cells. Bricks that are entirely solid are not
+		// allocated, so the maze starts out solid rather than empty.
+		// Always uses the brick layout.
+		STORAGE_SPARSE
+	};
+
+	// Index of a cell inside of the grid's contiguous cell buffer
+	typedef long tIndex;
+	typedef std::set<tIndex> tIndexSet;
+
+	// Directions an entity can move in to reach an adjacent cell
+	enum eDirection {
+		DIR_NORTH,
+		DIR_SOUTH,
+		DIR_EAST,
+		DIR_WEST,
+		DIR_UP,
+		DIR_DOWN,
+		NUM_DIRECTIONS
+	};
+
+	// defines a specific cell in the maze. Only the state is stored, the
+	// cell's location is derived from its position in the grid.
 	struct tCell {
-		tCoord coord;
-		eCell state;
+		unsigned char state;
+
+		tCell(eCell s = CELL_EMPTY): state(s) {}
+	};
 
-		tCell(eCell s = CELL_EMPTY, tCoord c=tCoord()): state(s), coord(c) {}
+	// Order the cells are laid out in within the grid's cell buffer
+	enum eLayout {
+		// Z is the fastest changing axis followed by Y then X
+		LAYOUT_LINEAR,
+		// Cells ordered along a Z-order (Morton) curve over the grid, keeping
+		// neighbors along all three axes close in memory. Each axis is padded
+		// up to the same power of two, best suited to roughly cubic mazes.
+		LAYOUT_MORTON,
+		// The grid is split into 8x8x8 bricks stored one after another, with
+		// the cells in Morton order within each brick.
+		LAYOUT_BRICK
 	};
 
-	// defines the maze's grid
+	// Number of bits, and cells, along each axis of a brick
+	static const int BRICK_BITS = 3;
+	static const int BRICK_SIZE = 1 << BRICK_BITS;
+
+	// defines the maze's grid, the static layer of the maze. Only walls and
+	// exits are stored here, the entities occupying cells are tracked by the
+	// Maze's occupancy overlay so moving them never changes the grid.
+	// The cells are stored in a single contiguous buffer, ordered by the
+	// grid's layout. The grid can be padded with a solid border so that
+	// the neighbors of any cell inside of the maze can be found without
+	// bounds checking. With packed storage there is no cell buffer, and the
+	// cell states must be accessed by index with state() and setState().
+	// With sparse storage the buffer is split into separately allocated
+	// bricks, and cells must only be updated with setState().
 	struct tGrid {
-		tCell*** layout;
+		tCell* cells;
 		tDimension dim;
-		tGrid(tDimension d=tDimension(), tCell*** l=NULL): dim(d), layout(l) {}
+		int border;
+		eStorage storage;
+		eLayout layout;
+
+		// Packed storage, wall bit per cell and the sparse exit cells
+		BitLayer walls;
+		tIndexSet exits;
+
+		// Sparse storage, cells of each brick. NULL for solid bricks
+		std::vector<tCell*> chunks;
+		// Sparse storage, number of bricks allocated
+		tIndex numChunks;
+
+		// Linear layout, distance in the cell buffer between cells adjacent along each axis
+		tIndex strideX, strideY, strideZ;
+		// Total number of cells in the buffer, including the border and layout padding
+		tIndex size;
+		// Linear layout, distance in the cell buffer to the neighbor in each direction
+		tIndex offsets[NUM_DIRECTIONS];
+		// Brick layout, number of bricks along the Y and Z axes
+		tIndex bricksY, bricksZ;
+
+		// Number of times a cell has been opened or walled off by Maze::updateCell()
+		unsigned long version;
+		// Cells opened or walled off, the most recent last. Only the last
+		// MAX_CHANGES are kept, the first is the change made at version
+		// version - changes.size() + 1.
+		std::deque<tIndex> changes;
+		static const size_t MAX_CHANGES = 4096;
+
+		// Open cells filled by Maze::fillDeadEnds(). No route between two
+		// cells that weren't filled passes through one, so searches may skip
+		// them while the grid is still at the version they were filled at.
+		BitLayer deadEnds;
+		unsigned long deadEndsVersion;
+		bool deadEndsFilled;
+
+		/**
+		 * Initializes the grid's strides and size, the cells are not allocated.
+		 * @param d - dimensions of the maze
+		 * @param b - thickness of the border
+		 * @param s - how the cells will be stored
+		 * @param l - order of the cells in the cell buffer
+		 */
+		tGrid(tDimension d=tDimension(), int b=0, eStorage s=STORAGE_CELLS, eLayout l=LAYOUT_LINEAR);
+
+		// Returns if the coordinate is inside of the maze, border excluded
+		bool contains(tCoord c) {
+			if (c.x < 0 || c.y < 0 || c.z < 0) { return false; }
+			if (c.x >= dim.width || c.y >= dim.height || c.z >= dim.depth) { return false; }
+			return true;
+		}
+
+		// Returns the position of the coordinate in the cell buffer. The
+		// coordinate is not validated, use contains() first if unsure.
+		tIndex index(tCoord c) {
+			if (layout == LAYOUT_LINEAR) {
+				return (c.x + border) * strideX + (c.y + border) * strideY + (c.z + border) * strideZ;
+			}
+			return layoutIndex(c.x + border, c.y + border, c.z + border);
+		}
+
+		// Returns the index of the cell adjacent to the one provided. Only safe
+		// without bounds checking when the grid has a border.
+		tIndex neighbor(tIndex idx, eDirection dir) {
+			if (layout == LAYOUT_LINEAR) { return idx + offsets[dir]; }
+			return layoutNeighbor(idx, dir);
+		}
+
+		// Returns the cell stored at the index in the cell buffer. Not
+		// available with packed storage. With sparse storage the cells of
+		// solid bricks aren't allocated, and NULL is returned for them.
+		tCell* cell(tIndex idx) {
+			if (storage == STORAGE_SPARSE) {
+				tCell* chunk = chunks[idx >> (3 * BRICK_BITS)];
+				if (chunk == NULL) { return NULL; }
+				return &chunk[idx & ((1 << (3 * BRICK_BITS)) - 1)];
+			}
+			return &cells[idx];
+		}
+
+		// Returns the state of the cell at the index
+		eCell state(tIndex idx) {
+			if (storage == STORAGE_CELLS) { return (eCell)cells[idx].state; }
+			if (storage == STORAGE_SPARSE) {
+				tCell* pCell = cell(idx);
+				return (pCell == NULL) ? CELL_SOLID : (eCell)pCell->state;
+			}
+
+			if (walls.test(idx)) { return CELL_SOLID; }
+			if (exits.count(idx) != 0) { return CELL_EXIT; }
+			return CELL_EMPTY;
+		}
+
+		// Returns if the cell at the index can be moved through
+		bool isOpen(tIndex idx) {
+			if (storage == STORAGE_CELLS) { return cells[idx].state != CELL_SOLID; }
+			if (storage == STORAGE_SPARSE) {
+				tCell* pCell = cell(idx);
+				return pCell != NULL && pCell->state != CELL_SOLID;
+			}
+			return !walls.test(idx);
+		}
+
+		/**
+		 * Returns which of the cell's neighbors can be moved into. Bit N of
+		 * the mask is set if the neighbor in eDirection N is open.
+		 * @param idx - index of the cell, must not be in the border
+		 * @returns mask of open neighbors
+		 */
+		unsigned int openNeighbors(tIndex idx);
+
+		/**
+		 * Updates the state of the cell at the index. Only the static
+		 * states, solid, empty, and exit, are stored in the grid.
+		 * @param idx - index of the cell
+		 * @param s - new state of the cell
+		 */
+		void setState(tIndex idx, eCell s);
+
+		/**
+		 * Records that the cell was opened or walled off, and moves the
+		 * grid on to the next version.
+		 * @param idx - index of the cell
+		 */
+		void noteChange(tIndex idx);
+
+		/**
+		 * Finds the cells opened or walled off since the version provided.
+		 * @param since - version of the grid the caller last saw
+		 * @param cells - set to the cells changed, oldest first. A cell may
+		 *                be listed more than once.
+		 * @returns false if older changes were dropped, and the caller must
+		 *          treat every cell as changed
+		 */
+		bool changesSince(unsigned long since, std::vector<tIndex> &cells);
+
+		// Returns if the dead ends were filled since the grid last changed
+		bool hasDeadEnds() { return deadEndsFilled && deadEndsVersion == version; }
+
+		// Returns the index in the cell buffer of a cell belonging to this
+		// grid. Only valid with cell storage, the other storages don't keep
+		// their cells in one buffer.
+		tIndex indexOf(tCell* pCell) { return pCell - cells; }
+
+		// Returns the coordinate of the cell at the index in the cell buffer
+		tCoord coord(tIndex idx) {
+			if (layout != LAYOUT_LINEAR) {
+				tCoord c = layoutCoord(idx);
+				return tCoord(c.x - border, c.y - border, c.z - border);
+			}
+
+			int x = idx / strideX;
+			idx -= x * strideX;
+			int y = idx / strideY;
+			idx -= y * strideY;
+			return tCoord(x - border, y - border, idx / strideZ - border);
+		}
+
+		// Returns the coordinate of a cell belonging to this grid. Only
+		// valid with cell storage, like indexOf().
+		tCoord coordOf(tCell* pCell) { return coord(indexOf(pCell)); }
+
+		// Returns the cell at the coordinates, not available with packed
+		// storage. With sparse storage NULL is returned for the cells of
+		// solid bricks, update them with setState() instead.
 		tCell* at(tCoord c) {
 			// Make sure the coordinates are valid first!
-			if (c.x < 0 || c.y < 0 || c.z < 0) { return NULL; }
-			if (c.x >= dim.width || c.y >= dim.height || c.z >= dim.depth) { return NULL; }
+			if (!contains(c) || storage == STORAGE_PACKED) { return NULL; }
 
-			return &(layout[c.x][c.y][c.z]);
+			return cell(index(c));
 		}
+
+		/**
+		 * Returns the index of the padded coordinate for the Morton and brick
+		 * layouts. Padded coordinates include the border.
+		 * @param x, y, z - padded coordinate of the cell
+		 * @returns index of the cell in the cell buffer
+		 */
+		tIndex layoutIndex(tIndex x, tIndex y, tIndex z);
+
+		/**
+		 * Returns the padded coordinate of the index for the Morton and
+		 * brick layouts.
+		 * @param idx - index of the cell in the cell buffer
+		 * @returns padded coordinate of the cell
+		 */
+		tCoord layoutCoord(tIndex idx);
+
+		/**
+		 * Returns the index of the cell adjacent to the one provided for
+		 * the Morton and brick layouts.
+		 * @param idx - index of the cell in the cell buffer
+		 * @param dir - direction of the neighbor
+		 * @returns index of the neighbor
+		 */
+		tIndex layoutNeighbor(tIndex idx, eDirection dir);
 	};
 
+	typedef std::vector<tCoord> tCoords;
 	typedef std::pair<char, tCoord> tSymCoordPair;
 	typedef std::vector<tSymCoordPair> tSymCoordPairs;
 
@@ -102,8 +360,10 @@ public:
 	 * Initializes the maze and with a given size. Once it is initialized it is
 	 * read to have its cells' state set.
 	 * @param dim tDimension - Size of the maze.
+	 * @param storage - How the maze's cells will be stored
+	 * @param layout - Order of the cells within the grid
 	 */
-	Maze(tDimension dim);
+	Maze(tDimension dim, eStorage storage=STORAGE_CELLS, eLayout layout=LAYOUT_LINEAR);
 
 	/**
 	 * Cleans up the maze object once when it is being deconstructed.
@@ -122,7 +382,18 @@ public:
 	 * Returns if the grid specified  and is valid
 	 * @returns state of the grid
 	 */
-	bool hasGrid() { return (m_pGrid != NULL && m_pGrid->layout != NULL); }
+	bool hasGrid() {
+		return (m_pGrid != NULL && (m_pGrid->cells != NULL || m_pGrid->storage != STORAGE_CELLS));
+	}
+
+	/**
+	 * Returns the state cells of the maze have before they are updated.
+	 * Sparse mazes start solid, all others start empty.
+	 * @returns initial state of the cells
+	 */
+	eCell getDefaultState() {
+		return (m_pGrid != NULL && m_pGrid->storage == STORAGE_SPARSE) ? CELL_SOLID : CELL_EMPTY;
+	}
 
 	/**
 	 * returns if the coordinate provided are valid inside of the grid
@@ -132,13 +403,101 @@ public:
 	bool isValidCoord(tCoord coord);
 
 	/**
-	 * Updates the cell located at the coordiantes with the state provided
+	 * Returns the state of the cell located at the coordinates, combining
+	 * the static grid with the occupancy overlay. Exits stay exits even
+	 * when occupied.
+	 * @param coord - Location of the cell
+	 * @returns state of the cell, CELL_INVALID if the coordinate is not in the maze
+	 */
+	eCell getState(tCoord coord);
+
+	/**
+	 * Updates the cell located at the coordiantes with the state provided.
+	 * CELL_OCCUPIED is recorded in the occupancy overlay, opening the cell
+	 * if it was solid. All other states update the static grid and clear any
+	 * occupant of the cell.
 	 * @param coord - Location of the cell to update
 	 * @param state - Not state
 	 * @returns success if the cell was updated
 	 */
 	bool updateCell(tCoord coord, eCell state);
 
+	/**
+	 * Marks the cell as occupied by an entity in the occupancy overlay.
+	 * The static grid is not changed.
+	 * @param coord - Location of the cell
+	 * @returns success if the coordinate is in the maze
+	 */
+	bool occupy(tCoord coord);
+
+	/**
+	 * Removes the occupant of the cell from the occupancy overlay
+	 * @param coord - Location of the cell
+	 */
+	void vacate(tCoord coord);
+
+	/**
+	 * Returns if an entity occupies the cell
+	 * @param coord - Location of the cell
+	 * @returns true if the cell is occupied
+	 */
+	bool isOccupied(tCoord coord);
+
+	/**
+	 * Returns the indexes of all cells currently occupied
+	 * @returns set of occupied cell indexes
+	 */
+	const tIndexSet &getOccupied() { return m_occupied; }
+
+	/**
+	 * Returns if an entity could move between the two cells through the
+	 * open cells of the maze. The maze's connected areas are labeled on the
+	 * first call and kept until cells are walled off, so each check after
+	 * the first takes constant time. Grids too large to label are taken
+	 * to connect all of their open cells.
+	 * @param from - first cell
+	 * @param to - second cell
+	 * @returns true if both cells are open and connected
+	 */
+	bool isReachable(tCoord from, tCoord to);
+
+	/**
+	 * Fills the maze's dead ends, open cells with at most one open neighbor
+	 * that aren't an exit or occupied. Filling a cell may leave its neighbor
+	 * a dead end in turn, so each cul-de-sac is filled back to the junction
+	 * it branches from. The cells are recorded in the grid's dead end layer
+	 * instead of being walled off, and are only skipped by searches until
+	 * the grid next changes.
+	 * @returns number of cells filled
+	 */
+	long fillDeadEnds();
+
+	/**
+	 * Returns if the cell was filled by the last fillDeadEnds(), and the
+	 * grid hasn't changed since.
+	 * @param coord - Location of the cell
+	 */
+	bool isDeadEnd(tCoord coord);
+
+	/**
+	 * Returns the number of cells filled by the last fillDeadEnds()
+	 */
+	long getDeadEndCount() { return m_deadEndCount; }
+
+	/**
+	 * Returns the offset to the cell adjacent in the direction provided
+	 * @param dir - direction to step in
+	 * @returns coordinate offset of the step
+	 */
+	static tCoord step(eDirection dir);
+
+	/**
+	 * Returns the direction that undoes a step in the direction provided
+	 * @param dir - direction to reverse
+	 * @returns the opposite direction
+	 */
+	static eDirection opposite(eDirection dir) { return (eDirection)(dir ^ 1); }
+
 	/**
 	 * Prints out the layer of the maze along the Y axis of the X/Z plain.
 	 * If the layer is invalid (above or below the maze) nothing will be printed.
@@ -150,13 +509,63 @@ private:
 	// 3d size dimension of the maze.
 	tGrid* m_pGrid;
 
+	// Occupancy overlay, index of every cell occupied by an entity
+	tIndexSet m_occupied;
+
+	// Id of a connected area, the index of its root cell. Kept to 32 bits
+	// to halve the forest, grids with more cells don't label their areas.
+	typedef uint32_t tAreaId;
+
+	// Connected areas of open cells as a union find forest, by cell index.
+	// Cells in the same area share a root.
+	std::vector<tAreaId> m_areaParent;
+	// Version of the grid the areas were labeled for
+	unsigned long m_areaVersion;
+	bool m_areasLabeled;
+	// Cells changed since the areas were labeled
+	std::vector<tIndex> m_areaChanged;
+
+	// Number of cells filled by the last fillDeadEnds()
+	long m_deadEndCount;
+
+	/**
+	 * Labels the connected areas of open cells, joining each open cell with
+	 * its open neighbors to the west, below, and north.
+	 * @returns false if the grid has too many cells for an area id
+	 */
+	bool labelAreas();
+
+	/**
+	 * Joins an open cell to the areas of all of its open neighbors
+	 * @param idx - index of the cell
+	 */
+	void joinNeighborAreas(tIndex idx);
+
+	/**
+	 * Returns the root of the area the cell belongs to
+	 * @param idx - index of the cell
+	 * @returns index of the area's root cell
+	 */
+	tAreaId findArea(tIndex idx);
+
+	/**
+	 * Returns if the cell must be left open when filling dead ends, because
+	 * routes start or end there.
+	 * @param idx - index of the cell
+	 * @returns true for exits and occupied cells
+	 */
+	bool isKeptOpen(tIndex idx);
+
 
 	/**
 	 * Creates and returns a new maze grid with the dimenions provided
 	 * @param dim - the dimenional size of the grid.
+	 * @param storage - How the grid's cells will be stored
+	 * @param layout - Order of the cells within the grid
+	 * @param border - thickness of the solid border padding the grid.
 	 * @returns a new grid object.
 	 */
-	tGrid* createGrid(tDimension dim);
+	tGrid* createGrid(tDimension dim, eStorage storage, eLayout layout, int border=1);
 
 
 	/**
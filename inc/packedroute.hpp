@@ -0,0 +1,108 @@
+#ifndef _PACKEDROUTE_HPP_
+#define _PACKEDROUTE_HPP_
+
+#include "maze.hpp"
+
+#include <stdint.h>
+#include <stack>
+#include <string>
+#include <vector>
+
+/**
+ * Route stored as the direction of each step, packed 3 bits per step
+ * into 64 bit words. Only the starting point is stored as a coordinate,
+ * the cell of each step is found by stepping from it. A cursor marks
+ * the next step to take, so taken steps are never removed.
+ */
+class PackedRoute {
+public:
+	// Route as returned by PathFind, the next step on top
+	typedef std::stack<Maze::tCoord> tRoute;
+
+	// Bits stored per step, and steps stored per word
+	static const int STEP_BITS = 3;
+	static const int STEPS_PER_WORD = 64 / STEP_BITS;
+
+	/**
+	 * Initializes an empty route starting at the coordinate provided
+	 * @param start - cell the route starts from
+	 */
+	PackedRoute(Maze::tCoord start=Maze::tCoord());
+
+	/**
+	 * Initializes the route from one found by PathFind
+	 * @param start - cell the route starts from, not included in the route
+	 * @param route - cells of the route, the first step on top. Each must
+	 *                be adjacent to the one before it.
+	 */
+	PackedRoute(Maze::tCoord start, tRoute route);
+
+	/**
+	 * Adds a step to the end of the route
+	 * @param dir - direction of the step
+	 */
+	void append(Maze::eDirection dir);
+
+	/**
+	 * Returns the direction of a step
+	 * @param pos - position of the step in the route, from 0
+	 */
+	Maze::eDirection direction(size_t pos) const {
+		return (Maze::eDirection)((m_words[pos / STEPS_PER_WORD] >> ((pos % STEPS_PER_WORD) * STEP_BITS)) & 7);
+	}
+
+	/**
+	 * Returns the number of steps in the route, taken or not
+	 */
+	size_t size() const { return m_size; }
+
+	/**
+	 * Returns the number of steps left to take
+	 */
+	size_t remaining() const { return m_size - m_cursor; }
+
+	/**
+	 * Returns if every step has been taken
+	 */
+	bool done() const { return m_cursor >= m_size; }
+
+	/**
+	 * Returns the cell reached by the steps taken so far
+	 */
+	Maze::tCoord getLoc() const { return m_loc; }
+
+	/**
+	 * Returns the cell the next step leads to. Must not be called once done.
+	 */
+	Maze::tCoord next() const { return Maze::tCoord(m_loc) + Maze::step(direction(m_cursor)); }
+
+	/**
+	 * Returns the direction of the next step. Must not be called once done.
+	 */
+	Maze::eDirection nextDirection() const { return direction(m_cursor); }
+
+	/**
+	 * Takes the next step, moving the cursor past it
+	 */
+	void advance();
+
+	/**
+	 * Returns the steps of the route as letters "NSEWUD"
+	 */
+	std::string String() const;
+
+	/**
+	 * Returns the number of bytes used to store the steps
+	 */
+	size_t bytes() const { return m_words.capacity() * sizeof(uint64_t); }
+
+private:
+	// Steps packed from the lowest bits of each word up
+	std::vector<uint64_t> m_words;
+	size_t m_size;
+	size_t m_cursor;
+	// Cell at the cursor
+	Maze::tCoord m_loc;
+};
+
+#endif // !defined(_PACKEDROUTE_HPP_)
@@ -0,0 +1,169 @@
+#ifndef _PARALLELBFS_HPP_
+#define _PARALLELBFS_HPP_
+
+#include "maze.hpp"
+#include "bitlayer.hpp"
+
+#include <pthread.h>
+#include <stack>
+#include <vector>
+
+/**
+ * Breadth first search that expands each level of the search across a
+ * pool of threads. Small levels are expanded top down, each thread
+ * claiming the unvisited neighbors of its share of the frontier. Once a
+ * level is a large part of the unvisited cells it is cheaper to go bottom
+ * up instead, each thread checking its share of the unvisited cells for a
+ * neighbor in the frontier.
+ *
+ * The routes found are as short as the serial breadth first search's, but
+ * which of several equally short routes is found depends on the threads.
+ */
+class ParallelBfs {
+public:
+	// Route that should be used, same as PathFind::tRoute
+	typedef std::stack<Maze::tCoord> tRoute;
+
+	/**
+	 * Initializes the search for the grid, and starts its threads
+	 * @param pGrid - grid of the maze, must outlive the search
+	 * @param numThreads - threads to search with, 0 for one per processor
+	 */
+	ParallelBfs(Maze::tGrid* pGrid, int numThreads=0);
+
+	/**
+	 * Stops the search's threads
+	 */
+	~ParallelBfs();
+
+	/**
+	 * Searches for the destination a level at a time
+	 * @param from - starting point of the route
+	 * @param dest - destination of the route
+	 * @returns the route, not including the starting point. Empty if the
+	 *          destination is unreachable.
+	 */
+	tRoute findRoute(Maze::tCoord from, Maze::tCoord dest);
+
+	/**
+	 * Returns the number of threads searching, including the caller's
+	 */
+	int getNumThreads() { return m_numThreads; }
+
+	/**
+	 * Returns the number of cells expanded by the last findRoute()
+	 */
+	long getExpandedCount() { return m_expanded; }
+
+	/**
+	 * Returns the number of levels the last findRoute() expanded bottom up
+	 */
+	int getBottomUpLevels() { return m_bottomUpLevels; }
+
+private:
+	// Work the threads are asked to do for a level
+	enum eStep {
+		// Claim the unvisited neighbors of the frontier
+		STEP_TOP_DOWN,
+		// Find the unvisited cells with a neighbor in the frontier
+		STEP_BOTTOM_UP,
+		// Mark the cells found bottom up as visited
+		STEP_MERGE,
+		// Find the solid cells of the grid
+		STEP_SNAPSHOT,
+		// Stop the threads
+		STEP_EXIT
+	};
+
+	// Thread of the pool, and the cells it found for the next level
+	struct tWorker {
+		ParallelBfs* pOwner;
+		int id;
+		pthread_t thread;
+		std::vector<Maze::tIndex> found;
+		long numOpen;
+	};
+
+	Maze::tGrid* m_pGrid;
+	int m_numThreads;
+	std::vector<tWorker> m_workers;
+	pthread_barrier_t m_startBarrier;
+	pthread_barrier_t m_doneBarrier;
+	eStep m_step;
+
+	long m_expanded;
+	int m_bottomUpLevels;
+
+	// Solid cells of the grid, and the number of open cells, as of the
+	// grid's version when they were found. Searches start with the solid
+	// cells visited so they never need to be checked for.
+	BitLayer m_solid;
+	long m_numOpen;
+	unsigned long m_solidVersion;
+	bool m_solidValid;
+
+	// Cells visited by the levels already expanded
+	BitLayer m_visited;
+	// Cells found by the bottom up level being expanded
+	BitLayer m_found;
+	// Direction moved to reach each visited cell from its parent
+	std::vector<unsigned char> m_parentDir;
+	// Cells of the level being expanded
+	std::vector<Maze::tIndex> m_frontier;
+
+	/**
+	 * Runs a step on every thread, and waits for them all to finish it
+	 * @param step - work to do
+	 */
+	void runStep(eStep step);
+
+	/**
+	 * Does the thread's share of the current step
+	 * @param worker - thread the work is for
+	 */
+	void doStep(tWorker &worker);
+
+	/**
+	 * Thread entry point, runs steps until asked to exit
+	 * @param pArg - the thread's tWorker
+	 */
+	static void* workerMain(void* pArg);
+
+	/**
+	 * Claims the unvisited neighbors of the thread's share of the frontier
+	 * @param worker - thread the work is for
+	 */
+	void expandTopDown(tWorker &worker);
+
+	/**
+	 * Checks the thread's share of the unvisited cells for a neighbor in
+	 * the frontier. The visited cells are not changed until the merge step,
+	 * so every visited neighbor is in the frontier.
+	 * @param worker - thread the work is for
+	 */
+	void expandBottomUp(tWorker &worker);
+
+	/**
+	 * Marks the cells found bottom up in the thread's share of the grid visited
+	 * @param worker - thread the work is for
+	 */
+	void mergeFound(tWorker &worker);
+
+	/**
+	 * Finds the solid cells in the thread's share of the grid, and counts
+	 * the open ones.
+	 * @param worker - thread the work is for
+	 */
+	void snapshotSolid(tWorker &worker);
+
+	/**
+	 * Returns the range of words of the visited layer a thread works on.
+	 * Threads never share a word, so no atomics are needed bottom up.
+	 * @param worker - thread the work is for
+	 * @param first - set to the first word
+	 * @param last - set to one past the last word
+	 */
+	void wordRange(tWorker &worker, BitLayer::tIndex &first, BitLayer::tIndex &last);
+};
+
+#endif // !defined(_PARALLELBFS_HPP_)
@@ -3,16 +3,51 @@
 
 #include "pathtree.hpp"
 #include "maze.hpp"
+#include "bitlayer.hpp"
+#include "clustergraph.hpp"
+#include "junctiongraph.hpp"
+#include "distancefield.hpp"
+#include "parallelbfs.hpp"
+#include "routecache.hpp"
 
 #include <stack>
 #include <queue>
+#include <vector>
+#include <functional>
 
 class PathFind {
 public:
 	// Route that should be used
-	typedef std::stack<Maze::tCell*> tRoute;
+	typedef std::stack<Maze::tCoord> tRoute;
 	typedef std::queue<PathTree*> tTreeNodeQueue;
 
+	// Search algorithms available to find routes with
+	enum eStrategy {
+		// Breadth first search building a PathTree node per expanded cell
+		SEARCH_TREE,
+		// Breadth first search over flat visited and parent arrays
+		SEARCH_BFS,
+		// A* search guided by the manhattan distance to the destination
+		SEARCH_ASTAR,
+		// Breadth first search from both ends meeting in the middle
+		SEARCH_BIDIRECTIONAL,
+		// A* over jump points, skipping straight runs of open cells
+		SEARCH_JUMP_POINT,
+		// A* over the portals of a prebuilt ClusterGraph
+		SEARCH_HIERARCHICAL,
+		// Steps downhill through a prebuilt DistanceField of the destination
+		SEARCH_DISTANCE_FIELD,
+		// D* Lite search from the destination, kept between searches and
+		// only repaired around the cells changed since the last one
+		SEARCH_INCREMENTAL,
+		// Breadth first search with each level expanded by the threads of
+		// a shared ParallelBfs
+		SEARCH_PARALLEL_BFS,
+		// A* over the junctions of a prebuilt JunctionGraph, with the
+		// corridors between them walked to fill in the route
+		SEARCH_JUNCTION
+	};
+
 	/**
 	 * Initializes the Path finder with the grid of the maze, and 
 	 * the starting location of the entity the route will be 
@@ -29,7 +64,9 @@ public:
 
 	/**
 	 * The location of the entity has changed.  Update the route tree
-	 * to reflect this.
+	 * to reflect this. If the entity moved to a cell of the tree the
+	 * tree search built, that cell becomes the root and the branches that
+	 * don't lead from it are pruned. Otherwise the tree is dropped.
 	 * @param loc - new location of entity
 	 */
 	void setLoc(Maze::tCoord loc);
@@ -40,36 +77,389 @@ public:
 	 */
 	void clearRoutes();
 
+	/**
+	 * Sets the search algorithm used by findRoute()
+	 * @param strategy - search algorithm to use
+	 */
+	void setStrategy(eStrategy strategy) { m_strategy = strategy; }
+
+	/**
+	 * Returns the search algorithm used by findRoute()
+	 */
+	eStrategy getStrategy() { return m_strategy; }
+
+	/**
+	 * Sets the cluster graph used by the hierarchical search. Without a
+	 * built graph the hierarchical search falls back to breadth first.
+	 * @param pClusters - graph built from the same grid, not owned
+	 */
+	void setClusterGraph(ClusterGraph* pClusters) { m_pClusters = pClusters; }
+
+	/**
+	 * Sets the distance field used by the distance field search. Routes
+	 * to any other destination than the field's fall back to breadth first.
+	 * @param pField - field built from the same grid, not owned
+	 */
+	void setDistanceField(DistanceField* pField) { m_pField = pField; }
+
+	/**
+	 * Sets the threaded search used by the parallel breadth first search.
+	 * Without one the parallel search falls back to breadth first.
+	 * @param pParallel - search over the same grid, not owned
+	 */
+	void setParallelBfs(ParallelBfs* pParallel) { m_pParallel = pParallel; }
+
+	/**
+	 * Sets the junction graph used by the junction search. Without a
+	 * built graph the junction search falls back to breadth first.
+	 * @param pJunctions - graph built from the same grid, not owned
+	 */
+	void setJunctionGraph(JunctionGraph* pJunctions) { m_pJunctions = pJunctions; }
+
+	/**
+	 * Sets the cache findRoute() looks routes up in before searching, and
+	 * stores the routes it finds in. The cache is ignored if it was made
+	 * for another grid.
+	 * @param pCache - cache of the same grid, not owned. NULL for none
+	 */
+	void setRouteCache(RouteCache* pCache) { m_pCache = pCache; }
+
+	/**
+	 * Returns the number of cells expanded by the last findRoute()
+	 */
+	long getExpandedCount() { return m_expanded; }
+
+	/**
+	 * Returns the number of cells the last jump point search stepped
+	 * through while jumping. The jump points it expanded are counted by
+	 * getExpandedCount(), the cells jumped over only here. 0 for the
+	 * other searches.
+	 */
+	long getScannedCount() { return m_scanned; }
+
+	/**
+	 * Returns the root of the tree built by the last tree search. The tree
+	 * is owned by the pathfinder, and is freed by the next tree search.
+	 * It is indexed, so the root's getNode() doesn't search the tree.
+	 * @returns root of the tree, NULL if no tree has been built or the
+	 *          entity has moved off of it
+	 */
+	PathTree* getTree() { return m_pTree; }
+
 	/**
 	 * Generates a mapping of the grid if one hasn't been generated yet,
 	 * and searches through the grid for the destintion provided. If
 	 * The destintaion is unreachable a empty route will be returned.
+	 * With a route cache set the route is looked up before searching.
+	 * The tree, breadth first, A*, and bidirectional searches skip the
+	 * grid's dead ends if they were filled since the grid last changed.
 	 * @param dest - Coordinate of the destination 
 	 * @returns the route in cells the 
 	 */
 	tRoute findRoute(Maze::tCoord dest);
+
+	/**
+	 * Searches for the nearest of several destinations. A single destination
+	 * is searched for with the strategy as findRoute() does. Otherwise the
+	 * distance field search uses its field if it was built to the same
+	 * destinations, and every other strategy searches breadth first until
+	 * any destination is reached.
+	 * @param dests - Coordinates of the destinations
+	 * @param dest - set to the destination the route leads to
+	 * @returns the route, empty if no destination is reachable.
+	 */
+	tRoute findNearestRoute(const Maze::tCoords &dests, Maze::tCoord &dest);
+
+	/**
+	 * Searches breadth first for a route to the nearest of the destinations
+	 * that doesn't pass through the cells provided, as if they were walled
+	 * off. Used to get around entities blocking a route, so the route
+	 * cache and the kept search state are neither used nor changed.
+	 * @param dests - Coordinates of the destinations
+	 * @param blocked - indexes of the cells to keep out of
+	 * @param dest - set to the destination the route leads to
+	 * @returns the route, empty if no destination can be reached.
+	 */
+	tRoute findDetour(const Maze::tCoords &dests, const Maze::tIndexSet &blocked, Maze::tCoord &dest);
 	
 private:
 	Maze::tGrid* m_pGrid;
 	Maze::tCoord m_curLoc;
+	eStrategy m_strategy;
+	ClusterGraph* m_pClusters;
+	DistanceField* m_pField;
+	ParallelBfs* m_pParallel;
+	JunctionGraph* m_pJunctions;
+	RouteCache* m_pCache;
+	// Dead ends the search may skip, NULL if none may be
+	const BitLayer* m_pPruned;
+
+	// Number of cells expanded by the last search
+	long m_expanded;
+	// Number of cells stepped through by the last jump point search's jumps
+	long m_scanned;
+
+	// Nodes of the tree search's tree, released in one go by each search
+	Arena m_treeArena;
+	// Root of the tree built by the last tree search
+	PathTree* m_pTree;
+	// Nodes of the tree by cell, with a slot per cell of the grid. Cleared
+	// by each tree search without touching the slots.
+	PathTreeIndex m_treeIndex;
+	// Version of the grid the tree was built on
+	unsigned long m_treeVersion;
+
+	// Search scratch space indexed by cell, kept between searches so
+	// the searches themselves don't allocate.
+	BitLayer m_visited;
+	// Direction moved to reach each visited cell from its parent
+	std::vector<unsigned char> m_parentDir;
+	// Queue of cells to expand
+	std::vector<Maze::tIndex> m_frontier;
+	// Bidirectional search scratch space for the search from the destination
+	BitLayer m_visitedBack;
+	std::vector<unsigned char> m_parentDirBack;
+	std::vector<Maze::tIndex> m_frontierBack;
+	// Destinations of the nearest destination search
+	BitLayer m_targets;
+	// Steps taken to reach each visited cell, used by A*
+	std::vector<int> m_cost;
+	// A* open cells bucketed by their estimated route length
+	std::vector< std::vector<Maze::tIndex> > m_buckets;
+
+	// Open cell of the incremental search, ordered by its key
+	struct tOpenCell {
+		int key1;
+		int key2;
+		Maze::tIndex idx;
+		tOpenCell(int k1=0, int k2=0, Maze::tIndex i=0): key1(k1), key2(k2), idx(i) {}
+		bool operator>(const tOpenCell &o) const {
+			return key1 > o.key1 || (key1 == o.key1 && key2 > o.key2);
+		}
+	};
+	typedef std::priority_queue<tOpenCell, std::vector<tOpenCell>, std::greater<tOpenCell> > tOpenQueue;
+
+	// Incremental search state, kept between searches. Steps from each
+	// cell to the destination, and the one step lookahead of them.
+	std::vector<int> m_incDist;
+	std::vector<int> m_incLookahead;
+	// Inconsistent cells, a cell may be queued more than once
+	tOpenQueue m_incOpen;
+	// Destination and starting point the search was last run for
+	Maze::tCoord m_incDest;
+	Maze::tCoord m_incLast;
+	// Sum of the starting point's moves, added to keys so queued keys stay valid
+	int m_incKeyOffset;
+	// Version of the grid the search was last run on
+	unsigned long m_incVersion;
+	bool m_incValid;
+	// Cells changed since the last search
+	std::vector<Maze::tIndex> m_incChanged;
+
+	/**
+	 * Searches for the destination with the current strategy
+	 * @param from starting point in the grid.
+	 * @param dest destination of the route.
+	 * @returns the route, empty if the destination is unreachable.
+	 */
+	tRoute searchRoute(Maze::tCoord from, Maze::tCoord dest);
+
+	/**
+	 * Searches for the destination by building a tree of PathTree nodes
+	 * @param from starting point in the grid.
+	 * @param dest destination of the route.
+	 * @returns the route, empty if the destination is unreachable.
+	 */
+	tRoute findTreeRoute(Maze::tCoord from, Maze::tCoord dest);
+
+	/**
+	 * Searches for the destination breadth first, tracking visited cells
+	 * and their parents in flat arrays indexed by cell.
+	 * @param from starting point in the grid.
+	 * @param dest destination of the route.
+	 * @returns the route, empty if the destination is unreachable.
+	 */
+	tRoute findBfsRoute(Maze::tCoord from, Maze::tCoord dest);
+
+	/**
+	 * Searches breadth first until the first of the destinations is reached
+	 * @param from starting point in the grid.
+	 * @param dests destinations of the route.
+	 * @param dest set to the destination reached.
+	 * @param pBlocked - cells to keep out of, NULL for none
+	 * @returns the route, empty if no destination is reachable.
+	 */
+	tRoute findNearestBfsRoute(Maze::tCoord from, const Maze::tCoords &dests, Maze::tCoord &dest,
+		const Maze::tIndexSet* pBlocked=NULL);
+
+	/**
+	 * Searches for the destination with A*, expanding the cells with the
+	 * shortest estimated route first. The estimate is the manhattan distance
+	 * to the destination, and open cells are kept in buckets by their
+	 * estimated route length instead of a heap.
+	 * @param from starting point in the grid.
+	 * @param dest destination of the route.
+	 * @returns the route, empty if the destination is unreachable.
+	 */
+	tRoute findAStarRoute(Maze::tCoord from, Maze::tCoord dest);
+
+	/**
+	 * Searches breadth first from both the starting point and the
+	 * destination, a level at a time from whichever side has the smaller
+	 * frontier, until the two searches meet.
+	 * @param from starting point in the grid.
+	 * @param dest destination of the route.
+	 * @returns the route, empty if the destination is unreachable.
+	 */
+	tRoute findBidirectionalRoute(Maze::tCoord from, Maze::tCoord dest);
+
+	/**
+	 * Expands every cell in the current level of one side of the
+	 * bidirectional search, stopping early if the other side is reached.
+	 * @param frontier - cells queued by this side
+	 * @param head - position of the first unexpanded cell in the frontier
+	 * @param visited - cells visited by this side
+	 * @param parentDir - direction each cell was reached from by this side
+	 * @param otherVisited - cells visited by the other side
+	 * @returns the cell where the sides met, or -1 if they haven't
+	 */
+	Maze::tIndex expandLevel(std::vector<Maze::tIndex> &frontier, size_t &head, BitLayer &visited,
+		std::vector<unsigned char> &parentDir, BitLayer &otherVisited);
+
+	/**
+	 * Searches for the destination with A* over jump points. Routes are
+	 * kept in a canonical order, moving along the Y axis first, then Z,
+	 * then X, and only turning onto an earlier axis where a wall forces
+	 * it. Straight runs of cells are jumped over without being queued.
+	 * @param from starting point in the grid.
+	 * @param dest destination of the route.
+	 * @returns the route, empty if the destination is unreachable.
+	 */
+	tRoute findJumpPointRoute(Maze::tCoord from, Maze::tCoord dest);
+
+	/**
+	 * Moves from the cell in the direction provided until reaching a jump
+	 * point: the destination, a cell with a forced neighbor, or a cell from
+	 * which a jump along a later axis reaches a jump point.
+	 * @param idx - cell to jump from
+	 * @param dir - direction to jump in
+	 * @param destIdx - destination of the search
+	 * @param steps - set to the number of cells jumped
+	 * @returns the jump point, or -1 if a wall was reached first
+	 */
+	Maze::tIndex jump(Maze::tIndex idx, Maze::eDirection dir, Maze::tIndex destIdx, int &steps);
+
+	/**
+	 * Checks if a cell reached by moving in the direction provided has an
+	 * open neighbor along an earlier axis that the previous cell didn't.
+	 * A canonical route can only turn onto it from this cell.
+	 * @param idx - cell to check
+	 * @param dir - direction the cell was entered in
+	 * @returns true if the cell has a forced neighbor
+	 */
+	bool hasForcedNeighbor(Maze::tIndex idx, Maze::eDirection dir);
+
+	/**
+	 * Builds the route from jump point search results, filling in the
+	 * cells jumped over between each jump point and its parent.
+	 * @param from starting point in the grid.
+	 * @param dest destination of the route, must have been reached.
+	 * @returns the route, not including the starting point.
+	 */
+	tRoute buildJumpPointRoute(Maze::tCoord from, Maze::tCoord dest);
+
+	/**
+	 * Finds the route with D* Lite. The search runs from the destination
+	 * toward the starting point and is kept between calls, so when only the
+	 * starting point moves or a few cells change only the cells whose
+	 * distance to the destination changed are expanded again.
+	 * @param from starting point in the grid.
+	 * @param dest destination of the route.
+	 * @returns the route, empty if the destination is unreachable.
+	 */
+	tRoute findIncrementalRoute(Maze::tCoord from, Maze::tCoord dest);
+
+	/**
+	 * Discards the incremental search state and starts a new search from
+	 * the destination.
+	 * @param from starting point in the grid.
+	 * @param dest destination of the route.
+	 */
+	void resetIncremental(Maze::tCoord from, Maze::tCoord dest);
+
+	/**
+	 * Recalculates the cell's lookahead from its neighbors, and queues
+	 * the cell if it no longer matches the cell's distance.
+	 * @param idx - cell to update
+	 * @param destIdx - destination of the search
+	 */
+	void updateIncremental(Maze::tIndex idx, Maze::tIndex destIdx);
+
+	/**
+	 * Returns the queue key of a cell in the incremental search
+	 * @param idx - cell to key
+	 * @param from - starting point of the route
+	 * @returns key of the cell
+	 */
+	tOpenCell incrementalKey(Maze::tIndex idx, Maze::tCoord from);
+
+	/**
+	 * Picks the dead ends the next search may skip. They are only skipped
+	 * if they were filled since the grid last changed, and no end of the
+	 * route is one of them.
+	 * @param fromIdx - starting point of the route
+	 * @param dests - destinations of the route
+	 */
+	void pruneDeadEnds(Maze::tIndex fromIdx, const Maze::tCoords &dests);
+
+	/**
+	 * Sizes the search scratch space for the grid, and clears the visited cells.
+	 * @param skipDeadEnds - if the dead ends picked by pruneDeadEnds() should
+	 *                       start out visited, so they are never entered
+	 */
+	void resetScratch(bool skipDeadEnds=false);
+
+	/**
+	 * Builds the route by walking the parent directions back from the
+	 * destination until the starting cell is reached.
+	 * @param from starting point in the grid.
+	 * @param dest destination of the route, must have been visited.
+	 * @param route - steps already known past the destination, the route
+	 *                to the destination is added on top of them.
+	 * @returns the route, not including the starting point.
+	 */
+	tRoute buildRoute(Maze::tCoord from, Maze::tCoord dest, tRoute route=tRoute());
 
 	/**
 	 * Iterates over the grid, building the tree starting at the current location.
 	 * The pathfinder's current location and grid are used to generate the tree.
 	 * @param from starting point in the grid.
 	 * @param dest destination the routes are being generated to reach.
-	 * @returns the tree of routes.
+	 * @returns the destination's node in the tree, NULL if it wasn't reached.
 	 */
 	PathTree* generatePathTree(Maze::tCoord from, Maze::tCoord dest);
 
 	/**
-	 * Queues up a new node, while also adding it to the node tree.
+	 * Makes the cell the root of the tree search's tree, pruning every
+	 * branch that doesn't lead from it. Routes through the rest of the
+	 * tree aren't the shortest from the cell, but every route down from
+	 * it is a part of a shortest route from the old root, so is still the
+	 * shortest. The tree is dropped if the cell isn't in it, or the grid
+	 * has changed since it was built.
+	 * @param loc - cell to make the root
+	 */
+	void reRootTree(Maze::tCoord loc);
+
+	/**
+	 * Queues up a new node, while also adding it to the node tree. The cell
+	 * must already be known to not be solid, and is skipped if it is
+	 * already in the tree.
 	 * @param parent node in the tree this is being appened to.
-	 * @param new coord to get get the cell from
+	 * @param loc location of the cell the new node will represent
 	 * @param queye where the node will be added to, if valid
-	 * @returns the node if it was created, and it is not already an ancestor.
+	 * @returns the node if it was created, NULL if the cell is already in the tree.
 	 */
-	PathTree* queueValidNodeAtCoord(PathTree* pParent, Maze::tCoord coord, tTreeNodeQueue &nodeQ);
+	PathTree* queueValidNode(PathTree* pParent, Maze::tCoord loc, tTreeNodeQueue &nodeQ);
 
 };
 
@@ -2,14 +2,16 @@
 #define _PATHTREENODE_HPP_
 
 #include "maze.hpp"
+#include "arena.hpp"
+#include "pathtreeindex.hpp"
 
 #include <vector>
 
 
 class PathTree {
 public:
-	// Defines the list of children in the tree
-	typedef std::vector<PathTree*> tChildren;
+	// Defines the list of children in the tree, kept in the node's arena
+	typedef std::vector<PathTree*, ArenaAllocator<PathTree*> > tChildren;
 	enum eCellMeta {
 		VALID,
 		DEAD_END
@@ -18,24 +20,36 @@ public:
 	/**
 	 * Initializes the node
 	 * @param parent the parent node of this child
-	 * @param c the cell to set the node to represent
+	 * @param loc the location of the cell the node represents
 	 * @param children, list of children to be attached to this node
 	 */
-	PathTree(PathTree* p=NULL, Maze::tCell* c=NULL, tChildren ch=tChildren());
+	PathTree(PathTree* p=NULL, Maze::tCoord loc=Maze::tCoord(), tChildren ch=tChildren());
 
 	/** 
 	 * Takes care of deleting all children nodes still attached to this node
 	 */
 	~PathTree();
 
+	/**
+	 * Creates a node in the arena provided. The node, its children, and
+	 * their lists of children are all freed by releasing the arena, and
+	 * must never be deleted.
+	 * @param pArena - arena to allocate from, NULL to create the node with new
+	 * @param p - the parent node of this child
+	 * @param loc - the location of the cell the node represents
+	 * @returns the new node
+	 */
+	static PathTree* create(Arena* pArena, PathTree* p=NULL, Maze::tCoord loc=Maze::tCoord());
+
 	/**
 	 * Appends a cell to this node as a child if it is not already
 	 * an ancestor of this node. It also makes sure that the cell adding
-	 * is not the same as this node's cell.
-	 * @param the cell to add as a child to this node
+	 * is not the same as this node's cell. The child is created in the
+	 * same arena as this node.
+	 * @param the location of the cell to add as a child to this node
 	 * @returns the newly added child.
 	 */
-	PathTree* addChild(Maze::tCell* pChild);
+	PathTree* addChild(Maze::tCoord loc);
 
 	/**
 	 * Appends a new node to this node as a child
@@ -46,12 +60,14 @@ public:
 
 	/**
 	 * Removes the parent reference from this node
-	 * while also removing it from the parent's child list
+	 * while also removing it from the parent's child list.
+	 * The node and its descendants are removed from the tree's index.
 	 */
 	void detach();
 
 	/**
-	 * Removes the specified child from its parent's list of children
+	 * Removes the specified child from its parent's list of children.
+	 * The child and its descendants are removed from the tree's index.
 	 * @param child node to deref
 	 */
 	void removeChild(PathTree* pChild);
@@ -72,54 +88,44 @@ public:
 	 */
 	PathTree* getRoot();
 
-	/**
-	 * returns the child cell specified as a child using breath first search
-	 * @param child node being serached for.
-	 * @returns the child if found, null otherwise
- 	 */
-	PathTree* getNode(Maze::tCell cell);
-
 	/**
 	 * Searchs through the tree looking for the node containing the coord
-	 * using breath first search.
+	 * using breath first search. The root of an indexed tree looks the
+	 * node up in the index instead.
 	 * @param coord the location of the cell we're looking for
 	 * @returns the node if found.
 	 */
 	PathTree* getNode(Maze::tCoord coord);
 
+	/**
+	 * Indexes every node of the tree this node is in, and the nodes added
+	 * to it from then on. Nodes leave the index when they are removed from
+	 * the tree or deleted.
+	 * @param pIndex - index to add the nodes to, not owned. NULL to remove
+	 *                 the nodes from the index they are in.
+	 */
+	void setIndex(PathTreeIndex* pIndex);
+
+	/**
+	 * Returns the index of the tree the node is in, NULL if it isn't indexed
+	 */
+	PathTreeIndex* getIndex() { return m_pIndex; }
+
 	/*
 	 * Searches up the tree looking if the cell specified already exists
 	 * as a parent to the node provided.
-	 * @param cell to search for
+	 * @param loc location of the cell to search for
 	 * @returns if the cell was found as an ancestor
 	 */
-	bool hasAncestor(Maze::tCell cell);
+	bool hasAncestor(Maze::tCoord loc);
 
 	/**
 	 * Searches the children of the parent node to makesure
 	 * this cell doesn't exist as a sibling
-	 * @param cell to search for
+	 * @param loc location of the cell to search for
 	 * @returns true if this cell exists as a sibling
 	 */
-	bool hasSibling(Maze::tCell cell);
-
-	/**
-	 * Compares this Node if contains the cell provided
-	 * @param cell to compare the coordinates against
-	 * @returns true if same coordinates
-	 */
-	bool operator==(const Maze::tCell cell) {
-		return (m_cell->coord == cell.coord);
-	}
-
-	/**
-	 * Compares this Node is not the same as the cell provided
-	 * @param cell to compare the coordinates against
-	 * @returns true if different coordinates
-	 */
-	bool operator!=(const Maze::tCell cell) {
-		return (m_cell->coord != cell.coord);
-	}
+	bool hasSibling(Maze::tCoord loc);
 
 	/**
 	 * Compares this Node is the same as the coord provided
@@ -127,7 +133,7 @@ public:
 	 * @returns true if same coordinates
 	 */
 	bool operator==(const Maze::tCoord coord) {
-		return (m_cell->coord == coord);
+		return (m_loc == coord);
 	}
 
 	/**
@@ -136,7 +142,7 @@ public:
 	 * @returns true if same coordinates
 	 */
 	bool operator!=(const Maze::tCoord coord) {
-		return (m_cell->coord != coord);
+		return (m_loc != coord);
 	}
 
 	/**
@@ -163,23 +169,38 @@ public:
 	eCellMeta getMeta() { return m_meta; }
 
 	/**
-	 * Returns the cell pointed to by this node
-	 * @returns cell refernce
+	 * returns the location in the grid of the cell contained at this node
+	 * @returns coordinate of the cell in the grid
 	 */
-	Maze::tCell* getCell() { return m_cell; }
+	Maze::tCoord getLoc() { return m_loc; }
 
 	/**
-	 * returns the location in the grid of the cell contained at this node
-	 * @returns coordinate of the cell in the grid
+	 * Returns the arena the node was created in, NULL if it was created with new
 	 */
-	Maze::tCoord getLoc() { return m_cell->coord; }
+	Arena* getArena() { return m_pArena; }
 
 private:
-	Maze::tCell* m_cell;
+	Maze::tCoord m_loc;
 	eCellMeta m_meta;
+	Arena* m_pArena;
+	PathTreeIndex* m_pIndex;
 
 	PathTree* m_parent;
 	tChildren m_children;
+
+	/**
+	 * Removes the child from this node's list of children, leaving the
+	 * child's parent and index as they are.
+	 * @param pChild - node to unlink
+	 * @returns true if the node was a child of this node
+	 */
+	bool unlinkChild(PathTree* pChild);
+
+	/**
+	 * Moves this node and its descendants to the index provided
+	 * @param pIndex - index to add the nodes to, NULL for none
+	 */
+	void indexSubtree(PathTreeIndex* pIndex);
 };
 
 #endif // !defined (_PATHTREENODE_HPP_)
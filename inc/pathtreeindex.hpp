@@ -0,0 +1,124 @@
+#ifndef _PATHTREEINDEX_HPP_
+#define _PATHTREEINDEX_HPP_
+
+#include "maze.hpp"
+
+#include <map>
+#include <vector>
+
+class PathTree;
+
+/**
+ * Index of the nodes of a PathTree by the coordinate of their cell, so a
+ * node can be found without searching the tree. The tree keeps the index
+ * up to date as nodes are added and removed, see PathTree::setIndex().
+ *
+ * Coordinates within the dimension the index is made for are kept in a
+ * flat array, with a slot per cell of the grid. Each slot is stamped with
+ * the generation it was set in, so clear() doesn't touch the array. Any
+ * other coordinates are kept in a map, which is all an index made without
+ * a dimension uses.
+ *
+ * A tree may hold the same cell on more than one branch. Only the first
+ * node of a cell is kept in its slot, the rest are just counted so lookups
+ * know when the index can't answer on its own.
+ */
+class PathTreeIndex {
+public:
+	/**
+	 * Initializes an index of coordinates kept in a map, for trees that
+	 * only cover a few cells of a large grid.
+	 */
+	PathTreeIndex();
+
+	/**
+	 * Initializes an index with a slot for every cell of the dimension
+	 * @param dim - size of the grid the tree's cells are in
+	 */
+	PathTreeIndex(Maze::tDimension dim);
+
+	/**
+	 * Removes every node from the index, and resizes it for the dimension.
+	 * Nodes that were in the index must not be removed from it afterwards.
+	 * @param dim - size of the grid, 0 in any direction to only use the map
+	 */
+	void reset(Maze::tDimension dim);
+
+	/**
+	 * Removes every node from the index. Nodes that were in the index must
+	 * not be removed from it afterwards, so this is meant for when their
+	 * tree has been freed all at once.
+	 */
+	void clear();
+
+	/**
+	 * Adds a node to the index under its cell
+	 * @param pNode - node to add
+	 */
+	void add(PathTree* pNode);
+
+	/**
+	 * Removes a node from the index
+	 * @param pNode - node to remove, must be in the index
+	 */
+	void remove(PathTree* pNode);
+
+	/**
+	 * Returns the node of the cell
+	 * @param loc - coordinate of the cell
+	 * @returns the node, NULL if the index doesn't hold one
+	 */
+	PathTree* find(Maze::tCoord loc);
+
+	/**
+	 * Returns if a cell can have a node that isn't in the index, because
+	 * more than one node of a cell was added.
+	 */
+	bool hasDuplicates() { return m_duplicates > 0; }
+
+	/**
+	 * Returns the number of nodes in the index, including duplicates
+	 */
+	long size() { return m_size; }
+
+	/**
+	 * Returns the size of the grid the index has a slot per cell for
+	 */
+	Maze::tDimension getDim() { return m_dim; }
+
+private:
+	// Orders coordinates for the map
+	struct tCoordLess {
+		bool operator()(const Maze::tCoord &a, const Maze::tCoord &b) const {
+			if (a.z != b.z) { return a.z < b.z; }
+			if (a.y != b.y) { return a.y < b.y; }
+			return a.x < b.x;
+		}
+	};
+	typedef std::map<Maze::tCoord, PathTree*, tCoordLess> tNodeMap;
+
+	Maze::tDimension m_dim;
+	// Node of each cell by slot, only set if its stamp is the current generation
+	std::vector<PathTree*> m_slots;
+	std::vector<unsigned int> m_stamps;
+	unsigned int m_generation;
+	// Nodes of cells outside of the dimension
+	tNodeMap m_sparse;
+
+	long m_size;
+	// Nodes added for cells that already had one
+	long m_duplicates;
+
+	/**
+	 * Returns the slot of the cell
+	 * @param loc - coordinate of the cell
+	 * @returns the slot, -1 if the cell is kept in the map
+	 */
+	long slot(const Maze::tCoord &loc) {
+		if (loc.x < 0 || loc.y < 0 || loc.z < 0 ||
+			loc.x >= m_dim.width || loc.y >= m_dim.height || loc.z >= m_dim.depth) { return -1; }
+		return loc.x + (long)m_dim.width * (loc.y + (long)m_dim.height * loc.z);
+	}
+};
+
+#endif // !defined(_PATHTREEINDEX_HPP_)
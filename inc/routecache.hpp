@@ -0,0 +1,113 @@
+#ifndef _ROUTECACHE_HPP_
+#define _ROUTECACHE_HPP_
+
+#include "maze.hpp"
+
+#include <list>
+#include <stack>
+#include <vector>
+
+/**
+ * Least recently used cache of routes found in a grid, keyed by the
+ * route's starting point, destination, and the search used to find it.
+ * Routes are only valid for the version of the grid they were found in,
+ * the whole cache is emptied the first time it is used after a cell is
+ * opened or walled off. Unreachable destinations are cached as empty routes.
+ */
+class RouteCache {
+public:
+	// Route that should be used, same as PathFind::tRoute
+	typedef std::stack<Maze::tCoord> tRoute;
+
+	/**
+	 * Initializes an empty cache for the grid
+	 * @param pGrid - grid the routes are found in, must outlive the cache
+	 * @param capacity - most routes kept, the least recently used are dropped
+	 */
+	RouteCache(Maze::tGrid* pGrid, size_t capacity=1024);
+
+	/**
+	 * Looks up a route, counting a hit or a miss
+	 * @param strategy - search the route is found with
+	 * @param from - grid index of the starting point
+	 * @param dest - grid index of the destination
+	 * @param route - set to the cached route on a hit
+	 * @returns true if the route was cached
+	 */
+	bool lookup(int strategy, Maze::tIndex from, Maze::tIndex dest, tRoute &route);
+
+	/**
+	 * Adds a route to the cache, dropping the least recently used if full
+	 * @param strategy - search the route was found with
+	 * @param from - grid index of the starting point
+	 * @param dest - grid index of the destination
+	 * @param route - route found, empty if the destination is unreachable
+	 */
+	void store(int strategy, Maze::tIndex from, Maze::tIndex dest, const tRoute &route);
+
+	/**
+	 * Drops every cached route. The hit and miss counts are kept.
+	 */
+	void clear();
+
+	/**
+	 * Returns the grid the routes are found in
+	 */
+	Maze::tGrid* getGrid() { return m_pGrid; }
+
+	/**
+	 * Returns the number of routes cached
+	 */
+	size_t size() { return m_lru.size(); }
+
+	/**
+	 * Returns the number of lookups that found a route
+	 */
+	long getHits() { return m_hits; }
+
+	/**
+	 * Returns the number of lookups that didn't find a route
+	 */
+	long getMisses() { return m_misses; }
+
+	/**
+	 * Returns the number of times the cache was emptied because the grid changed
+	 */
+	long getInvalidations() { return m_invalidations; }
+
+private:
+	// Cached route and the key it was found with
+	struct tEntry {
+		int strategy;
+		Maze::tIndex from;
+		Maze::tIndex dest;
+		tRoute route;
+	};
+	typedef std::list<tEntry> tEntries;
+
+	Maze::tGrid* m_pGrid;
+	size_t m_capacity;
+	// Version of the grid the cached routes were found in
+	unsigned long m_version;
+
+	// Entries ordered from most to least recently used
+	tEntries m_lru;
+	// Entries by the hash of their key, a power of two buckets
+	std::vector< std::vector<tEntries::iterator> > m_buckets;
+
+	long m_hits;
+	long m_misses;
+	long m_invalidations;
+
+	/**
+	 * Empties the cache if the grid has changed since the routes were found
+	 */
+	void checkVersion();
+
+	/**
+	 * Returns the bucket a key belongs in
+	 */
+	std::vector<tEntries::iterator> &bucket(int strategy, Maze::tIndex from, Maze::tIndex dest);
+};
+
+#endif // !defined(_ROUTECACHE_HPP_)
@@ -0,0 +1,125 @@
+#ifndef _WAVEFRONT_HPP_
+#define _WAVEFRONT_HPP_
+
+#include "maze.hpp"
+#include "bitlayer.hpp"
+
+#include <vector>
+
+/**
+ * Breadth first flood that keeps the frontier and visited cells as packed
+ * bits, and expands a whole word of cells at a time. In the linear layout
+ * the neighbors of every cell are a fixed number of bits away, so each
+ * level is the frontier shifted by the six neighbor offsets, ORed together
+ * and ANDed with the open cells not yet visited. The grid's solid border
+ * stops bits shifted off the end of a row from reaching the next one.
+ *
+ * Words are processed in vectors of four, which the compiler maps to AVX2
+ * or SSE2 registers when the target has them.
+ *
+ * Only grids with the linear layout are supported. Each level costs a pass
+ * over the words between the frontier's first and last cell, so the flood
+ * is best suited to open mazes with few, wide levels.
+ */
+class WaveFront {
+public:
+	/**
+	 * Initializes the flood for the grid
+	 * @param pGrid - grid of the maze, must outlive the flood
+	 */
+	WaveFront(Maze::tGrid* pGrid);
+
+	/**
+	 * Returns if the grid's layout can be flooded
+	 */
+	bool isSupported() { return m_pGrid->layout == Maze::LAYOUT_LINEAR; }
+
+	/**
+	 * Floods out from the cell until every reachable cell is visited
+	 * @param from - cell to flood from
+	 * @returns number of cells reached, including the first. 0 if the
+	 *          cell is solid or the grid isn't supported.
+	 */
+	long flood(Maze::tCoord from);
+
+	/**
+	 * Floods out from the cell until the destination is reached
+	 * @param from - cell to flood from
+	 * @param dest - cell to measure to
+	 * @returns steps between the cells, -1 if the destination can't be reached
+	 */
+	int distance(Maze::tCoord from, Maze::tCoord dest);
+
+	/**
+	 * Floods out from the cell, recording the level each cell is reached at
+	 * @param from - cell to flood from
+	 * @param dist - set to the steps to each cell by grid index, -1 for
+	 *               cells that aren't reached
+	 */
+	void distances(Maze::tCoord from, std::vector<int> &dist);
+
+	/**
+	 * Returns if the cell was reached by the last flood
+	 * @param loc - cell to check
+	 */
+	bool isReached(Maze::tCoord loc);
+
+	/**
+	 * Returns the number of levels expanded by the last flood
+	 */
+	int getLevels() { return m_levels; }
+
+private:
+	typedef BitLayer::tWord tWord;
+
+	// Words processed together by the vector loop
+	static const int VECTOR_WORDS = 4;
+
+	Maze::tGrid* m_pGrid;
+	int m_levels;
+
+	// Open cells of the grid as of the grid's version when they were found
+	unsigned long m_openVersion;
+	bool m_openValid;
+
+	// Words before the first word of the grid in every layer. The padding
+	// is all zero, so shifted words can be read past the grid's ends
+	// without bounds checks.
+	long m_pad;
+	// Number of words covering the grid, rounded up to whole vectors
+	long m_numWords;
+	// Neighbor offsets in whole words and remaining bits, by direction
+	long m_wordShift[Maze::NUM_DIRECTIONS];
+	int m_bitShift[Maze::NUM_DIRECTIONS];
+
+	// Padded layers of packed bits, one per cell in grid index order
+	std::vector<tWord> m_open;
+	std::vector<tWord> m_visited;
+	std::vector<tWord> m_frontier;
+	std::vector<tWord> m_next;
+
+	/**
+	 * Sizes the layers for the grid and finds its open cells, if the grid
+	 * has changed since they were last found.
+	 */
+	void snapshotOpen();
+
+	/**
+	 * Clears the visited cells and starts the frontier at the cell
+	 * @param idx - grid index of the first cell, must be open
+	 * @param first - set to the first word of the frontier
+	 * @param last - set to one past the last word of the frontier
+	 */
+	void start(Maze::tIndex idx, long &first, long &last);
+
+	/**
+	 * Expands the frontier a level, leaving only the newly reached cells
+	 * in it and marking them visited.
+	 * @param first - first word of the frontier, updated for the new one
+	 * @param last - one past the last word of the frontier, updated for the new one
+	 * @returns false if no new cells were reached
+	 */
+	bool expand(long &first, long &last);
+};
+
+#endif // !defined(_WAVEFRONT_HPP_)
@@ -0,0 +1,62 @@
+#include "arena.hpp"
+
+#include <stdlib.h>
+
+using namespace std;
+
+/**
+ * Initializes the arena, no memory is allocated until it is needed
+ */
+Arena::Arena(): m_block(0), m_offset(0), m_used(0), m_reserved(0) {}
+
+/**
+ * Frees all blocks of the arena
+ */
+Arena::~Arena() {
+	vector<char*>::iterator it;
+	for (it = m_blocks.begin(); it != m_blocks.end(); it++) {
+		free(*it);
+	}
+	m_blocks.clear();
+	m_blockSizes.clear();
+}
+
+/**
+ * Allocates memory aligned for any type, that stays valid until the
+ * arena is released.
+ * @param bytes - number of bytes to allocate
+ * @returns the memory allocated
+ */
+void* Arena::allocate(size_t bytes) {
+	bytes = (bytes + ALIGN - 1) / ALIGN * ALIGN;
+
+	// Move on to the first block after the current one with room, keeping
+	// any skipped space for the next time the arena is filled.
+	while (m_block < m_blocks.size() && m_offset + bytes > m_blockSizes[m_block]) {
+		m_block++;
+		m_offset = 0;
+	}
+	if (m_block == m_blocks.size()) {
+		size_t size = (bytes > BLOCK_SIZE) ? bytes : BLOCK_SIZE;
+		char* pBlock = (char*)malloc(size);
+		if (pBlock == NULL) { throw bad_alloc(); }
+		m_blocks.push_back(pBlock);
+		m_blockSizes.push_back(size);
+		m_reserved += size;
+	}
+
+	void* pMem = m_blocks[m_block] + m_offset;
+	m_offset += bytes;
+	m_used += bytes;
+	return pMem;
+}
+
+/**
+ * Frees everything allocated from the arena at once. The blocks are
+ * kept to allocate from again.
+ */
+void Arena::release() {
+	m_block = 0;
+	m_offset = 0;
+	m_used = 0;
+}
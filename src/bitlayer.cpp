@@ -0,0 +1,79 @@
+#include "bitlayer.hpp"
+
+using namespace std;
+
+/**
+ * Initializes the layer with the number of bits provided
+ * @param size - number of bits in the layer
+ * @param value - initial value of all bits
+ */
+BitLayer::BitLayer(tIndex size, bool value): m_size(0) {
+	reset(size, value);
+}
+
+/**
+ * Resizes the layer, all bits will be reset to the value provided
+ * @param size - number of bits in the layer
+ * @param value - value of all bits
+ */
+void BitLayer::reset(tIndex size, bool value) {
+	m_size = size;
+	m_words.assign((size + WORD_BITS - 1) / WORD_BITS, value ? ~(tWord)0 : 0);
+	trimLastWord();
+}
+
+/**
+ * Sets all bits in the layer to the value provided
+ * @param value - value of all bits
+ */
+void BitLayer::fill(bool value) {
+	m_words.assign(m_words.size(), value ? ~(tWord)0 : 0);
+	trimLastWord();
+}
+
+/**
+ * Returns up to 64 consecutive bits starting at the index. The first
+ * bit will be the lowest bit of the returned word.
+ * @param idx - position of the first bit
+ * @param count - number of bits to read, between 1 and 64
+ * @returns the bits read
+ */
+BitLayer::tWord BitLayer::bits(tIndex idx, int count) const {
+	tIndex w = idx / WORD_BITS;
+	int shift = idx % WORD_BITS;
+
+	tWord value = m_words[w] >> shift;
+	// Pull in the rest of the bits from the next word if the run spans two words
+	if (shift != 0 && shift + count > WORD_BITS && w + 1 < (tIndex)m_words.size()) {
+		value |= m_words[w + 1] << (WORD_BITS - shift);
+	}
+
+	if (count < WORD_BITS) {
+		value &= ((tWord)1 << count) - 1;
+	}
+	return value;
+}
+
+/**
+ * Returns the number of bits set in the layer
+ * @returns number of set bits
+ */
+BitLayer::tIndex BitLayer::count() const {
+	tIndex total = 0;
+	vector<tWord>::const_iterator cIt;
+	for (cIt = m_words.begin(); cIt != m_words.end(); cIt++) {
+		total += __builtin_popcountll(*cIt);
+	}
+	return total;
+}
+
+/**
+ * Clears the unused bits of the last word so that word wide
+ * operations do not see bits outside of the layer.
+ */
+void BitLayer::trimLastWord() {
+	int used = m_size % WORD_BITS;
+	if (used != 0 && !m_words.empty()) {
+		m_words.back() &= ((tWord)1 << used) - 1;
+	}
+}
@@ -9,7 +9,7 @@ using namespace std;
  * @param the maze the bot will be using to travel through
  * @param current location of the bot in the grid.
  */
-Bot::Bot(Maze* pMaze, Maze::tCoord loc): m_pMaze(pMaze), m_curLoc(loc) {
+Bot::Bot(Maze* pMaze, Maze::tCoord loc): m_curLoc(loc), m_pMaze(pMaze), m_route(loc), m_routeUsed(loc), m_blockedTurns(0) {
 	m_pathfinder.setGrid(pMaze->getGrid());
 	m_pathfinder.setLoc(m_curLoc);
 }
@@ -18,16 +18,56 @@ Bot::Bot(Maze* pMaze, Maze::tCoord loc): m_pMaze(pMaze), m_curLoc(loc) {
  * Attempts to find a rout from the bot's current location
  * to the coordinate specified. Using the grid to naviage through
  * @param dest - Coordinate of the destination
+ * @param strategy - search algorithm used to find the route
  * @returns true if a route can be found,false otherwise.
  */
-bool Bot::calcRoute(Maze::tCoord dest) {
+bool Bot::calcRoute(Maze::tCoord dest, PathFind::eStrategy strategy) {
 	m_destLoc = dest;
+	m_dests.clear();
+	m_pathfinder.setStrategy(strategy);
+
+	// Don't search the whole area around the bot for an exit outside of it
+	if (!m_pMaze->isReachable(m_curLoc, dest)) {
+		return false;
+	}
+
 	PathFind::tRoute route = m_pathfinder.findRoute(dest);
 	if (route.empty()) {
 		return false;
 	}
 
-	m_route = route;
+	m_route = PackedRoute(m_curLoc, route);
+	return true;
+}
+
+/**
+ * Attempts to find a route from the bot's current location to the
+ * nearest of the destinations. If the route is later walled off the
+ * bot heads for whichever destination is then nearest.
+ * @param dests - Coordinates of the destinations
+ * @param strategy - search algorithm used to find the route
+ * @returns true if a route can be found,false otherwise.
+ */
+bool Bot::calcNearestRoute(const Maze::tCoords &dests, PathFind::eStrategy strategy) {
+	m_dests = dests;
+	m_pathfinder.setStrategy(strategy);
+
+	// Don't search the whole area around the bot when every exit is outside of it
+	bool reachable = false;
+	Maze::tCoords::const_iterator cIt;
+	for (cIt = dests.begin(); cIt != dests.end() && !reachable; cIt++) {
+		reachable = m_pMaze->isReachable(m_curLoc, *cIt);
+	}
+	if (!reachable) {
+		return false;
+	}
+
+	PathFind::tRoute route = m_pathfinder.findNearestRoute(dests, m_destLoc);
+	if (route.empty()) {
+		return false;
+	}
+
+	m_route = PackedRoute(m_curLoc, route);
 	return true;
 }
 
@@ -37,49 +77,80 @@ bool Bot::calcRoute(Maze::tCoord dest) {
  * @returns string of the route used. "N,S,E,W,U,D";
  */
 string Bot::getRouteUsed() {
-	vector<char>::const_iterator cIt;
-	string routeUsed;
-	for (cIt=m_routeUsed.begin(); cIt != m_routeUsed.end(); cIt++) {
-		routeUsed += (char)*cIt;
-	}
-
-	return routeUsed;
+	return m_routeUsed.String();
 }
 
 /**
  * Moves the bot one step along the route that was calculated 
- * earlier with calcRoute().
+ * earlier with calcRoute(). If the next cell has been walled off
+ * a new route is found instead of moving. If it has been occupied
+ * for MAX_BLOCKED_TURNS rounds, a route around it is found instead.
  * @returns if the bot moved.
  */
 bool Bot::move() {
-	if (m_route.empty()) {
+	if (m_route.done()) {
 		return false;
 	}
 
-	Maze::tCell* cell = m_route.top();
-	// Make sure we are actually moving
-	if (cell->coord == m_curLoc) {
-		m_route.pop();
+	Maze::tCoord next = m_route.next();
+
+	// Make sure our next destination is valid
+	Maze::eCell state = m_pMaze->getState(next);
+	if (state == Maze::CELL_SOLID) {
+		// The route has been walled off since it was found, find a way
+		// around. If there is none the old route is kept, and we'll
+		// look again next round. The pathfinder is asked directly since
+		// labeling the maze's areas again after a wall is added would cost
+		// more than an incremental search's repair.
+		PathFind::tRoute route;
+		if (m_dests.empty()) {
+			route = m_pathfinder.findRoute(m_destLoc);
+		} else {
+			Maze::tCoord dest;
+			route = m_pathfinder.findNearestRoute(m_dests, dest);
+			if (!route.empty()) { m_destLoc = dest; }
+		}
+		if (!route.empty()) {
+			m_route = PackedRoute(m_curLoc, route);
+		}
 		return false;
 	}
+	if (state == Maze::CELL_OCCUPIED) {
+		// The route cursor isn't advanced, so we'll try this cell again
+		// next round. Entities facing each other would wait on each other
+		// forever though, so after a few rounds look for a way around the
+		// cell. If there is none keep waiting, the cell may yet be left.
+		if (++m_blockedTurns < MAX_BLOCKED_TURNS) {
+			return false;
+		}
 
-	// Make sure our next destination is valid
-	if (cell->state == Maze::CELL_SOLID || cell->state == Maze::CELL_OCCUPIED) {
-		// No need to pop the stack here since we'll be trying this cell again next round.
+		Maze::tIndexSet blocked;
+		blocked.insert(m_pMaze->getGrid()->index(next));
+		Maze::tCoords dests = m_dests.empty() ? Maze::tCoords(1, m_destLoc) : m_dests;
+		Maze::tCoord dest;
+		PathFind::tRoute route = m_pathfinder.findDetour(dests, blocked, dest);
+		if (!route.empty()) {
+			m_route = PackedRoute(m_curLoc, route);
+			m_destLoc = dest;
+			m_blockedTurns = 0;
+		}
 		return false;
 	}
+	m_blockedTurns = 0;
 
 	// Keep track of our current route
-	m_routeUsed.push_back(m_curLoc.direction(cell->coord));
+	m_routeUsed.append(m_route.nextDirection());
 
-	// Update the cells to our position in the maze, don't reset the exit cell' state
-	if (cell->state != Maze::CELL_EXIT) {
-		m_pMaze->updateCell(cell->coord, Maze::CELL_OCCUPIED);
+	// Move our occupancy to our new position in the maze, the exit is not
+	// occupied since we'll be leaving the maze through it.
+	if (state != Maze::CELL_EXIT) {
+		m_pMaze->occupy(next);
 	}
-	m_pMaze->updateCell(m_curLoc, Maze::CELL_EMPTY);
+	m_pMaze->vacate(m_curLoc);
 
-	m_curLoc = cell->coord;
+	m_curLoc = next;
+	m_pathfinder.setLoc(m_curLoc);
 
-	m_route.pop();
+	m_route.advance();
 	return true;
 }
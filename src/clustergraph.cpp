@@ -0,0 +1,443 @@
+#include "clustergraph.hpp"
+
+#include <stdlib.h>
+#include <algorithm>
+#include <queue>
+#include <functional>
+
+using namespace std;
+
+/**
+ * Initializes the graph for the grid, build() must be called before
+ * any route can be found.
+ * @param pGrid - grid of the maze, must outlive the graph
+ * @param clusterSize - number of cells along each edge of a cluster
+ */
+ClusterGraph::ClusterGraph(Maze::tGrid* pGrid, int clusterSize):
+	m_pGrid(pGrid), m_clusterSize(clusterSize), m_built(false), m_version(0), m_search(0), m_expanded(0) {
+	Maze::tDimension dim = m_pGrid->dim;
+	m_numClusters = Maze::tDimension((dim.width + clusterSize - 1) / clusterSize,
+		(dim.height + clusterSize - 1) / clusterSize, (dim.depth + clusterSize - 1) / clusterSize);
+}
+
+/**
+ * Finds the portals between the clusters, and the distances between
+ * the portals of each cluster. Must be called again if the grid's
+ * walls change.
+ */
+void ClusterGraph::build() {
+	int numClusters = getNumClusters();
+	m_portals.clear();
+	m_clusterPortals.assign(numClusters, vector<int>());
+	m_portalAt.clear();
+
+	for (int cluster=0; cluster < numClusters; cluster++) {
+		addEntrances(cluster, Maze::DIR_EAST);
+		addEntrances(cluster, Maze::DIR_UP);
+		addEntrances(cluster, Maze::DIR_SOUTH);
+	}
+	// Only needed to merge the portals of entrances sharing a cell
+	m_portalAt.clear();
+
+	// Connect each pair of portals in a cluster that can reach each other
+	for (int cluster=0; cluster < numClusters; cluster++) {
+		vector<int> &portals = m_clusterPortals[cluster];
+		for (size_t i=0; i < portals.size(); i++) {
+			searchCluster(cluster, m_portals[portals[i]].loc);
+			for (size_t j=i + 1; j < portals.size(); j++) {
+				int dist = localDist(m_portals[portals[j]].loc);
+				if (dist >= 0) {
+					m_portals[portals[i]].edges.push_back(tEdge(portals[j], dist));
+					m_portals[portals[j]].edges.push_back(tEdge(portals[i], dist));
+				}
+			}
+		}
+	}
+
+	// Room for the start and destination of a route after the portals
+	m_cost.assign(m_portals.size() + 2, 0);
+	m_parent.assign(m_portals.size() + 2, -1);
+	m_stamp.assign(m_portals.size() + 2, 0);
+	m_search = 0;
+	m_built = true;
+	m_version = m_pGrid->version;
+}
+
+/**
+ * Returns the number of edges between portals found by build()
+ */
+long ClusterGraph::getNumEdges() {
+	long edges = 0;
+	vector<tPortal>::const_iterator cIt;
+	for (cIt = m_portals.begin(); cIt != m_portals.end(); cIt++) {
+		edges += (*cIt).edges.size();
+	}
+	return edges;
+}
+
+/**
+ * Finds a route through the portal graph, and fills in the cells of
+ * the route in each cluster it passes through.
+ * @param from - starting point of the route
+ * @param dest - destination of the route
+ * @returns the route, not including the starting point. Empty if the
+ *          destination is unreachable.
+ */
+ClusterGraph::tRoute ClusterGraph::findRoute(Maze::tCoord from, Maze::tCoord dest) {
+	tRoute route;
+	m_expanded = 0;
+
+	if (!m_built || from == dest) { return route; }
+	if (!m_pGrid->contains(from) || !m_pGrid->contains(dest)) { return route; }
+	if (!m_pGrid->isOpen(m_pGrid->index(from)) || !m_pGrid->isOpen(m_pGrid->index(dest))) { return route; }
+
+	// The start and destination are added to the graph as the two nodes
+	// after the portals, connected to the portals of their clusters.
+	int startNode = m_portals.size();
+	int destNode = startNode + 1;
+	int startCluster = clusterOf(from);
+	int destCluster = clusterOf(dest);
+
+	vector<tEdge> destEdges;
+	searchCluster(destCluster, dest);
+	vector<int>::const_iterator cIt;
+	for (cIt = m_clusterPortals[destCluster].begin(); cIt != m_clusterPortals[destCluster].end(); cIt++) {
+		int dist = localDist(m_portals[*cIt].loc);
+		if (dist >= 0) { destEdges.push_back(tEdge(*cIt, dist)); }
+	}
+
+	vector<tEdge> startEdges;
+	searchCluster(startCluster, from);
+	for (cIt = m_clusterPortals[startCluster].begin(); cIt != m_clusterPortals[startCluster].end(); cIt++) {
+		int dist = localDist(m_portals[*cIt].loc);
+		if (dist >= 0) { startEdges.push_back(tEdge(*cIt, dist)); }
+	}
+	if (startCluster == destCluster && localDist(dest) >= 0) {
+		startEdges.push_back(tEdge(destNode, localDist(dest)));
+	}
+
+	// Start a new search, only resetting the stamps when they wrap around
+	if (++m_search == 0) {
+		m_stamp.assign(m_stamp.size(), 0);
+		m_search = 1;
+	}
+
+	// A* over the portal graph, ordered by the estimated route length
+	typedef pair<int, int> tQueued;
+	priority_queue<tQueued, vector<tQueued>, greater<tQueued> > openQ;
+	m_stamp[startNode] = m_search;
+	m_cost[startNode] = 0;
+	m_parent[startNode] = -1;
+	openQ.push(tQueued(from.distance(dest), startNode));
+
+	bool found = false;
+	while (!openQ.empty()) {
+		tQueued top = openQ.top();
+		openQ.pop();
+
+		int node = top.second;
+		if (node == destNode) {
+			found = true;
+			break;
+		}
+		Maze::tCoord loc = (node == startNode) ? from : m_portals[node].loc;
+		if (m_cost[node] + loc.distance(dest) != top.first) { continue; }
+		m_expanded++;
+
+		const vector<tEdge> &edges = (node == startNode) ? startEdges : m_portals[node].edges;
+		vector<tEdge>::const_iterator eIt;
+		for (eIt = edges.begin(); eIt != edges.end(); eIt++) {
+			int to = (*eIt).to;
+			int cost = m_cost[node] + (*eIt).cost;
+			if (m_stamp[to] == m_search && m_cost[to] <= cost) { continue; }
+
+			m_stamp[to] = m_search;
+			m_cost[to] = cost;
+			m_parent[to] = node;
+			Maze::tCoord toLoc = (to == destNode) ? dest : m_portals[to].loc;
+			openQ.push(tQueued(cost + toLoc.distance(dest), to));
+		}
+
+		// Portals in the destination's cluster connect to the destination
+		if (node != startNode && m_portals[node].cluster == destCluster) {
+			for (eIt = destEdges.begin(); eIt != destEdges.end(); eIt++) {
+				if ((*eIt).to != node) { continue; }
+
+				int cost = m_cost[node] + (*eIt).cost;
+				if (m_stamp[destNode] == m_search && m_cost[destNode] <= cost) { break; }
+				m_stamp[destNode] = m_search;
+				m_cost[destNode] = cost;
+				m_parent[destNode] = node;
+				openQ.push(tQueued(cost, destNode));
+				break;
+			}
+		}
+	}
+	if (!found) { return route; }
+
+	// Walk back through the portals, then fill in the cells between them
+	vector<Maze::tCoord> portals;
+	for (int node = m_parent[destNode]; node != startNode; node = m_parent[node]) {
+		portals.push_back(m_portals[node].loc);
+	}
+
+	vector<Maze::tCoord> cells;
+	Maze::tCoord cur = from;
+	portals.insert(portals.begin(), dest);
+	vector<Maze::tCoord>::reverse_iterator rIt;
+	for (rIt = portals.rbegin(); rIt != portals.rend(); rIt++) {
+		Maze::tCoord next = *rIt;
+		if (clusterOf(cur) != clusterOf(next)) {
+			// Portals of neighboring clusters are next to each other
+			cells.push_back(next);
+		} else {
+			refine(clusterOf(cur), cur, next, cells);
+		}
+		cur = next;
+	}
+
+	for (rIt = cells.rbegin(); rIt != cells.rend(); rIt++) {
+		route.push(*rIt);
+	}
+	return route;
+}
+
+/**
+ * Returns the id of the cluster the coordinate is in
+ * @param coord - coordinate in the maze
+ * @returns cluster id
+ */
+int ClusterGraph::clusterOf(Maze::tCoord coord) {
+	int cx = coord.x / m_clusterSize;
+	int cy = coord.y / m_clusterSize;
+	int cz = coord.z / m_clusterSize;
+	return (cx * m_numClusters.height + cy) * m_numClusters.depth + cz;
+}
+
+/**
+ * Returns the lowest coordinate of the cluster
+ * @param cluster - cluster id
+ * @returns coordinate of the cluster's first cell
+ */
+Maze::tCoord ClusterGraph::clusterOrigin(int cluster) {
+	int cz = cluster % m_numClusters.depth;
+	cluster /= m_numClusters.depth;
+	int cy = cluster % m_numClusters.height;
+	int cx = cluster / m_numClusters.height;
+	return Maze::tCoord(cx * m_clusterSize, cy * m_clusterSize, cz * m_clusterSize);
+}
+
+/**
+ * Returns the portal at the cell, adding one if there is none
+ * @param loc - coordinate of the portal
+ * @param cluster - cluster the portal belongs to
+ * @returns portal id
+ */
+int ClusterGraph::addPortal(Maze::tCoord loc, int cluster) {
+	Maze::tIndex idx = m_pGrid->index(loc);
+	map<Maze::tIndex, int>::iterator it = m_portalAt.find(idx);
+	if (it != m_portalAt.end()) {
+		return (*it).second;
+	}
+
+	int portal = m_portals.size();
+	m_portals.push_back(tPortal(loc, cluster));
+	m_clusterPortals[cluster].push_back(portal);
+	m_portalAt[idx] = portal;
+	return portal;
+}
+
+/**
+ * Returns the coordinate of a cell on a cluster face
+ * @param dir - direction the face looks towards, EAST, UP or SOUTH
+ * @param lo - lowest coordinate of the cluster
+ * @param face - coordinate along the axis of the direction
+ * @param u - first coordinate across the face
+ * @param v - second coordinate across the face
+ * @returns coordinate of the cell
+ */
+static Maze::tCoord faceCell(Maze::eDirection dir, Maze::tCoord lo, int face, int u, int v) {
+	switch (dir) {
+		case Maze::DIR_EAST:
+			return Maze::tCoord(face, lo.y + u, lo.z + v);
+		case Maze::DIR_UP:
+			return Maze::tCoord(lo.x + u, face, lo.z + v);
+		default:
+			return Maze::tCoord(lo.x + u, lo.y + v, face);
+	}
+}
+
+/**
+ * Adds a portal on each side of every entrance between the cluster and
+ * its neighbor in the direction provided. An entrance is a connected
+ * area of the shared face where the cells on both sides are open.
+ * @param cluster - cluster id
+ * @param dir - direction of the neighbor cluster, EAST, UP or SOUTH
+ */
+void ClusterGraph::addEntrances(int cluster, Maze::eDirection dir) {
+	Maze::tDimension dim = m_pGrid->dim;
+	Maze::tCoord lo = clusterOrigin(cluster);
+
+	// Position of the face along the direction, and its size across
+	int face = 0;
+	int limit = 0;
+	int sizeU = 0;
+	int sizeV = 0;
+	switch (dir) {
+		case Maze::DIR_EAST:
+			face = lo.x + m_clusterSize - 1;
+			limit = dim.width;
+			sizeU = min(m_clusterSize, dim.height - lo.y);
+			sizeV = min(m_clusterSize, dim.depth - lo.z);
+			break;
+		case Maze::DIR_UP:
+			face = lo.y + m_clusterSize - 1;
+			limit = dim.height;
+			sizeU = min(m_clusterSize, dim.width - lo.x);
+			sizeV = min(m_clusterSize, dim.depth - lo.z);
+			break;
+		default:
+			face = lo.z + m_clusterSize - 1;
+			limit = dim.depth;
+			sizeU = min(m_clusterSize, dim.width - lo.x);
+			sizeV = min(m_clusterSize, dim.height - lo.y);
+			break;
+	}
+	// The last clusters along an axis have no neighbor
+	if (face + 1 >= limit) { return; }
+
+	Maze::tCoord offset = Maze::step(dir);
+	vector<char> open(sizeU * sizeV, 0);
+	for (int u=0; u < sizeU; u++) {
+		for (int v=0; v < sizeV; v++) {
+			Maze::tCoord cell = faceCell(dir, lo, face, u, v);
+			open[u * sizeV + v] = m_pGrid->isOpen(m_pGrid->index(cell)) &&
+				m_pGrid->isOpen(m_pGrid->index(cell + offset));
+		}
+	}
+
+	// Flood each entrance, placing its portals at the middle of the cells found
+	int neighborCluster = clusterOf(faceCell(dir, lo, face, 0, 0) + offset);
+	vector<int> entrance;
+	for (int start=0; start < sizeU * sizeV; start++) {
+		if (!open[start]) { continue; }
+
+		entrance.clear();
+		entrance.push_back(start);
+		open[start] = 0;
+		for (size_t head=0; head < entrance.size(); head++) {
+			int u = entrance[head] / sizeV;
+			int v = entrance[head] % sizeV;
+			int next[4] = { u > 0 ? entrance[head] - sizeV : -1, u + 1 < sizeU ? entrance[head] + sizeV : -1,
+				v > 0 ? entrance[head] - 1 : -1, v + 1 < sizeV ? entrance[head] + 1 : -1 };
+			for (int n=0; n < 4; n++) {
+				if (next[n] >= 0 && open[next[n]]) {
+					open[next[n]] = 0;
+					entrance.push_back(next[n]);
+				}
+			}
+		}
+
+		int middle = entrance[entrance.size() / 2];
+		Maze::tCoord cell = faceCell(dir, lo, face, middle / sizeV, middle % sizeV);
+		int near = addPortal(cell, cluster);
+		int far = addPortal(cell + offset, neighborCluster);
+		m_portals[near].edges.push_back(tEdge(far, 1));
+		m_portals[far].edges.push_back(tEdge(near, 1));
+	}
+}
+
+/**
+ * Searches breadth first from the cell, without leaving its cluster.
+ * Afterwards localDist() returns the steps to each cell in the cluster.
+ * @param cluster - cluster id
+ * @param from - cell in the cluster to search from
+ * @param pTarget - if provided the search stops once this cell is reached
+ */
+void ClusterGraph::searchCluster(int cluster, Maze::tCoord from, Maze::tCoord* pTarget) {
+	Maze::tDimension dim = m_pGrid->dim;
+	m_localLo = clusterOrigin(cluster);
+	Maze::tCoord hi = Maze::tCoord(min(m_localLo.x + m_clusterSize, dim.width),
+		min(m_localLo.y + m_clusterSize, dim.height), min(m_localLo.z + m_clusterSize, dim.depth));
+
+	// Offset of each direction in coordinates, and in the cluster's cells
+	Maze::tCoord offsets[Maze::NUM_DIRECTIONS];
+	int localOffsets[Maze::NUM_DIRECTIONS];
+	for (int dir=0; dir < Maze::NUM_DIRECTIONS; dir++) {
+		offsets[dir] = Maze::step((Maze::eDirection)dir);
+		localOffsets[dir] = (offsets[dir].x * m_clusterSize + offsets[dir].y) * m_clusterSize + offsets[dir].z;
+	}
+
+	m_localDist.assign(m_clusterSize * m_clusterSize * m_clusterSize, -1);
+	m_localParent.resize(m_localDist.size());
+	m_localQueue.clear();
+	m_localCells.clear();
+
+	int targetLocal = (pTarget != NULL) ? localIndex(*pTarget) : -1;
+	m_localDist[localIndex(from)] = 0;
+	m_localQueue.push_back(from);
+	m_localCells.push_back(m_pGrid->index(from));
+	for (size_t head=0; head < m_localQueue.size(); head++) {
+		Maze::tCoord loc = m_localQueue[head];
+		Maze::tIndex idx = m_localCells[head];
+		int local = localIndex(loc);
+		int dist = m_localDist[local];
+
+		for (int dir=0; dir < Maze::NUM_DIRECTIONS; dir++) {
+			Maze::tCoord next = loc + offsets[dir];
+			if (next.x < m_localLo.x || next.y < m_localLo.y || next.z < m_localLo.z ||
+				next.x >= hi.x || next.y >= hi.y || next.z >= hi.z) { continue; }
+
+			int nextLocal = local + localOffsets[dir];
+			if (m_localDist[nextLocal] >= 0) { continue; }
+			Maze::tIndex nextIdx = m_pGrid->neighbor(idx, (Maze::eDirection)dir);
+			if (!m_pGrid->isOpen(nextIdx)) { continue; }
+
+			m_localDist[nextLocal] = dist + 1;
+			m_localParent[nextLocal] = dir;
+			if (nextLocal == targetLocal) { return; }
+			m_localQueue.push_back(next);
+			m_localCells.push_back(nextIdx);
+		}
+	}
+}
+
+/**
+ * Returns the offset of a cell within the cluster last searched
+ * @param loc - cell in the searched cluster
+ * @returns offset of the cell in the cluster search scratch space
+ */
+int ClusterGraph::localIndex(Maze::tCoord loc) {
+	return ((loc.x - m_localLo.x) * m_clusterSize + (loc.y - m_localLo.y)) * m_clusterSize + (loc.z - m_localLo.z);
+}
+
+/**
+ * Returns the steps to the cell found by the last searchCluster()
+ * @param loc - cell in the searched cluster
+ * @returns steps to the cell, -1 if it was not reached
+ */
+int ClusterGraph::localDist(Maze::tCoord loc) {
+	return m_localDist[localIndex(loc)];
+}
+
+/**
+ * Adds the cells of the route within a cluster between two of its cells,
+ * not including the first cell.
+ * @param cluster - cluster id
+ * @param from - first cell
+ * @param to - last cell
+ * @param cells - route the cells are appended to in order
+ */
+void ClusterGraph::refine(int cluster, Maze::tCoord from, Maze::tCoord to, vector<Maze::tCoord> &cells) {
+	searchCluster(cluster, from, &to);
+
+	size_t first = cells.size();
+	Maze::tCoord loc = to;
+	while (loc != from) {
+		cells.push_back(loc);
+		loc += Maze::step(Maze::opposite((Maze::eDirection)m_localParent[localIndex(loc)]));
+	}
+
+	// The cells were added walking back from the last cell
+	reverse(cells.begin() + first, cells.end());
+}
@@ -0,0 +1,139 @@
+#include "distancefield.hpp"
+
+using namespace std;
+
+/**
+ * Initializes the field for the grid, build() must be called before
+ * any distance can be read.
+ * @param pGrid - grid of the maze, must outlive the field
+ */
+DistanceField::DistanceField(Maze::tGrid* pGrid): m_pGrid(pGrid), m_built(false), m_version(0) {}
+
+/**
+ * Finds the steps from every open cell to the destination. Must be
+ * called again if the grid's walls change.
+ * @param dest - destination all distances are measured to
+ */
+void DistanceField::build(Maze::tCoord dest) {
+	build(Maze::tCoords(1, dest));
+}
+
+/**
+ * Finds the steps from every open cell to the nearest of the
+ * destinations. Must be called again if the grid's walls change.
+ * @param dests - destinations all distances are measured to
+ */
+void DistanceField::build(const Maze::tCoords &dests) {
+	m_dests = dests;
+	m_dist.assign(m_pGrid->size, -1);
+	m_frontier.clear();
+	m_built = true;
+	m_version = m_pGrid->version;
+
+	// Searching out from every destination at once reaches each cell first
+	// from its nearest destination.
+	Maze::tCoords::const_iterator cIt;
+	for (cIt = dests.begin(); cIt != dests.end(); cIt++) {
+		Maze::tCoord dest = *cIt;
+		if (!m_pGrid->contains(dest)) { continue; }
+		Maze::tIndex destIdx = m_pGrid->index(dest);
+		if (!m_pGrid->isOpen(destIdx) || m_dist[destIdx] == 0) { continue; }
+
+		m_dist[destIdx] = 0;
+		m_frontier.push_back(destIdx);
+	}
+
+	// Moves are reversible, so searching out from the destinations gives the
+	// steps from each cell to them. The grid's solid border keeps the
+	// neighbors inside of the grid.
+	for (size_t head=0; head < m_frontier.size(); head++) {
+		Maze::tIndex idx = m_frontier[head];
+		int dist = m_dist[idx] + 1;
+
+		for (int dir=0; dir < Maze::NUM_DIRECTIONS; dir++) {
+			Maze::tIndex next = m_pGrid->neighbor(idx, (Maze::eDirection)dir);
+			if (m_dist[next] >= 0 || !m_pGrid->isOpen(next)) { continue; }
+
+			m_dist[next] = dist;
+			m_frontier.push_back(next);
+		}
+	}
+}
+
+/**
+ * Returns the number of steps from the cell to the destination
+ * @param loc - cell to measure from
+ * @returns steps to the destination, -1 if it cannot be reached
+ */
+int DistanceField::getDistance(Maze::tCoord loc) {
+	if (!m_built || !m_pGrid->contains(loc)) { return -1; }
+	return m_dist[m_pGrid->index(loc)];
+}
+
+/**
+ * Finds the neighbor of the cell that is one step closer to the destination
+ * @param loc - cell to step from
+ * @param next - set to the neighbor to step to
+ * @returns false if the destination cannot be reached, or loc is the destination
+ */
+bool DistanceField::nextStep(Maze::tCoord loc, Maze::tCoord &next) {
+	int dist = getDistance(loc);
+	if (dist <= 0) { return false; }
+
+	Maze::tIndex idx = m_pGrid->index(loc);
+	for (int dir=0; dir < Maze::NUM_DIRECTIONS; dir++) {
+		if (m_dist[m_pGrid->neighbor(idx, (Maze::eDirection)dir)] == dist - 1) {
+			next = loc + Maze::step((Maze::eDirection)dir);
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+ * Builds the route to the nearest destination by stepping downhill from the cell
+ * @param from - starting point of the route
+ * @returns the route, not including the starting point. Empty if the
+ *          destination is unreachable.
+ */
+DistanceField::tRoute DistanceField::routeFrom(Maze::tCoord from) {
+	Maze::tCoord dest;
+	return routeFrom(from, dest);
+}
+
+/**
+ * Builds the route to the nearest destination by stepping downhill from the cell
+ * @param from - starting point of the route
+ * @param dest - set to the destination the route leads to
+ * @returns the route, not including the starting point. Empty if no
+ *          destination is reachable.
+ */
+DistanceField::tRoute DistanceField::routeFrom(Maze::tCoord from, Maze::tCoord &dest) {
+	vector<Maze::tCoord> cells;
+	Maze::tCoord loc = from;
+	Maze::tCoord next;
+	while (nextStep(loc, next)) {
+		cells.push_back(next);
+		loc = next;
+	}
+	dest = loc;
+
+	tRoute route;
+	vector<Maze::tCoord>::reverse_iterator rIt;
+	for (rIt = cells.rbegin(); rIt != cells.rend(); rIt++) {
+		route.push(*rIt);
+	}
+	return route;
+}
+
+/**
+ * Returns if the field was built for exactly the destinations provided
+ * @param dests - destinations to compare, in the same order
+ */
+bool DistanceField::hasDests(const Maze::tCoords &dests) {
+	if (dests.size() != m_dests.size()) { return false; }
+	for (size_t idx=0; idx < dests.size(); idx++) {
+		if (m_dests[idx] != dests[idx]) { return false; }
+	}
+	return true;
+}
@@ -57,20 +57,23 @@ bool EnvConfig::parseEnv(char cfgFileName[]) {
 	}
 	m_dim.depth = numRows / m_dim.height;
 
-	// Update the Bot and exit with their y & z coords based on their row.
+	// Update the Bots and exits with their y & z coords based on their row.
 	tBotCfgLocs::iterator it;
 	for (it = m_bots.begin(); it != m_bots.end(); it++) {
 		tCfgLoc cfgLoc = (*it).second;
 		(*it).second.coord = calcCoordFromRowDim(cfgLoc.coord.x, cfgLoc.row, m_dim);
 	}
-	m_exitLoc.coord = calcCoordFromRowDim(m_exitLoc.coord.x, m_exitLoc.row, m_dim);
+	vector<tCfgLoc>::iterator eIt;
+	for (eIt = m_exitLocs.begin(); eIt != m_exitLocs.end(); eIt++) {
+		(*eIt).coord = calcCoordFromRowDim((*eIt).coord.x, (*eIt).row, m_dim);
+	}
 
 	return true;
 }
 
 /**
  * Reads the line character by character building a row of eCells.
- * If the bot or exist is found the class's config loc will be updated
+ * If a bot or exit is found the class's config locs will be updated
  * with its X position and row.  Which can be used later to calculate
  * the Y and Z position. If an unknown cell is found it will be substituted with
  * an empty cell.
@@ -100,9 +103,8 @@ EnvConfig::tMazeRow EnvConfig::parseRow(string line, int rowIdx) {
 				row.push_back(Maze::CELL_OCCUPIED);
 			break;
 
-			case 'E': // The exit's location
-				m_exitLoc.coord.x = idx;
-				m_exitLoc.row = rowIdx;
+			case 'E': // An exit's location, there may be many
+				m_exitLocs.push_back(tCfgLoc(rowIdx, Maze::tCoord(idx, 0, 0)));
 				row.push_back(Maze::CELL_EXIT);
 			break;
 
@@ -152,3 +154,17 @@ EnvConfig::tBotCoords EnvConfig::getBotCoords() {
 
 	return coords;
 };
+
+/**
+ * Returns the coordinates of every exit in the maze, in the order
+ * they appear in the config file.
+ * @returns tCoords - Locations of the exits in the maze
+ */
+Maze::tCoords EnvConfig::getExitCoords() {
+	Maze::tCoords coords;
+	vector<tCfgLoc>::const_iterator cIt;
+	for (cIt = m_exitLocs.begin(); cIt != m_exitLocs.end(); cIt++) {
+		coords.push_back((*cIt).coord);
+	}
+	return coords;
+}
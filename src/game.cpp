@@ -1,13 +1,19 @@
 #include "game.hpp"
 
 #include <iostream>
+#include <unistd.h>
 
 using namespace std;
 
 /**
  * Initializes tha game so it can be built
+ * @param storage - How the maze's cells will be stored once built
+ * @param layout - Order of the maze's cells within its grid
+ * @param strategy - Search algorithm the bots find their routes with
  */
-Game::Game(): m_pMaze(NULL) {}
+Game::Game(Maze::eStorage storage, Maze::eLayout layout, PathFind::eStrategy strategy):
+	m_pMaze(NULL), m_storage(storage), m_layout(layout), m_strategy(strategy), m_pClusters(NULL), m_pField(NULL),
+	m_pJunctions(NULL), m_pCache(NULL) {}
 
 /**
  * Cleans up any memeory allocated remaning
@@ -25,12 +31,71 @@ bool Game::buildEnv(EnvConfig cfg) {
 	EnvConfig::tMazeRows rows = cfg.getMazeRows();
 
 	Maze::tDimension dim = cfg.getDim();
-	m_pMaze = new Maze(dim);
+	m_pMaze = new Maze(dim, m_storage, m_layout);
 
 	createBots(cfg.getBotCoords());
-	m_ExitCoord = cfg.getExitCoord();
+	m_ExitCoords = cfg.getExitCoords();
 
 	initMazeCellsState(m_pMaze, rows, dim);
+
+	// The bots and exits are kept open, so none of the bots' routes pass
+	// through a dead end and the cell by cell searches can skip them all.
+	// The other strategies build their own structures over the maze, and
+	// gain nothing from filling it.
+	if (m_strategy == PathFind::SEARCH_TREE || m_strategy == PathFind::SEARCH_BFS ||
+		m_strategy == PathFind::SEARCH_ASTAR || m_strategy == PathFind::SEARCH_BIDIRECTIONAL) {
+		m_pMaze->fillDeadEnds();
+	}
+
+	// Bots share the routes they find, so a route already found by one
+	// bot is only looked up by the others.
+	m_pCache = new RouteCache(m_pMaze->getGrid());
+	tBots::iterator cacheIt;
+	for (cacheIt = m_bots.begin(); cacheIt != m_bots.end(); cacheIt++) {
+		(*cacheIt).second->setRouteCache(m_pCache);
+	}
+
+	// The maze's walls don't change once built, so the portal graph
+	// only needs to be built once for all of the bots' searches.
+	if (m_strategy == PathFind::SEARCH_HIERARCHICAL) {
+		m_pClusters = new ClusterGraph(m_pMaze->getGrid());
+		m_pClusters->build();
+
+		tBots::iterator it;
+		for (it = m_bots.begin(); it != m_bots.end(); it++) {
+			(*it).second->setClusterGraph(m_pClusters);
+		}
+	}
+
+	// All bots head to the nearest of the same exits, so one search out
+	// from all of the exits together gives every bot its route.
+	if (m_strategy == PathFind::SEARCH_DISTANCE_FIELD) {
+		m_pField = new DistanceField(m_pMaze->getGrid());
+		m_pField->build(m_ExitCoords);
+
+		tBots::iterator it;
+		for (it = m_bots.begin(); it != m_bots.end(); it++) {
+			(*it).second->setDistanceField(m_pField);
+		}
+	}
+
+	// The bots' starting points are made nodes, so their first search
+	// starts on a node instead of part way along a corridor.
+	if (m_strategy == PathFind::SEARCH_JUNCTION) {
+		Maze::tCoords spawns;
+		tBots::iterator it;
+		for (it = m_bots.begin(); it != m_bots.end(); it++) {
+			spawns.push_back((*it).second->getLoc());
+		}
+		m_pJunctions = new JunctionGraph(m_pMaze->getGrid());
+		m_pJunctions->build(spawns);
+
+		for (it = m_bots.begin(); it != m_bots.end(); it++) {
+			(*it).second->setJunctionGraph(m_pJunctions);
+		}
+	}
+
+	return true;
 }
 
 /**
@@ -56,27 +121,34 @@ bool Game::run() {
 	// Step through the simulation telling the bot to move through the maze
 	while(m_bots.size() > 0) {
 		Maze::tSymCoordPairs pois; // points of interest that we want to make sure get drawn
-		pois.push_back(Maze::tSymCoordPair('E', m_ExitCoord));
+		Maze::tCoords::const_iterator eIt;
+		for (eIt = m_ExitCoords.begin(); eIt != m_ExitCoords.end(); eIt++) {
+			pois.push_back(Maze::tSymCoordPair('E', *eIt));
+		}
 
-		tBots::iterator it;
-		for (it = m_bots.begin(); it != m_bots.end(); it++) {
+		tBots::iterator it = m_bots.begin();
+		while (it != m_bots.end()) {
 			char symb = (*it).first;
 			Bot* pBot = (*it).second;
 
 			if (!pBot->move()) {
 				cerr << "Bot [" << symb << "], path blocked, waiting a turn." << endl;
+				it++;
 				continue;
 			}
 			Maze::tCoord botLoc = pBot->getLoc();
 			pois.push_back(Maze::tSymCoordPair(symb, botLoc));
 
 			// Cleanup the bot if it has reached the exit.
-			if (botLoc == m_ExitCoord) {
+			if (botLoc == pBot->getDest()) {
 				cout << "Bot [" << symb << "], Escapable: " << pBot->getRouteUsed() << endl;
 				// im_pMaze->updateCell(botLoc, Maze::CELL_EMPTY);
-				m_bots.erase(it);
+				// Advance before erasing, erasing invalidates the iterator
+				m_bots.erase(it++);
 				delete pBot;
+				continue;
 			}
+			it++;
 		}
 
 		m_pMaze->printPOIs(pois);
@@ -89,17 +161,21 @@ bool Game::run() {
 
 /**
  * Calculate the bot's initialize route through the maze. If a bot is unable to find
- * a path to the exit, it will be removed from the game.
+ * a path to any exit, it will be removed from the game.
  * @returns if any of the buts were able to find a route
  */
 void Game::initBots() {
-	tBots::iterator it;
-	for (it = m_bots.begin(); it != m_bots.end(); it++) {
+	tBots::iterator it = m_bots.begin();
+	while (it != m_bots.end()) {
 		Bot* pBot = (*it).second;
-		if (!pBot->calcRoute(m_ExitCoord)) {
+		if (!pBot->calcNearestRoute(m_ExitCoords, m_strategy)) {
 			cerr << "Bot [" << (*it).first << "], Not Escapable." << endl;
-			m_bots.erase(it);
+			// Advance before erasing, erasing invalidates the iterator
+			m_bots.erase(it++);
+			delete pBot;
+			continue;
 		}
+		it++;
 	}
 }
 
@@ -120,7 +196,7 @@ void Game::initMazeCellsState(Maze* pMaze, EnvConfig::tMazeRows rows, Maze::tDim
 		for (cRowIt = row.begin(); cRowIt != row.end(); cRowIt++) {
 			// Get the cell, and using the env configs method to calculate the cords of the cell which needs to be updated
 			Maze::eCell cell = *cRowIt;
-			if (cell != Maze::CELL_EMPTY) {
+			if (cell != pMaze->getDefaultState()) {
 				Maze::tCoord coord = EnvConfig::calcCoordFromRowDim(x, rowIdx, dim);
 				pMaze->updateCell(coord, cell);
 			}
@@ -134,6 +210,25 @@ void Game::initMazeCellsState(Maze* pMaze, EnvConfig::tMazeRows rows, Maze::tDim
  * Deletes any allocated memory used during run
  */
 void Game::cleanup() {
+	if (m_pClusters != NULL) {
+		delete m_pClusters;
+		m_pClusters = NULL;
+	}
+
+	if (m_pField != NULL) {
+		delete m_pField;
+		m_pField = NULL;
+	}
+
+	if (m_pJunctions != NULL) {
+		delete m_pJunctions;
+		m_pJunctions = NULL;
+	}
+	if (m_pCache != NULL) {
+		delete m_pCache;
+		m_pCache = NULL;
+	}
+
 	if (m_pMaze != NULL) {
 		delete m_pMaze;
 		m_pMaze = NULL;
@@ -143,6 +238,6 @@ void Game::cleanup() {
 	for (it = m_bots.begin(); it != m_bots.end(); it++) {
 		Bot* pBot = (*it).second;
 		delete pBot;
-		m_bots.erase(it);
 	}
+	m_bots.clear();
 }
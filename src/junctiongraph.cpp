@@ -0,0 +1,334 @@
+#include "junctiongraph.hpp"
+
+#include <stdlib.h>
+#include <algorithm>
+
+using namespace std;
+
+/**
+ * Initializes the graph for the grid, build() must be called before
+ * any route can be found.
+ * @param pGrid - grid of the maze, must outlive the graph
+ */
+JunctionGraph::JunctionGraph(Maze::tGrid* pGrid): m_pGrid(pGrid), m_built(false), m_version(0), m_search(0),
+	m_expanded(0) {}
+
+/**
+ * Finds the nodes of the maze and the corridors between them. Must be
+ * called again if the grid's walls change.
+ * @param spawns - cells to make nodes even if they are in a corridor,
+ *                 such as the entities' starting points
+ */
+void JunctionGraph::build(const Maze::tCoords &spawns) {
+	m_nodes.clear();
+	m_edges.clear();
+	m_cellNode.assign(m_pGrid->size, -1);
+	m_cellEdge.assign(m_pGrid->size, -1);
+	m_cellPos.assign(m_pGrid->size, 0);
+
+	Maze::tCoords::const_iterator cIt;
+	for (cIt = spawns.begin(); cIt != spawns.end(); cIt++) {
+		if (!m_pGrid->contains(*cIt)) { continue; }
+		Maze::tIndex idx = m_pGrid->index(*cIt);
+		if (!m_pGrid->isOpen(idx) || m_cellNode[idx] >= 0) { continue; }
+
+		m_cellNode[idx] = m_nodes.size();
+		m_nodes.push_back(tNode(idx, *cIt));
+	}
+
+	// Every open cell that isn't part of a corridor is a node
+	Maze::tDimension dim = m_pGrid->dim;
+	for (int x=0; x < dim.width; x++) {
+		for (int y=0; y < dim.height; y++) {
+			for (int z=0; z < dim.depth; z++) {
+				Maze::tCoord loc = Maze::tCoord(x, y, z);
+				Maze::tIndex idx = m_pGrid->index(loc);
+				if (!m_pGrid->isOpen(idx) || m_cellNode[idx] >= 0) { continue; }
+
+				if (__builtin_popcount(m_pGrid->openNeighbors(idx)) != 2 || m_pGrid->state(idx) == Maze::CELL_EXIT) {
+					m_cellNode[idx] = m_nodes.size();
+					m_nodes.push_back(tNode(idx, loc));
+				}
+			}
+		}
+	}
+
+	for (size_t node=0; node < m_nodes.size(); node++) {
+		for (int dir=0; dir < Maze::NUM_DIRECTIONS; dir++) {
+			addCorridor(node, (Maze::eDirection)dir);
+		}
+	}
+
+	// Corridors that loop back on themselves without a node are left over,
+	// one of their cells is made a node so the loop becomes an edge.
+	for (int x=0; x < dim.width; x++) {
+		for (int y=0; y < dim.height; y++) {
+			for (int z=0; z < dim.depth; z++) {
+				Maze::tCoord loc = Maze::tCoord(x, y, z);
+				Maze::tIndex idx = m_pGrid->index(loc);
+				if (!m_pGrid->isOpen(idx) || m_cellNode[idx] >= 0 || m_cellEdge[idx] >= 0) { continue; }
+
+				int node = m_nodes.size();
+				m_cellNode[idx] = node;
+				m_nodes.push_back(tNode(idx, loc));
+				for (int dir=0; dir < Maze::NUM_DIRECTIONS; dir++) {
+					addCorridor(node, (Maze::eDirection)dir);
+				}
+			}
+		}
+	}
+
+	// Room for the start and destination of a route after the nodes
+	m_cost.assign(m_nodes.size() + 2, 0);
+	m_parent.assign(m_nodes.size() + 2, -1);
+	m_parentEdge.assign(m_nodes.size() + 2, -1);
+	m_stamp.assign(m_nodes.size() + 2, 0);
+	m_search = 0;
+	m_built = true;
+	m_version = m_pGrid->version;
+}
+
+/**
+ * Walks the corridor leaving the node in the direction provided, and
+ * adds it as an edge if it hasn't been added from its other end.
+ * @param node - node the corridor leaves
+ * @param dir - direction of the corridor's first step
+ */
+void JunctionGraph::addCorridor(int node, Maze::eDirection dir) {
+	Maze::tIndex idx = m_pGrid->neighbor(m_nodes[node].idx, dir);
+	if (!m_pGrid->isOpen(idx) || m_cellEdge[idx] >= 0) { return; }
+	// Neighboring nodes are joined once, from the node found first
+	if (m_cellNode[idx] >= 0 && m_cellNode[idx] < node) { return; }
+
+	// Each corridor cell has one open neighbor besides the one stepped from
+	vector<Maze::tIndex> cells;
+	Maze::eDirection step = dir;
+	while (m_cellNode[idx] < 0) {
+		cells.push_back(idx);
+		unsigned int open = m_pGrid->openNeighbors(idx) & ~(1 << Maze::opposite(step));
+		step = (Maze::eDirection)__builtin_ctz(open);
+		idx = m_pGrid->neighbor(idx, step);
+	}
+
+	int other = m_cellNode[idx];
+	int edge = m_edges.size();
+	m_edges.push_back(tEdge(node, other, cells.size() + 1, dir, Maze::opposite(step)));
+	for (size_t pos=0; pos < cells.size(); pos++) {
+		m_cellEdge[cells[pos]] = edge;
+		m_cellPos[cells[pos]] = pos + 1;
+	}
+
+	m_nodes[node].edges.push_back(edge);
+	if (other != node) {
+		m_nodes[other].edges.push_back(edge);
+	}
+}
+
+/**
+ * Finds the shortest route through the graph, and walks the corridors
+ * it takes to fill in the cells of the route.
+ * @param from - starting point of the route
+ * @param dest - destination of the route
+ * @returns the route, not including the starting point. Empty if the
+ *          destination is unreachable.
+ */
+JunctionGraph::tRoute JunctionGraph::findRoute(Maze::tCoord from, Maze::tCoord dest) {
+	tRoute route;
+	m_expanded = 0;
+
+	if (!m_built || from == dest) { return route; }
+	if (!m_pGrid->contains(from) || !m_pGrid->contains(dest)) { return route; }
+	Maze::tIndex fromIdx = m_pGrid->index(from);
+	Maze::tIndex destIdx = m_pGrid->index(dest);
+	if (!m_pGrid->isOpen(fromIdx) || !m_pGrid->isOpen(destIdx)) { return route; }
+
+	// The start and destination are added to the graph as the two nodes
+	// after the others, connected to the ends of their corridors.
+	tEnd start = findEnd(fromIdx);
+	tEnd end = findEnd(destIdx);
+	int startNode = m_nodes.size();
+	int destNode = startNode + 1;
+
+	// Start a new search, only resetting the stamps when they wrap around
+	if (++m_search == 0) {
+		m_stamp.assign(m_stamp.size(), 0);
+		m_search = 1;
+	}
+	m_stamp[startNode] = m_search;
+	m_cost[startNode] = 0;
+
+	// A* over the nodes, ordered by the estimated route length. Corridors
+	// are never shorter than the manhattan distance between their ends.
+	tOpenQueue openQ;
+	if (start.node >= 0) {
+		relax(start.node, 0, startNode, -1, from.distance(dest), openQ);
+	} else {
+		const tEdge &e = m_edges[start.edge];
+		relax(e.a, stepsToEnd(start, true), startNode, start.edge, m_nodes[e.a].loc.distance(dest), openQ);
+		relax(e.b, stepsToEnd(start, false), startNode, start.edge, m_nodes[e.b].loc.distance(dest), openQ);
+		if (end.edge == start.edge) {
+			relax(destNode, abs(end.pos - start.pos), startNode, start.edge, 0, openQ);
+		}
+	}
+
+	bool found = false;
+	while (!openQ.empty()) {
+		tQueued top = openQ.top();
+		openQ.pop();
+
+		int node = top.second;
+		if (node == destNode) {
+			found = true;
+			break;
+		}
+		int cost = m_cost[node];
+		if (cost + m_nodes[node].loc.distance(dest) != top.first) { continue; }
+		m_expanded++;
+
+		// The destination is reached from its own node, or the ends of its corridor
+		if (end.node == node) {
+			relax(destNode, cost, node, -1, 0, openQ);
+		} else if (end.edge >= 0) {
+			const tEdge &e = m_edges[end.edge];
+			if (e.a == node) { relax(destNode, cost + stepsToEnd(end, true), node, end.edge, 0, openQ); }
+			if (e.b == node) { relax(destNode, cost + stepsToEnd(end, false), node, end.edge, 0, openQ); }
+		}
+
+		vector<int>::const_iterator eIt;
+		for (eIt = m_nodes[node].edges.begin(); eIt != m_nodes[node].edges.end(); eIt++) {
+			const tEdge &e = m_edges[*eIt];
+			if (e.a == e.b) { continue; }
+
+			int other = (e.a == node) ? e.b : e.a;
+			relax(other, cost + e.length, node, *eIt, m_nodes[other].loc.distance(dest), openQ);
+		}
+	}
+	if (!found) { return route; }
+
+	// Walk back through the nodes, then fill in the corridors between them
+	vector<int> hops;
+	for (int node = destNode; node != startNode; node = m_parent[node]) {
+		hops.push_back(node);
+	}
+	hops.push_back(startNode);
+
+	vector<Maze::tIndex> cells;
+	for (size_t hop=hops.size() - 1; hop > 0; hop--) {
+		expandHop(hops[hop], hops[hop - 1], start, end, cells);
+	}
+
+	vector<Maze::tIndex>::reverse_iterator rIt;
+	for (rIt = cells.rbegin(); rIt != cells.rend(); rIt++) {
+		route.push(m_pGrid->coord(*rIt));
+	}
+	return route;
+}
+
+/**
+ * Finds the node or corridor cell a route starts or ends at
+ * @param idx - grid index of the cell, must be open
+ * @returns where the route starts or ends
+ */
+JunctionGraph::tEnd JunctionGraph::findEnd(Maze::tIndex idx) {
+	tEnd end;
+	end.node = m_cellNode[idx];
+	if (end.node < 0) {
+		end.edge = m_cellEdge[idx];
+		end.pos = m_cellPos[idx];
+	}
+	return end;
+}
+
+/**
+ * Lowers the cost of a node if the cost provided is less, and queues it
+ * @param node - node reached
+ * @param cost - steps to the node
+ * @param parent - node the node was reached from
+ * @param edge - edge the node was reached by, -1 if it is the same cell
+ * @param estimate - estimated steps from the node to the destination
+ * @param openQ - queue of nodes to expand
+ */
+void JunctionGraph::relax(int node, int cost, int parent, int edge, int estimate, tOpenQueue &openQ) {
+	if (m_stamp[node] == m_search && m_cost[node] <= cost) { return; }
+
+	m_stamp[node] = m_search;
+	m_cost[node] = cost;
+	m_parent[node] = parent;
+	m_parentEdge[node] = edge;
+	openQ.push(tQueued(cost + estimate, node));
+}
+
+/**
+ * Adds the cells stepped into moving from one node of the search to
+ * the next.
+ * @param from - node moved from
+ * @param to - node moved to
+ * @param start - where the route starts
+ * @param end - where the route ends
+ * @param cells - cells of the route the steps are appended to in order
+ */
+void JunctionGraph::expandHop(int from, int to, const tEnd &start, const tEnd &end, vector<Maze::tIndex> &cells) {
+	int edge = m_parentEdge[to];
+	if (edge < 0) { return; }
+
+	const tEdge &e = m_edges[edge];
+	int startNode = m_nodes.size();
+	int destNode = startNode + 1;
+	vector<Maze::tIndex> steps;
+
+	if (from == startNode && to == destNode) {
+		// Both ends are in the same corridor, walk in from the end the
+		// destination is closer to and keep the cells past the start.
+		if (start.pos < end.pos) {
+			walkEdge(edge, true, end.pos, steps);
+			cells.insert(cells.end(), steps.begin() + start.pos, steps.end());
+		} else {
+			walkEdge(edge, false, e.length - end.pos, steps);
+			cells.insert(cells.end(), steps.begin() + (e.length - start.pos), steps.end());
+		}
+		return;
+	}
+
+	if (from == startNode) {
+		// Walk in from the node to the start, and take the steps back out.
+		// A corridor looping back to one node is left by its shorter side.
+		bool fromA = (e.a == e.b) ? stepsToEnd(start, true) <= stepsToEnd(start, false) : (to == e.a);
+		walkEdge(edge, fromA, stepsToEnd(start, fromA), steps);
+		for (int step=(int)steps.size() - 2; step >= 0; step--) {
+			cells.push_back(steps[step]);
+		}
+		cells.push_back(m_nodes[to].idx);
+		return;
+	}
+
+	if (to == destNode) {
+		bool fromA = (e.a == e.b) ? stepsToEnd(end, true) <= stepsToEnd(end, false) : (from == e.a);
+		walkEdge(edge, fromA, stepsToEnd(end, fromA), cells);
+		return;
+	}
+
+	walkEdge(edge, from == e.a, e.length, cells);
+}
+
+/**
+ * Walks along a corridor from one of its ends, adding each cell
+ * stepped into.
+ * @param edge - corridor to walk
+ * @param fromA - true to start at the first node, false for the second
+ * @param steps - number of cells to step into
+ * @param cells - cells the steps are appended to in order
+ */
+void JunctionGraph::walkEdge(int edge, bool fromA, int steps, vector<Maze::tIndex> &cells) {
+	const tEdge &e = m_edges[edge];
+	Maze::tIndex idx = m_nodes[fromA ? e.a : e.b].idx;
+	Maze::eDirection dir = (Maze::eDirection)(fromA ? e.dirA : e.dirB);
+
+	for (int step=0; step < steps; step++) {
+		idx = m_pGrid->neighbor(idx, dir);
+		cells.push_back(idx);
+		if (step + 1 == steps) { break; }
+
+		unsigned int open = m_pGrid->openNeighbors(idx) & ~(1 << Maze::opposite(dir));
+		dir = (Maze::eDirection)__builtin_ctz(open);
+	}
+}
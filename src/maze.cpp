@@ -1,16 +1,66 @@
 #include "maze.hpp"
 
+#include <stdint.h>
 #include <iostream>
 
 using namespace std;
 
+// Masks of the bits belonging to each axis of a Morton code. Z takes the
+// lowest bit so cells next to each other along Z stay next to each other.
+static const uint64_t MORTON_Z_MASK = 0x1249249249249249ULL;
+static const uint64_t MORTON_Y_MASK = MORTON_Z_MASK << 1;
+static const uint64_t MORTON_X_MASK = MORTON_Z_MASK << 2;
+
+/**
+ * Spreads the lower 21 bits of the value out so there are two zero
+ * bits between each of them.
+ * @param v - value to spread
+ * @returns the spread bits
+ */
+static uint64_t spreadBits(uint64_t v) {
+	v &= 0x1fffff;
+	v = (v | v << 32) & 0x1f00000000ffffULL;
+	v = (v | v << 16) & 0x1f0000ff0000ffULL;
+	v = (v | v << 8) & 0x100f00f00f00f00fULL;
+	v = (v | v << 4) & 0x10c30c30c30c30c3ULL;
+	v = (v | v << 2) & 0x1249249249249249ULL;
+	return v;
+}
+
+/**
+ * Reverses spreadBits(), packing every third bit back together
+ * @param v - value to compact
+ * @returns the compacted bits
+ */
+static uint64_t compactBits(uint64_t v) {
+	v &= 0x1249249249249249ULL;
+	v = (v | v >> 2) & 0x10c30c30c30c30c3ULL;
+	v = (v | v >> 4) & 0x100f00f00f00f00fULL;
+	v = (v | v >> 8) & 0x1f0000ff0000ffULL;
+	v = (v | v >> 16) & 0x1f00000000ffffULL;
+	v = (v | v >> 32) & 0x1fffff;
+	return v;
+}
+
+/**
+ * Interleaves the coordinate's bits into a Morton code
+ * @param x, y, z - coordinate to encode
+ * @returns Morton code of the coordinate
+ */
+static uint64_t mortonEncode(uint64_t x, uint64_t y, uint64_t z) {
+	return spreadBits(x) << 2 | spreadBits(y) << 1 | spreadBits(z);
+}
+
 /**
  * Initializes the maze and with a given size. Once it is initialized it is
  * read to have its cells' state set.
  * @param dim tDimension - Size of the maze.
+ * @param storage - How the maze's cells will be stored
+ * @param layout - Order of the cells within the grid
  */
-Maze::Maze(tDimension dim): m_pGrid(NULL) {
-	m_pGrid = createGrid(dim);
+Maze::Maze(tDimension dim, eStorage storage, eLayout layout): m_pGrid(NULL), m_areaVersion(0), m_areasLabeled(false),
+		m_deadEndCount(0) {
+	m_pGrid = createGrid(dim, storage, layout);
 }
 
 /**
@@ -25,7 +75,10 @@ Maze::~Maze() {
 }
 
 /**
- * Updates the cell located at the coordiantes with the state provided
+ * Updates the cell located at the coordiantes with the state provided.
+ * CELL_OCCUPIED is recorded in the occupancy overlay, opening the cell
+ * if it was solid. All other states update the static grid and clear any
+ * occupant of the cell.
  * @param coord - Location of the cell to update
  * @param state - Not state
  * @returns success if the cell was updated
@@ -33,18 +86,85 @@ Maze::~Maze() {
 bool Maze::updateCell(Maze::tCoord coord, Maze::eCell state) {
 	if (!isValidCoord(coord)) { return false; }
 
-	m_pGrid->at(coord)->state = state;
+	tIndex idx = m_pGrid->index(coord);
+	if (state == CELL_OCCUPIED) {
+		// An occupied cell can't be solid, the entity must be able to move out of it
+		if (m_pGrid->state(idx) == CELL_SOLID) {
+			m_pGrid->setState(idx, CELL_EMPTY);
+			m_pGrid->noteChange(idx);
+		}
+		return occupy(coord);
+	}
+
+	m_occupied.erase(idx);
+	bool wasOpen = m_pGrid->isOpen(idx);
+	m_pGrid->setState(idx, state);
+	if (m_pGrid->isOpen(idx) != wasOpen) {
+		m_pGrid->noteChange(idx);
+	}
 
 	return true;
 }
 
+/**
+ * Returns the state of the cell located at the coordinates, combining
+ * the static grid with the occupancy overlay. Exits stay exits even
+ * when occupied.
+ * @param coord - Location of the cell
+ * @returns state of the cell, CELL_INVALID if the coordinate is not in the maze
+ */
+Maze::eCell Maze::getState(Maze::tCoord coord) {
+	if (!isValidCoord(coord)) { return CELL_INVALID; }
+
+	tIndex idx = m_pGrid->index(coord);
+	eCell state = m_pGrid->state(idx);
+	if (state == CELL_EMPTY && m_occupied.count(idx) != 0) {
+		return CELL_OCCUPIED;
+	}
+	return state;
+}
+
+/**
+ * Marks the cell as occupied by an entity in the occupancy overlay.
+ * The static grid is not changed.
+ * @param coord - Location of the cell
+ * @returns success if the coordinate is in the maze
+ */
+bool Maze::occupy(Maze::tCoord coord) {
+	if (!isValidCoord(coord)) { return false; }
+
+	m_occupied.insert(m_pGrid->index(coord));
+	return true;
+}
+
+/**
+ * Removes the occupant of the cell from the occupancy overlay
+ * @param coord - Location of the cell
+ */
+void Maze::vacate(Maze::tCoord coord) {
+	if (!isValidCoord(coord)) { return; }
+
+	m_occupied.erase(m_pGrid->index(coord));
+}
+
+/**
+ * Returns if an entity occupies the cell
+ * @param coord - Location of the cell
+ * @returns true if the cell is occupied
+ */
+bool Maze::isOccupied(Maze::tCoord coord) {
+	if (!isValidCoord(coord)) { return false; }
+
+	return m_occupied.count(m_pGrid->index(coord)) != 0;
+}
+
 /**
  * returns if the coordinate provided are valid inside of the grid
  * @param coord - a location in the grid
  * @returns if the coordinate is valid
  */
 bool Maze::isValidCoord(Maze::tCoord coord) {
-	if (!hasGrid() || m_pGrid->at(coord) == NULL) {
+	if (!hasGrid() || !m_pGrid->contains(coord)) {
 		return false;
 	}
 
@@ -63,7 +183,7 @@ void Maze::printPOIs(tSymCoordPairs pois) {
 
 	// get a list of unique layers
 	int *layers = new int[dim.height];
-	for (int idx=0; idx < pois.size(); idx++) {
+	for (int idx=0; idx < dim.height; idx++) {
 		layers[idx] = 0;
 	}
 	tSymCoordPairs::const_iterator cIt;
@@ -81,7 +201,7 @@ void Maze::printPOIs(tSymCoordPairs pois) {
 
 			for (int x=0; x < dim.width; x++) {
 				tCoord coord = tCoord(x,y,z);
-				eCell state = m_pGrid->at(coord)->state;
+				eCell state = getState(coord);
 
 				if (state != CELL_EMPTY && state != CELL_SOLID) {
 					for (cIt = pois.begin(); cIt != pois.end(); cIt++) {
@@ -108,48 +228,504 @@ void Maze::printPOIs(tSymCoordPairs pois) {
 	delete []layers;
 }
 
+/**
+ * Returns if an entity could move between the two cells through the
+ * open cells of the maze. The maze's connected areas are labeled on the
+ * first call and kept until cells are walled off, so each check after
+ * the first takes constant time. Grids too large to label are taken
+ * to connect all of their open cells.
+ * @param from - first cell
+ * @param to - second cell
+ * @returns true if both cells are open and connected
+ */
+bool Maze::isReachable(tCoord from, tCoord to) {
+	if (!isValidCoord(from) || !isValidCoord(to)) { return false; }
+
+	tIndex fromIdx = m_pGrid->index(from);
+	tIndex toIdx = m_pGrid->index(to);
+	if (!m_pGrid->isOpen(fromIdx) || !m_pGrid->isOpen(toIdx)) { return false; }
+
+	if (!m_areasLabeled || !m_pGrid->changesSince(m_areaVersion, m_areaChanged)) {
+		if (!labelAreas()) { return true; }
+	} else if (!m_areaChanged.empty()) {
+		// Opened cells only join areas, but walling a cell off may split
+		// its area, so the areas must be labeled again.
+		bool walled = false;
+		for (vector<tIndex>::iterator it=m_areaChanged.begin(); it != m_areaChanged.end() && !walled; it++) {
+			walled = !m_pGrid->isOpen(*it);
+		}
+
+		if (walled) {
+			if (!labelAreas()) { return true; }
+		} else {
+			for (vector<tIndex>::iterator it=m_areaChanged.begin(); it != m_areaChanged.end(); it++) {
+				joinNeighborAreas(*it);
+			}
+			m_areaVersion = m_pGrid->version;
+		}
+	}
+
+	return findArea(fromIdx) == findArea(toIdx);
+}
+
+/**
+ * Labels the connected areas of open cells, joining each open cell with
+ * its open neighbors to the west, below, and north.
+ * @returns false if the grid has too many cells for an area id
+ */
+bool Maze::labelAreas() {
+	if (m_pGrid->size > (tIndex)(tAreaId)-1) {
+		m_areaParent.clear();
+		m_areasLabeled = false;
+		return false;
+	}
+
+	m_areaParent.resize(m_pGrid->size);
+	for (tIndex idx=0; idx < m_pGrid->size; idx++) {
+		m_areaParent[idx] = (tAreaId)idx;
+	}
+
+	// Every pair of open neighbors is joined once, from the cell further
+	// east, above, or south.
+	eDirection back[] = { DIR_WEST, DIR_DOWN, DIR_NORTH };
+	tDimension dim = m_pGrid->dim;
+	for (int x=0; x < dim.width; x++) {
+		for (int y=0; y < dim.height; y++) {
+			for (int z=0; z < dim.depth; z++) {
+				tIndex idx = m_pGrid->index(tCoord(x, y, z));
+				if (!m_pGrid->isOpen(idx)) { continue; }
+
+				for (int dir=0; dir < 3; dir++) {
+					tIndex next = m_pGrid->neighbor(idx, back[dir]);
+					if (!m_pGrid->isOpen(next)) { continue; }
+
+					tAreaId a = findArea(idx);
+					tAreaId b = findArea(next);
+					if (a != b) { m_areaParent[a] = b; }
+				}
+			}
+		}
+	}
+
+	m_areaVersion = m_pGrid->version;
+	m_areasLabeled = true;
+	return true;
+}
+
+/**
+ * Joins an open cell to the areas of all of its open neighbors
+ * @param idx - index of the cell
+ */
+void Maze::joinNeighborAreas(tIndex idx) {
+	if (!m_pGrid->isOpen(idx)) { return; }
+
+	for (int dir=0; dir < NUM_DIRECTIONS; dir++) {
+		tIndex next = m_pGrid->neighbor(idx, (eDirection)dir);
+		if (!m_pGrid->isOpen(next)) { continue; }
+
+		tAreaId a = findArea(idx);
+		tAreaId b = findArea(next);
+		if (a != b) { m_areaParent[a] = b; }
+	}
+}
+
+/**
+ * Returns the root of the area the cell belongs to
+ * @param idx - index of the cell
+ * @returns index of the area's root cell
+ */
+Maze::tAreaId Maze::findArea(tIndex idx) {
+	// Point each cell passed at its grandparent, halving the path for
+	// the next search.
+	tAreaId area = (tAreaId)idx;
+	while (m_areaParent[area] != area) {
+		m_areaParent[area] = m_areaParent[m_areaParent[area]];
+		area = m_areaParent[area];
+	}
+	return area;
+}
+
+/**
+ * Fills the maze's dead ends, open cells with at most one open neighbor
+ * that aren't an exit or occupied. Filling a cell may leave its neighbor
+ * a dead end in turn, so each cul-de-sac is filled back to the junction
+ * it branches from. The cells are recorded in the grid's dead end layer
+ * instead of being walled off, and are only skipped by searches until
+ * the grid next changes.
+ * @returns number of cells filled
+ */
+long Maze::fillDeadEnds() {
+	m_pGrid->deadEnds.reset(m_pGrid->size);
+	m_deadEndCount = 0;
+
+	// Open neighbors not yet filled, of each open cell
+	vector<unsigned char> degree(m_pGrid->size, 0);
+	vector<tIndex> filled;
+	tDimension dim = m_pGrid->dim;
+	for (int x=0; x < dim.width; x++) {
+		for (int y=0; y < dim.height; y++) {
+			for (int z=0; z < dim.depth; z++) {
+				tIndex idx = m_pGrid->index(tCoord(x, y, z));
+				if (!m_pGrid->isOpen(idx)) { continue; }
+
+				unsigned int open = m_pGrid->openNeighbors(idx);
+				degree[idx] = __builtin_popcount(open);
+				if (degree[idx] <= 1 && !isKeptOpen(idx)) {
+					m_pGrid->deadEnds.set(idx);
+					filled.push_back(idx);
+				}
+			}
+		}
+	}
+
+	// Filling a cell takes a neighbor from each of its open neighbors
+	for (size_t head=0; head < filled.size(); head++) {
+		tIndex idx = filled[head];
+		for (int dir=0; dir < NUM_DIRECTIONS; dir++) {
+			tIndex next = m_pGrid->neighbor(idx, (eDirection)dir);
+			if (!m_pGrid->isOpen(next) || m_pGrid->deadEnds.test(next)) { continue; }
+
+			if (--degree[next] <= 1 && !isKeptOpen(next)) {
+				m_pGrid->deadEnds.set(next);
+				filled.push_back(next);
+			}
+		}
+	}
+
+	m_pGrid->deadEndsVersion = m_pGrid->version;
+	m_pGrid->deadEndsFilled = true;
+	m_deadEndCount = filled.size();
+	return m_deadEndCount;
+}
+
+/**
+ * Returns if the cell was filled by the last fillDeadEnds(), and the
+ * grid hasn't changed since.
+ * @param coord - Location of the cell
+ */
+bool Maze::isDeadEnd(tCoord coord) {
+	if (!isValidCoord(coord) || !m_pGrid->hasDeadEnds()) { return false; }
+	return m_pGrid->deadEnds.test(m_pGrid->index(coord));
+}
+
+/**
+ * Returns if the cell must be left open when filling dead ends, because
+ * routes start or end there.
+ * @param idx - index of the cell
+ * @returns true for exits and occupied cells
+ */
+bool Maze::isKeptOpen(tIndex idx) {
+	return m_pGrid->state(idx) == CELL_EXIT || m_occupied.count(idx) != 0;
+}
+
+/**
+ * Returns the offset to the cell adjacent in the direction provided
+ * @param dir - direction to step in
+ * @returns coordinate offset of the step
+ */
+Maze::tCoord Maze::step(eDirection dir) {
+	switch (dir) {
+		case DIR_NORTH: return tCoord(0,0,-1);
+		case DIR_SOUTH: return tCoord(0,0,1);
+		case DIR_EAST: return tCoord(1,0,0);
+		case DIR_WEST: return tCoord(-1,0,0);
+		case DIR_UP: return tCoord(0,1,0);
+		case DIR_DOWN: return tCoord(0,-1,0);
+		default: return tCoord();
+	}
+}
+
+/**
+ * Initializes the grid's strides and size, the cells are not allocated.
+ * @param d - dimensions of the maze
+ * @param b - thickness of the border
+ * @param s - how the cells will be stored
+ * @param l - order of the cells in the cell buffer
+ */
+Maze::tGrid::tGrid(tDimension d, int b, eStorage s, eLayout l): cells(NULL), dim(d), border(b), storage(s), layout(l),
+		numChunks(0), version(0), deadEndsVersion(0), deadEndsFilled(false) {
+	// Sparse storage allocates the grid a brick at a time
+	if (storage == STORAGE_SPARSE) {
+		layout = LAYOUT_BRICK;
+	}
+
+	tIndex padX = dim.width + 2 * border;
+	tIndex padY = dim.height + 2 * border;
+	tIndex padZ = dim.depth + 2 * border;
+
+	strideZ = 1;
+	strideY = strideZ * padZ;
+	strideX = strideY * padY;
+	size = strideX * padX;
+
+	offsets[DIR_NORTH] = -strideZ;
+	offsets[DIR_SOUTH] = strideZ;
+	offsets[DIR_EAST] = strideX;
+	offsets[DIR_WEST] = -strideX;
+	offsets[DIR_UP] = strideY;
+	offsets[DIR_DOWN] = -strideY;
+
+	bricksY = (padY + BRICK_SIZE - 1) / BRICK_SIZE;
+	bricksZ = (padZ + BRICK_SIZE - 1) / BRICK_SIZE;
+
+	if (layout == LAYOUT_MORTON) {
+		// The curve covers a cube with sides of the next power of two
+		tIndex side = 1;
+		while (side < padX || side < padY || side < padZ) { side <<= 1; }
+		size = side * side * side;
+	} else if (layout == LAYOUT_BRICK) {
+		tIndex bricksX = (padX + BRICK_SIZE - 1) / BRICK_SIZE;
+		size = bricksX * bricksY * bricksZ * BRICK_SIZE * BRICK_SIZE * BRICK_SIZE;
+	}
+
+	if (storage == STORAGE_SPARSE) {
+		chunks.assign(size >> (3 * BRICK_BITS), NULL);
+	}
+}
+
+/**
+ * Returns the index of the padded coordinate for the Morton and brick
+ * layouts. Padded coordinates include the border.
+ * @param x, y, z - padded coordinate of the cell
+ * @returns index of the cell in the cell buffer
+ */
+Maze::tIndex Maze::tGrid::layoutIndex(tIndex x, tIndex y, tIndex z) {
+	if (layout == LAYOUT_MORTON) {
+		return mortonEncode(x, y, z);
+	}
+
+	// Bricks are stored linearly, the cells within a brick in Morton order
+	tIndex brick = ((x >> BRICK_BITS) * bricksY + (y >> BRICK_BITS)) * bricksZ + (z >> BRICK_BITS);
+	tIndex mask = BRICK_SIZE - 1;
+	return (brick << (3 * BRICK_BITS)) | mortonEncode(x & mask, y & mask, z & mask);
+}
+
+/**
+ * Returns the padded coordinate of the index for the Morton and
+ * brick layouts.
+ * @param idx - index of the cell in the cell buffer
+ * @returns padded coordinate of the cell
+ */
+Maze::tCoord Maze::tGrid::layoutCoord(tIndex idx) {
+	if (layout == LAYOUT_MORTON) {
+		return tCoord(compactBits(idx >> 2), compactBits(idx >> 1), compactBits(idx));
+	}
+
+	tIndex local = idx & ((1 << (3 * BRICK_BITS)) - 1);
+	tIndex brick = idx >> (3 * BRICK_BITS);
+	tIndex bz = brick % bricksZ;
+	brick /= bricksZ;
+	tIndex by = brick % bricksY;
+	tIndex bx = brick / bricksY;
+
+	return tCoord((bx << BRICK_BITS) | compactBits(local >> 2),
+		(by << BRICK_BITS) | compactBits(local >> 1),
+		(bz << BRICK_BITS) | compactBits(local));
+}
+
+/**
+ * Returns the index of the cell adjacent to the one provided for
+ * the Morton and brick layouts.
+ * @param idx - index of the cell in the cell buffer
+ * @param dir - direction of the neighbor
+ * @returns index of the neighbor
+ */
+Maze::tIndex Maze::tGrid::layoutNeighbor(tIndex idx, eDirection dir) {
+	// Step along a single axis of the Morton code without decoding it. Setting
+	// the other axes' bits lets the carry of an increment skip over them.
+	uint64_t mask = MORTON_Z_MASK;
+	tIndex brickStride = 1;
+	if (dir == DIR_EAST || dir == DIR_WEST) {
+		mask = MORTON_X_MASK;
+		brickStride = bricksY * bricksZ;
+	} else if (dir == DIR_UP || dir == DIR_DOWN) {
+		mask = MORTON_Y_MASK;
+		brickStride = bricksZ;
+	}
+	bool forward = (dir == DIR_SOUTH || dir == DIR_EAST || dir == DIR_UP);
+
+	if (layout == LAYOUT_MORTON) {
+		uint64_t axis = idx & mask;
+		axis = forward ? ((axis | ~mask) + 1) & mask : (axis - 1) & mask;
+		return (idx & ~mask) | axis;
+	}
+
+	// Within a brick only the local Morton code changes. Stepping off of the
+	// brick's edge wraps the local axis around and moves to the next brick.
+	int localBits = 3 * BRICK_BITS;
+	uint64_t localMask = mask & ((1 << localBits) - 1);
+	uint64_t local = idx & ((1 << localBits) - 1);
+	uint64_t axis = local & localMask;
+	tIndex brick = idx >> localBits;
+
+	if (forward) {
+		if (axis == localMask) {
+			brick += brickStride;
+		}
+		axis = ((axis | ~localMask) + 1) & localMask;
+	} else {
+		if (axis == 0) {
+			brick -= brickStride;
+		}
+		axis = (axis - 1) & localMask;
+	}
+	return (brick << localBits) | (local & ~localMask) | axis;
+}
+
+/**
+ * Returns which of the cell's neighbors can be moved into. Bit N of
+ * the mask is set if the neighbor in eDirection N is open.
+ * @param idx - index of the cell, must not be in the border
+ * @returns mask of open neighbors
+ */
+unsigned int Maze::tGrid::openNeighbors(tIndex idx) {
+	unsigned int mask = 0;
+
+	if (storage == STORAGE_PACKED && layout == LAYOUT_LINEAR) {
+		// North and south are the bits on either side of the cell, so a single
+		// read of three bits covers both. The other axes are one bit each.
+		BitLayer::tWord ns = walls.bits(idx - strideZ, 3);
+		unsigned int solid = (ns & 1) << DIR_NORTH | ((ns >> 2) & 1) << DIR_SOUTH;
+		solid |= (unsigned int)walls.test(idx + strideX) << DIR_EAST;
+		solid |= (unsigned int)walls.test(idx - strideX) << DIR_WEST;
+		solid |= (unsigned int)walls.test(idx + strideY) << DIR_UP;
+		solid |= (unsigned int)walls.test(idx - strideY) << DIR_DOWN;
+		return ~solid & ((1 << NUM_DIRECTIONS) - 1);
+	}
+
+	for (int dir=0; dir < NUM_DIRECTIONS; dir++) {
+		if (isOpen(neighbor(idx, (eDirection)dir))) {
+			mask |= 1 << dir;
+		}
+	}
+	return mask;
+}
+
+/**
+ * Updates the state of the cell at the index. Only the static
+ * states, solid, empty, and exit, are stored in the grid.
+ * @param idx - index of the cell
+ * @param s - new state of the cell
+ */
+void Maze::tGrid::setState(tIndex idx, eCell s) {
+	if (s != CELL_SOLID && s != CELL_EXIT) {
+		s = CELL_EMPTY;
+	}
+
+	if (storage == STORAGE_CELLS) {
+		cells[idx].state = s;
+		return;
+	}
+
+	if (storage == STORAGE_SPARSE) {
+		tCell*& chunk = chunks[idx >> (3 * BRICK_BITS)];
+		if (chunk == NULL) {
+			// Solid bricks stay implicit until a cell in them is opened
+			if (s == CELL_SOLID) { return; }
+
+			int chunkSize = 1 << (3 * BRICK_BITS);
+			chunk = new tCell[chunkSize];
+			for (int local=0; local < chunkSize; local++) {
+				chunk[local] = tCell(CELL_SOLID);
+			}
+			numChunks++;
+		}
+		chunk[idx & ((1 << (3 * BRICK_BITS)) - 1)].state = s;
+		return;
+	}
+
+	walls.assign(idx, s == CELL_SOLID);
+	if (s == CELL_EXIT) {
+		exits.insert(idx);
+	} else {
+		exits.erase(idx);
+	}
+}
+
+/**
+ * Records that the cell was opened or walled off, and moves the
+ * grid on to the next version.
+ * @param idx - index of the cell
+ */
+void Maze::tGrid::noteChange(tIndex idx) {
+	version++;
+	changes.push_back(idx);
+	if (changes.size() > MAX_CHANGES) {
+		changes.pop_front();
+	}
+}
+
+/**
+ * Finds the cells opened or walled off since the version provided.
+ * @param since - version of the grid the caller last saw
+ * @param cells - set to the cells changed, oldest first. A cell may
+ *                be listed more than once.
+ * @returns false if older changes were dropped, and the caller must
+ *          treat every cell as changed
+ */
+bool Maze::tGrid::changesSince(unsigned long since, vector<tIndex> &cells) {
+	cells.clear();
+	if (since > version || version - since > changes.size()) { return false; }
+
+	cells.assign(changes.end() - (version - since), changes.end());
+	return true;
+}
+
 /**
  * Creates and returns a new maze grid with the dimenions provided
  * @param dim - the dimenional size of the grid.
+ * @param storage - How the grid's cells will be stored
+ * @param layout - Order of the cells within the grid
+ * @param border - thickness of the solid border padding the grid.
  * @returns a new grid object.
  */
-Maze::tGrid* Maze::createGrid(tDimension dim) {
-	// Create all the cells
-	tCell*** layout = new tCell**[dim.width];
+Maze::tGrid* Maze::createGrid(tDimension dim, eStorage storage, eLayout layout, int border) {
+	tGrid* grid = new tGrid(dim, border, storage, layout);
+
+	// Everything starts out solid, including the border and any padding
+	// the layout needs, so the search never walks outside of the maze.
+	if (storage == STORAGE_SPARSE) {
+		// Sparse mazes stay solid, only the open cells are allocated
+		return grid;
+	} else if (storage == STORAGE_PACKED) {
+		grid->walls.reset(grid->size, true);
+	} else {
+		grid->cells = new tCell[grid->size];
+		for (tIndex idx=0; idx < grid->size; idx++) {
+			grid->cells[idx] = tCell(CELL_SOLID);
+		}
+	}
+
+	// Clear the cells inside of the maze
 	for (int x=0; x < dim.width; x++) {
-		layout[x] = new tCell*[dim.height];
 		for (int y=0; y < dim.height; y++) {
-			layout[x][y] = new tCell[dim.depth];
-			// Initialize the cell coords
 			for (int z=0; z < dim.depth; z++) {
-				layout[x][y][z] = tCell(CELL_EMPTY, tCoord(x, y, z));
+				grid->setState(grid->index(tCoord(x, y, z)), CELL_EMPTY);
 			}
 		}
 	}
 
-	return new tGrid(dim, layout);
-;
+	return grid;
 }
 
 /**
  * Delete the passed in maze grid and reset its pointer valuE to null.
  * @param grid - reference to the pointer containing the grid
- * @param dim - dimensions of the grid to be removed
  */
 void Maze::deleteGrid(tGrid* &grid) {
 	if (grid == NULL) {
 		return;
 	}
 
-	if (grid->layout == NULL) {
-		for (int x=0; x < grid->dim.width; x++) {
-			for (int y=0; y < grid->dim.height; y++) {
-				delete[] grid->layout[x][y];
-			}
-			delete[] grid->layout[x];
-		}
-		delete[] grid->layout;
-		grid->layout = NULL;
+	if (grid->cells != NULL) {
+		delete[] grid->cells;
+		grid->cells = NULL;
+	}
+
+	vector<tCell*>::iterator it;
+	for (it = grid->chunks.begin(); it != grid->chunks.end(); it++) {
+		delete[] *it;
+		*it = NULL;
 	}
 
 	delete grid;
@@ -0,0 +1,69 @@
+#include "packedroute.hpp"
+
+using namespace std;
+
+// Letter of each direction, in eDirection order
+static const char DIRECTION_CHARS[] = "NSEWUD";
+
+/**
+ * Initializes an empty route starting at the coordinate provided
+ * @param start - cell the route starts from
+ */
+PackedRoute::PackedRoute(Maze::tCoord start): m_size(0), m_cursor(0), m_loc(start) {}
+
+/**
+ * Initializes the route from one found by PathFind
+ * @param start - cell the route starts from, not included in the route
+ * @param route - cells of the route, the first step on top. Each must
+ *                be adjacent to the one before it.
+ */
+PackedRoute::PackedRoute(Maze::tCoord start, tRoute route): m_size(0), m_cursor(0), m_loc(start) {
+	m_words.reserve((route.size() + STEPS_PER_WORD - 1) / STEPS_PER_WORD);
+
+	Maze::tCoord loc = start;
+	while (!route.empty()) {
+		Maze::tCoord next = route.top();
+		route.pop();
+
+		for (int dir=0; dir < Maze::NUM_DIRECTIONS; dir++) {
+			if (loc + Maze::step((Maze::eDirection)dir) == next) {
+				append((Maze::eDirection)dir);
+				break;
+			}
+		}
+		loc = next;
+	}
+}
+
+/**
+ * Adds a step to the end of the route
+ * @param dir - direction of the step
+ */
+void PackedRoute::append(Maze::eDirection dir) {
+	if (m_size % STEPS_PER_WORD == 0) {
+		m_words.push_back(0);
+	}
+	m_words.back() |= (uint64_t)dir << ((m_size % STEPS_PER_WORD) * STEP_BITS);
+	m_size++;
+}
+
+/**
+ * Takes the next step, moving the cursor past it
+ */
+void PackedRoute::advance() {
+	if (done()) { return; }
+	m_loc += Maze::step(direction(m_cursor));
+	m_cursor++;
+}
+
+/**
+ * Returns the steps of the route as letters "NSEWUD"
+ */
+string PackedRoute::String() const {
+	string steps;
+	steps.reserve(m_size);
+	for (size_t pos=0; pos < m_size; pos++) {
+		steps += DIRECTION_CHARS[direction(pos)];
+	}
+	return steps;
+}
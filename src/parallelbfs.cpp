@@ -0,0 +1,289 @@
+#include "parallelbfs.hpp"
+
+#include <unistd.h>
+
+using namespace std;
+
+// A level is expanded bottom up once it has more than this fraction of the
+// unvisited open cells, when checking every unvisited cell is cheaper than
+// checking every neighbor of the frontier.
+static const long BOTTOM_UP_RATIO = 14;
+
+/**
+ * Initializes the search for the grid, and starts its threads
+ * @param pGrid - grid of the maze, must outlive the search
+ * @param numThreads - threads to search with, 0 for one per processor
+ */
+ParallelBfs::ParallelBfs(Maze::tGrid* pGrid, int numThreads): m_pGrid(pGrid), m_numThreads(numThreads),
+		m_step(STEP_TOP_DOWN), m_expanded(0), m_bottomUpLevels(0), m_numOpen(0), m_solidVersion(0), m_solidValid(false) {
+	if (m_numThreads <= 0) {
+		m_numThreads = sysconf(_SC_NPROCESSORS_ONLN);
+	}
+	if (m_numThreads <= 0) {
+		m_numThreads = 1;
+	}
+
+	pthread_barrier_init(&m_startBarrier, NULL, m_numThreads);
+	pthread_barrier_init(&m_doneBarrier, NULL, m_numThreads);
+
+	// The workers are never resized, the threads hold pointers to them. The
+	// calling thread does the work of the first.
+	m_workers.resize(m_numThreads);
+	for (int id=0; id < m_numThreads; id++) {
+		m_workers[id].pOwner = this;
+		m_workers[id].id = id;
+		m_workers[id].numOpen = 0;
+		if (id > 0) {
+			pthread_create(&m_workers[id].thread, NULL, &workerMain, &m_workers[id]);
+		}
+	}
+}
+
+/**
+ * Stops the search's threads
+ */
+ParallelBfs::~ParallelBfs() {
+	m_step = STEP_EXIT;
+	if (m_numThreads > 1) {
+		pthread_barrier_wait(&m_startBarrier);
+	}
+	for (int id=1; id < m_numThreads; id++) {
+		pthread_join(m_workers[id].thread, NULL);
+	}
+
+	pthread_barrier_destroy(&m_startBarrier);
+	pthread_barrier_destroy(&m_doneBarrier);
+}
+
+/**
+ * Searches for the destination a level at a time
+ * @param from - starting point of the route
+ * @param dest - destination of the route
+ * @returns the route, not including the starting point. Empty if the
+ *          destination is unreachable.
+ */
+ParallelBfs::tRoute ParallelBfs::findRoute(Maze::tCoord from, Maze::tCoord dest) {
+	tRoute route;
+	m_expanded = 0;
+	m_bottomUpLevels = 0;
+	if (!m_pGrid->contains(from) || !m_pGrid->contains(dest) || from == dest) { return route; }
+
+	if (!m_solidValid || m_solidVersion != m_pGrid->version || m_solid.size() != m_pGrid->size) {
+		m_solid.reset(m_pGrid->size);
+		m_found.reset(m_pGrid->size);
+		m_parentDir.assign(m_pGrid->size, 0);
+		runStep(STEP_SNAPSHOT);
+
+		m_numOpen = 0;
+		for (int id=0; id < m_numThreads; id++) {
+			m_numOpen += m_workers[id].numOpen;
+		}
+		m_solidVersion = m_pGrid->version;
+		m_solidValid = true;
+	}
+
+	Maze::tIndex fromIdx = m_pGrid->index(from);
+	Maze::tIndex destIdx = m_pGrid->index(dest);
+	if (m_solid.test(fromIdx) || m_solid.test(destIdx)) { return route; }
+	m_visited = m_solid;
+	m_visited.set(fromIdx);
+	m_frontier.assign(1, fromIdx);
+
+	long unvisited = m_numOpen - 1;
+	while (!m_frontier.empty() && !m_visited.test(destIdx)) {
+		m_expanded += m_frontier.size();
+
+		if ((long)m_frontier.size() * BOTTOM_UP_RATIO > unvisited) {
+			runStep(STEP_BOTTOM_UP);
+			runStep(STEP_MERGE);
+			m_bottomUpLevels++;
+		} else {
+			runStep(STEP_TOP_DOWN);
+		}
+
+		m_frontier.clear();
+		for (int id=0; id < m_numThreads; id++) {
+			vector<Maze::tIndex> &found = m_workers[id].found;
+			m_frontier.insert(m_frontier.end(), found.begin(), found.end());
+			found.clear();
+		}
+		unvisited -= m_frontier.size();
+	}
+
+	if (!m_visited.test(destIdx)) { return route; }
+
+	// Walk the parent directions back to the starting point
+	Maze::tCoord loc = dest;
+	Maze::tIndex idx = destIdx;
+	while (loc != from) {
+		route.push(loc);
+
+		Maze::eDirection back = Maze::opposite((Maze::eDirection)m_parentDir[idx]);
+		idx = m_pGrid->neighbor(idx, back);
+		loc += Maze::step(back);
+	}
+	return route;
+}
+
+/**
+ * Runs a step on every thread, and waits for them all to finish it
+ * @param step - work to do
+ */
+void ParallelBfs::runStep(eStep step) {
+	m_step = step;
+	if (m_numThreads > 1) {
+		pthread_barrier_wait(&m_startBarrier);
+	}
+	doStep(m_workers[0]);
+	if (m_numThreads > 1) {
+		pthread_barrier_wait(&m_doneBarrier);
+	}
+}
+
+/**
+ * Does the thread's share of the current step
+ * @param worker - thread the work is for
+ */
+void ParallelBfs::doStep(tWorker &worker) {
+	switch (m_step) {
+		case STEP_TOP_DOWN:
+			expandTopDown(worker);
+			break;
+		case STEP_BOTTOM_UP:
+			expandBottomUp(worker);
+			break;
+		case STEP_MERGE:
+			mergeFound(worker);
+			break;
+		case STEP_SNAPSHOT:
+			snapshotSolid(worker);
+			break;
+		default:
+			break;
+	}
+}
+
+/**
+ * Thread entry point, runs steps until asked to exit
+ * @param pArg - the thread's tWorker
+ */
+void* ParallelBfs::workerMain(void* pArg) {
+	tWorker* pWorker = (tWorker*)pArg;
+	ParallelBfs* pOwner = pWorker->pOwner;
+
+	while (true) {
+		pthread_barrier_wait(&pOwner->m_startBarrier);
+		if (pOwner->m_step == STEP_EXIT) { break; }
+
+		pOwner->doStep(*pWorker);
+		pthread_barrier_wait(&pOwner->m_doneBarrier);
+	}
+	return NULL;
+}
+
+/**
+ * Claims the unvisited neighbors of the thread's share of the frontier
+ * @param worker - thread the work is for
+ */
+void ParallelBfs::expandTopDown(tWorker &worker) {
+	size_t first = m_frontier.size() * worker.id / m_numThreads;
+	size_t last = m_frontier.size() * (worker.id + 1) / m_numThreads;
+
+	for (size_t pos=first; pos < last; pos++) {
+		Maze::tIndex idx = m_frontier[pos];
+		for (int dir=0; dir < Maze::NUM_DIRECTIONS; dir++) {
+			Maze::tIndex next = m_pGrid->neighbor(idx, (Maze::eDirection)dir);
+			// Solid cells start out visited. Only test and set atomically
+			// if the cell looks unvisited, another thread may still win it.
+			if (m_visited.test(next) || m_visited.testAndSet(next)) { continue; }
+
+			m_parentDir[next] = dir;
+			worker.found.push_back(next);
+		}
+	}
+}
+
+/**
+ * Checks the thread's share of the unvisited cells for a neighbor in
+ * the frontier. The visited cells are not changed until the merge step,
+ * so every visited neighbor is in the frontier.
+ * @param worker - thread the work is for
+ */
+void ParallelBfs::expandBottomUp(tWorker &worker) {
+	BitLayer::tIndex first, last;
+	wordRange(worker, first, last);
+
+	for (BitLayer::tIndex w=first; w < last; w++) {
+		BitLayer::tWord unvisited = ~m_visited.word(w);
+		BitLayer::tWord found = 0;
+		while (unvisited != 0) {
+			int bit = __builtin_ctzll(unvisited);
+			unvisited &= unvisited - 1;
+			Maze::tIndex idx = w * BitLayer::WORD_BITS + bit;
+			if (idx >= m_pGrid->size) { break; }
+
+			for (int dir=0; dir < Maze::NUM_DIRECTIONS; dir++) {
+				Maze::tIndex next = m_pGrid->neighbor(idx, (Maze::eDirection)dir);
+				if (!m_visited.test(next) || m_solid.test(next)) { continue; }
+
+				found |= (BitLayer::tWord)1 << bit;
+				m_parentDir[idx] = dir ^ 1;
+				worker.found.push_back(idx);
+				break;
+			}
+		}
+		m_found.word(w) = found;
+	}
+}
+
+/**
+ * Marks the cells found bottom up in the thread's share of the grid visited
+ * @param worker - thread the work is for
+ */
+void ParallelBfs::mergeFound(tWorker &worker) {
+	BitLayer::tIndex first, last;
+	wordRange(worker, first, last);
+
+	for (BitLayer::tIndex w=first; w < last; w++) {
+		m_visited.word(w) |= m_found.word(w);
+	}
+}
+
+/**
+ * Finds the solid cells in the thread's share of the grid, and counts
+ * the open ones.
+ * @param worker - thread the work is for
+ */
+void ParallelBfs::snapshotSolid(tWorker &worker) {
+	BitLayer::tIndex first, last;
+	wordRange(worker, first, last);
+
+	worker.numOpen = 0;
+	for (BitLayer::tIndex w=first; w < last; w++) {
+		BitLayer::tWord solid = 0;
+		for (int bit=0; bit < BitLayer::WORD_BITS; bit++) {
+			Maze::tIndex idx = w * BitLayer::WORD_BITS + bit;
+			if (idx >= m_pGrid->size) { break; }
+
+			if (m_pGrid->isOpen(idx)) {
+				worker.numOpen++;
+			} else {
+				solid |= (BitLayer::tWord)1 << bit;
+			}
+		}
+		m_solid.word(w) = solid;
+	}
+}
+
+/**
+ * Returns the range of words of the visited layer a thread works on.
+ * Threads never share a word, so no atomics are needed bottom up.
+ * @param worker - thread the work is for
+ * @param first - set to the first word
+ * @param last - set to one past the last word
+ */
+void ParallelBfs::wordRange(tWorker &worker, BitLayer::tIndex &first, BitLayer::tIndex &last) {
+	BitLayer::tIndex numWords = m_solid.numWords();
+	first = numWords * worker.id / m_numThreads;
+	last = numWords * (worker.id + 1) / m_numThreads;
+}
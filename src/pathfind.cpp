@@ -1,6 +1,7 @@
 #include "pathfind.hpp"
 
 #include <stdlib.h>
+#include <limits.h>
 #include <queue>
 
 using namespace std;
@@ -10,7 +11,13 @@ using namespace std;
  * the starting location of the entity the route will be 
  * calculated for.
  */
-PathFind::PathFind(): m_pGrid(NULL) {}
+PathFind::PathFind(): m_pGrid(NULL), m_strategy(SEARCH_BFS), m_pClusters(NULL), m_pField(NULL), m_pParallel(NULL),
+	m_pJunctions(NULL), m_pCache(NULL), m_pPruned(NULL), m_expanded(0), m_scanned(0), m_pTree(NULL), m_treeVersion(0),
+	m_incKeyOffset(0), m_incVersion(0), m_incValid(false) {}
+
+// Steps to the destination of cells the incremental search hasn't reached,
+// small enough that keys built from it don't overflow.
+static const int UNREACHED = INT_MAX / 4;
 
 /**
  * Sets the grid the pathfinder should use when searching for routes
@@ -19,36 +26,141 @@ PathFind::PathFind(): m_pGrid(NULL) {}
  */
 void PathFind::setGrid(Maze::tGrid* pGrid) {
 	m_pGrid = pGrid;
+	m_pPruned = NULL;
+	m_pTree = NULL;
+	m_incValid = false;
 }
 
 /**
- * The location of the entity has changed.
+ * The location of the entity has changed. If the entity moved to a cell
+ * of the tree the tree search built, that cell becomes the root and the
+ * branches that don't lead from it are pruned. Otherwise the tree is dropped.
  * @param loc - new location of entity
  */
 void PathFind::setLoc(Maze::tCoord loc) {
+	if (m_pTree != NULL && *m_pTree != loc) { reRootTree(loc); }
 	m_curLoc = loc;
 }
 
+/**
+ * Deletes all currently generated routes so new will be calculated next
+ * findRoute().
+ */
+void PathFind::clearRoutes() {
+	m_pTree = NULL;
+	m_incValid = false;
+}
+
 /**
  * Generates a mapping of the grid if one hasn't been generated yet,
  * and searches through the grid for the destintion provided. If
  * The destintaion is unreachable a empty route will be returned.
+ * With a route cache set the route is looked up before searching.
  * @param dest - Coordinate of the destination 
  * @returns the route in cells the 
  */
 PathFind::tRoute PathFind::findRoute(Maze::tCoord dest) {
 	tRoute route;
 
+	m_expanded = 0;
+	m_scanned = 0;
+
 	// If we don't have a grid we cannot calculate a route
 	if (m_pGrid == NULL || m_curLoc == dest) { return route; }
+	if (!m_pGrid->contains(m_curLoc) || !m_pGrid->contains(dest)) { return route; }
+
+	// Routes are only shared through a cache of the same grid
+	RouteCache* pCache = (m_pCache != NULL && m_pCache->getGrid() == m_pGrid) ? m_pCache : NULL;
+	Maze::tIndex fromIdx = m_pGrid->index(m_curLoc);
+	Maze::tIndex destIdx = m_pGrid->index(dest);
+	if (pCache != NULL && pCache->lookup(m_strategy, fromIdx, destIdx, route)) {
+		return route;
+	}
+
+	pruneDeadEnds(fromIdx, Maze::tCoords(1, dest));
+	route = searchRoute(m_curLoc, dest);
+	if (pCache != NULL) {
+		pCache->store(m_strategy, fromIdx, destIdx, route);
+	}
+	return route;
+}
+
+/**
+ * Searches for the destination with the current strategy
+ * @param from starting point in the grid.
+ * @param dest destination of the route.
+ * @returns the route, empty if the destination is unreachable.
+ */
+PathFind::tRoute PathFind::searchRoute(Maze::tCoord from, Maze::tCoord dest) {
+	tRoute route;
+
+	switch (m_strategy) {
+		case SEARCH_TREE:
+			return findTreeRoute(from, dest);
+		case SEARCH_ASTAR:
+			return findAStarRoute(from, dest);
+		case SEARCH_BIDIRECTIONAL:
+			return findBidirectionalRoute(from, dest);
+		case SEARCH_JUMP_POINT:
+			return findJumpPointRoute(from, dest);
+		case SEARCH_HIERARCHICAL:
+			if (m_pClusters != NULL && m_pClusters->isCurrent()) {
+				route = m_pClusters->findRoute(from, dest);
+				m_expanded = m_pClusters->getExpandedCount();
+				return route;
+			}
+			return findBfsRoute(from, dest);
+		case SEARCH_DISTANCE_FIELD:
+			if (m_pField != NULL && m_pField->isCurrent() && m_pField->hasDests(Maze::tCoords(1, dest))) {
+				return m_pField->routeFrom(from);
+			}
+			return findBfsRoute(from, dest);
+		case SEARCH_INCREMENTAL:
+			return findIncrementalRoute(from, dest);
+		case SEARCH_PARALLEL_BFS:
+			if (m_pParallel != NULL) {
+				route = m_pParallel->findRoute(from, dest);
+				m_expanded = m_pParallel->getExpandedCount();
+				return route;
+			}
+			return findBfsRoute(from, dest);
+		case SEARCH_JUNCTION:
+			if (m_pJunctions != NULL && m_pJunctions->isCurrent()) {
+				route = m_pJunctions->findRoute(from, dest);
+				m_expanded = m_pJunctions->getExpandedCount();
+				return route;
+			}
+			return findBfsRoute(from, dest);
+		default:
+			return findBfsRoute(from, dest);
+	}
+}
+
+/**
+ * Searches for the destination by building a tree of PathTree nodes
+ * @param from starting point in the grid.
+ * @param dest destination of the route.
+ * @returns the route, empty if the destination is unreachable.
+ */
+PathFind::tRoute PathFind::findTreeRoute(Maze::tCoord from, Maze::tCoord dest) {
+	tRoute route;
+
+	// The tree kept from the last search already holds the shortest route
+	// to any cell in it. Only generate a new one if the destination isn't.
+	PathTree* pDestNode = NULL;
+	if (m_pTree != NULL && *m_pTree == from && m_treeVersion == m_pGrid->version) {
+		pDestNode = m_treeIndex.find(dest);
+	}
 
 	// Genreate the path tree to the destination
-	PathTree* pDestNode = generatePathTree(m_curLoc, dest);
+	if (pDestNode == NULL) {
+		pDestNode = generatePathTree(from, dest);
+	}
 	if (pDestNode != NULL) {
 		// Walk up the true, building the route that needs to be taken.
 		// Don't include the last node in the route, since that is our current loc
 		while (pDestNode->getParent() != NULL) {
-			route.push(pDestNode->getCell());
+			route.push(pDestNode->getLoc());
 			pDestNode = pDestNode->getParent();
 		}
 	}
@@ -56,35 +168,764 @@ PathFind::tRoute PathFind::findRoute(Maze::tCoord dest) {
 	return route;
 }
 
+/**
+ * Searches for the nearest of several destinations. A single destination
+ * is searched for with the strategy as findRoute() does. Otherwise the
+ * distance field search uses its field if it was built to the same
+ * destinations, and every other strategy searches breadth first until
+ * any destination is reached.
+ * @param dests - Coordinates of the destinations
+ * @param dest - set to the destination the route leads to
+ * @returns the route, empty if no destination is reachable.
+ */
+PathFind::tRoute PathFind::findNearestRoute(const Maze::tCoords &dests, Maze::tCoord &dest) {
+	if (dests.size() == 1) {
+		dest = dests.front();
+		return findRoute(dest);
+	}
+
+	m_expanded = 0;
+	m_scanned = 0;
+	if (m_pGrid == NULL || !m_pGrid->contains(m_curLoc)) { return tRoute(); }
+
+	if (m_strategy == SEARCH_DISTANCE_FIELD && m_pField != NULL && m_pField->isCurrent() &&
+			m_pField->hasDests(dests)) {
+		return m_pField->routeFrom(m_curLoc, dest);
+	}
+	pruneDeadEnds(m_pGrid->index(m_curLoc), dests);
+	return findNearestBfsRoute(m_curLoc, dests, dest);
+}
+
+/**
+ * Searches breadth first for a route to the nearest of the destinations
+ * that doesn't pass through the cells provided, as if they were walled
+ * off. Used to get around entities blocking a route, so the route
+ * cache and the kept search state are neither used nor changed.
+ * @param dests - Coordinates of the destinations
+ * @param blocked - indexes of the cells to keep out of
+ * @param dest - set to the destination the route leads to
+ * @returns the route, empty if no destination can be reached.
+ */
+PathFind::tRoute PathFind::findDetour(const Maze::tCoords &dests, const Maze::tIndexSet &blocked, Maze::tCoord &dest) {
+	m_expanded = 0;
+	m_scanned = 0;
+	if (m_pGrid == NULL || !m_pGrid->contains(m_curLoc)) { return tRoute(); }
+
+	pruneDeadEnds(m_pGrid->index(m_curLoc), dests);
+	return findNearestBfsRoute(m_curLoc, dests, dest, &blocked);
+}
+
+/**
+ * Searches for the destination breadth first, tracking visited cells
+ * and their parents in flat arrays indexed by cell.
+ * @param from starting point in the grid.
+ * @param dest destination of the route.
+ * @returns the route, empty if the destination is unreachable.
+ */
+PathFind::tRoute PathFind::findBfsRoute(Maze::tCoord from, Maze::tCoord dest) {
+	resetScratch(true);
+
+	Maze::tIndex destIdx = m_pGrid->index(dest);
+	Maze::tIndex fromIdx = m_pGrid->index(from);
+	m_visited.set(fromIdx);
+	m_frontier.push_back(fromIdx);
+
+	// The frontier is only appended to, so it doubles as the queue. Each
+	// cell is queued at most once.
+	for (size_t head=0; head < m_frontier.size(); head++) {
+		Maze::tIndex idx = m_frontier[head];
+		m_expanded++;
+
+		// The grid's solid border keeps the neighbors inside of the grid.
+		for (int dir=0; dir < Maze::NUM_DIRECTIONS; dir++) {
+			Maze::tIndex next = m_pGrid->neighbor(idx, (Maze::eDirection)dir);
+			if (m_visited.test(next) || !m_pGrid->isOpen(next)) { continue; }
+
+			m_visited.set(next);
+			m_parentDir[next] = dir;
+			if (next == destIdx) {
+				return buildRoute(from, dest);
+			}
+			m_frontier.push_back(next);
+		}
+	}
+
+	return tRoute();
+}
+
+/**
+ * Searches breadth first until the first of the destinations is reached
+ * @param from starting point in the grid.
+ * @param dests destinations of the route.
+ * @param dest set to the destination reached.
+ * @param pBlocked - cells to keep out of, NULL for none
+ * @returns the route, empty if no destination is reachable.
+ */
+PathFind::tRoute PathFind::findNearestBfsRoute(Maze::tCoord from, const Maze::tCoords &dests, Maze::tCoord &dest,
+		const Maze::tIndexSet* pBlocked) {
+	resetScratch(true);
+
+	// Blocked cells start out visited, so they are never entered
+	if (pBlocked != NULL) {
+		Maze::tIndexSet::const_iterator bIt;
+		for (bIt = pBlocked->begin(); bIt != pBlocked->end(); bIt++) {
+			m_visited.set(*bIt);
+		}
+	}
+	if (m_targets.size() != m_pGrid->size) {
+		m_targets.reset(m_pGrid->size);
+	}
+
+	// Mark the destinations, a bit per cell so checking each cell reached
+	// costs the same however many destinations there are.
+	vector<Maze::tIndex> marked;
+	Maze::tCoords::const_iterator cIt;
+	for (cIt = dests.begin(); cIt != dests.end(); cIt++) {
+		if (!m_pGrid->contains(*cIt)) { continue; }
+		Maze::tIndex idx = m_pGrid->index(*cIt);
+		m_targets.set(idx);
+		marked.push_back(idx);
+	}
+
+	Maze::tIndex fromIdx = m_pGrid->index(from);
+	Maze::tIndex found = m_targets.test(fromIdx) ? fromIdx : -1;
+	m_visited.set(fromIdx);
+	m_frontier.push_back(fromIdx);
+
+	for (size_t head=0; head < m_frontier.size() && found < 0; head++) {
+		Maze::tIndex idx = m_frontier[head];
+		m_expanded++;
+
+		// The grid's solid border keeps the neighbors inside of the grid.
+		for (int dir=0; dir < Maze::NUM_DIRECTIONS; dir++) {
+			Maze::tIndex next = m_pGrid->neighbor(idx, (Maze::eDirection)dir);
+			if (m_visited.test(next) || !m_pGrid->isOpen(next)) { continue; }
+
+			m_visited.set(next);
+			m_parentDir[next] = dir;
+			if (m_targets.test(next)) {
+				found = next;
+				break;
+			}
+			m_frontier.push_back(next);
+		}
+	}
+
+	for (size_t idx=0; idx < marked.size(); idx++) {
+		m_targets.clear(marked[idx]);
+	}
+
+	if (found < 0) { return tRoute(); }
+	dest = m_pGrid->coord(found);
+	return buildRoute(from, dest);
+}
+
+/**
+ * Searches for the destination with A*, expanding the cells with the
+ * shortest estimated route first. The estimate is the manhattan distance
+ * to the destination, and open cells are kept in buckets by their
+ * estimated route length instead of a heap.
+ * @param from starting point in the grid.
+ * @param dest destination of the route.
+ * @returns the route, empty if the destination is unreachable.
+ */
+PathFind::tRoute PathFind::findAStarRoute(Maze::tCoord from, Maze::tCoord dest) {
+	resetScratch();
+	if (m_cost.size() != (size_t)m_pGrid->size) {
+		m_cost.resize(m_pGrid->size);
+	}
+
+	// m_visited marks the cells which have a cost, the cost of unvisited
+	// cells is left stale from earlier searches.
+	Maze::tIndex destIdx = m_pGrid->index(dest);
+	Maze::tIndex fromIdx = m_pGrid->index(from);
+	m_visited.set(fromIdx);
+	m_cost[fromIdx] = 0;
+
+	size_t estimate = from.distance(dest);
+	if (m_buckets.size() <= estimate) { m_buckets.resize(estimate + 1); }
+	m_buckets[estimate].push_back(fromIdx);
+
+	// The manhattan distance never overestimates, and changes by one each
+	// step, so the estimates popped never decrease and the first time a
+	// cell is popped its cost is final. Cells whose cost was lowered after
+	// being bucketed are left in the old bucket and skipped when popped.
+	for (; estimate < m_buckets.size(); estimate++) {
+		// Popping the newest cell first prefers cells further along
+		// their route when estimates tie. The buckets may be resized
+		// while expanding, so no reference to the bucket is held.
+		while (!m_buckets[estimate].empty()) {
+			Maze::tIndex idx = m_buckets[estimate].back();
+			m_buckets[estimate].pop_back();
+
+			Maze::tCoord loc = m_pGrid->coord(idx);
+			int cost = m_cost[idx];
+			if (cost + loc.distance(dest) != (int)estimate) { continue; }
+			m_expanded++;
+
+			if (idx == destIdx) {
+				// Leave no stale cells behind for the next search
+				for (; estimate < m_buckets.size(); estimate++) {
+					m_buckets[estimate].clear();
+				}
+				return buildRoute(from, dest);
+			}
+
+			for (int dir=0; dir < Maze::NUM_DIRECTIONS; dir++) {
+				Maze::tIndex next = m_pGrid->neighbor(idx, (Maze::eDirection)dir);
+				if (m_visited.test(next) && m_cost[next] <= cost + 1) { continue; }
+				if (!m_pGrid->isOpen(next) || (m_pPruned != NULL && m_pPruned->test(next))) { continue; }
+
+				m_visited.set(next);
+				m_cost[next] = cost + 1;
+				m_parentDir[next] = dir;
+
+				size_t nextEstimate = cost + 1 + (loc + Maze::step((Maze::eDirection)dir)).distance(dest);
+				if (m_buckets.size() <= nextEstimate) { m_buckets.resize(nextEstimate + 1); }
+				m_buckets[nextEstimate].push_back(next);
+			}
+		}
+	}
+
+	return tRoute();
+}
+
+/**
+ * Searches breadth first from both the starting point and the
+ * destination, a level at a time from whichever side has the smaller
+ * frontier, until the two searches meet.
+ * @param from starting point in the grid.
+ * @param dest destination of the route.
+ * @returns the route, empty if the destination is unreachable.
+ */
+PathFind::tRoute PathFind::findBidirectionalRoute(Maze::tCoord from, Maze::tCoord dest) {
+	resetScratch(true);
+	if (m_parentDirBack.size() != (size_t)m_pGrid->size) {
+		m_parentDirBack.assign(m_pGrid->size, 0);
+	}
+	if (m_pPruned != NULL) {
+		m_visitedBack = *m_pPruned;
+	} else if (m_visitedBack.size() != m_pGrid->size) {
+		m_visitedBack.reset(m_pGrid->size);
+	} else {
+		m_visitedBack.fill(false);
+	}
+	m_frontierBack.clear();
+
+	Maze::tIndex fromIdx = m_pGrid->index(from);
+	Maze::tIndex destIdx = m_pGrid->index(dest);
+	m_visited.set(fromIdx);
+	m_frontier.push_back(fromIdx);
+	m_visitedBack.set(destIdx);
+	m_frontierBack.push_back(destIdx);
+
+	// Each side only stops part way through a level when it reaches the
+	// other side, so before a level is expanded each side has visited every
+	// cell within its depth. The first cell found by both sides is therefore
+	// on a shortest route.
+	size_t head = 0;
+	size_t headBack = 0;
+	Maze::tIndex meet = -1;
+	while (meet < 0 && head < m_frontier.size() && headBack < m_frontierBack.size()) {
+		if (m_frontier.size() - head <= m_frontierBack.size() - headBack) {
+			meet = expandLevel(m_frontier, head, m_visited, m_parentDir, m_visitedBack);
+		} else {
+			meet = expandLevel(m_frontierBack, headBack, m_visitedBack, m_parentDirBack, m_visited);
+		}
+	}
+	if (meet < 0) { return tRoute(); }
+
+	// Walk from where the sides met to the destination, then build the
+	// rest of the route back to the start on top of it.
+	Maze::tCoord meetLoc = m_pGrid->coord(meet);
+	vector<Maze::tCoord> tail;
+	Maze::tCoord loc = meetLoc;
+	Maze::tIndex idx = meet;
+	while (loc != dest) {
+		Maze::eDirection toward = Maze::opposite((Maze::eDirection)m_parentDirBack[idx]);
+		idx = m_pGrid->neighbor(idx, toward);
+		loc += Maze::step(toward);
+		tail.push_back(loc);
+	}
+
+	tRoute route;
+	vector<Maze::tCoord>::reverse_iterator rIt;
+	for (rIt = tail.rbegin(); rIt != tail.rend(); rIt++) {
+		route.push(*rIt);
+	}
+	return buildRoute(from, meetLoc, route);
+}
+
+/**
+ * Expands every cell in the current level of one side of the
+ * bidirectional search, stopping early if the other side is reached.
+ * @param frontier - cells queued by this side
+ * @param head - position of the first unexpanded cell in the frontier
+ * @param visited - cells visited by this side
+ * @param parentDir - direction each cell was reached from by this side
+ * @param otherVisited - cells visited by the other side
+ * @returns the cell where the sides met, or -1 if they haven't
+ */
+Maze::tIndex PathFind::expandLevel(vector<Maze::tIndex> &frontier, size_t &head, BitLayer &visited,
+		vector<unsigned char> &parentDir, BitLayer &otherVisited) {
+	size_t levelEnd = frontier.size();
+	for (; head < levelEnd; head++) {
+		Maze::tIndex idx = frontier[head];
+		m_expanded++;
+
+		for (int dir=0; dir < Maze::NUM_DIRECTIONS; dir++) {
+			Maze::tIndex next = m_pGrid->neighbor(idx, (Maze::eDirection)dir);
+			if (visited.test(next) || !m_pGrid->isOpen(next)) { continue; }
+
+			visited.set(next);
+			parentDir[next] = dir;
+			if (otherVisited.test(next)) {
+				return next;
+			}
+			frontier.push_back(next);
+		}
+	}
+
+	return -1;
+}
+
+/**
+ * Returns the order the axis of a direction is moved along in canonical
+ * jump point routes. Y is moved along first, then Z, then X.
+ * @param dir - direction to rank
+ * @returns rank of the direction's axis
+ */
+static int axisRank(int dir) {
+	static const int ranks[Maze::NUM_DIRECTIONS] = { 1, 1, 2, 2, 0, 0 };
+	return ranks[dir];
+}
+
+/**
+ * Searches for the destination with A* over jump points. Routes are
+ * kept in a canonical order, moving along the Y axis first, then Z,
+ * then X, and only turning onto an earlier axis where a wall forces
+ * it. Straight runs of cells are jumped over without being queued.
+ * @param from starting point in the grid.
+ * @param dest destination of the route.
+ * @returns the route, empty if the destination is unreachable.
+ */
+PathFind::tRoute PathFind::findJumpPointRoute(Maze::tCoord from, Maze::tCoord dest) {
+	resetScratch();
+	if (m_cost.size() != (size_t)m_pGrid->size) {
+		m_cost.resize(m_pGrid->size);
+	}
+
+	// Only jump points are visited, their parent direction is the
+	// direction of the jump that reached them.
+	Maze::tIndex destIdx = m_pGrid->index(dest);
+	Maze::tIndex fromIdx = m_pGrid->index(from);
+	m_visited.set(fromIdx);
+	m_cost[fromIdx] = 0;
+	m_parentDir[fromIdx] = Maze::NUM_DIRECTIONS;
+
+	size_t estimate = from.distance(dest);
+	if (m_buckets.size() <= estimate) { m_buckets.resize(estimate + 1); }
+	m_buckets[estimate].push_back(fromIdx);
+
+	// Same bucketed A* as findAStarRoute(), with each jump's length as its cost
+	for (; estimate < m_buckets.size(); estimate++) {
+		while (!m_buckets[estimate].empty()) {
+			Maze::tIndex idx = m_buckets[estimate].back();
+			m_buckets[estimate].pop_back();
+
+			Maze::tCoord loc = m_pGrid->coord(idx);
+			int cost = m_cost[idx];
+			if (cost + loc.distance(dest) != (int)estimate) { continue; }
+			m_expanded++;
+
+			if (idx == destIdx) {
+				for (; estimate < m_buckets.size(); estimate++) {
+					m_buckets[estimate].clear();
+				}
+				return buildJumpPointRoute(from, dest);
+			}
+
+			// Continuing straight or turning onto a later axis is always
+			// canonical. Turning onto an earlier axis is only needed if the
+			// cell before this one couldn't turn there itself.
+			int arrived = m_parentDir[idx];
+			Maze::tIndex prev = -1;
+			if (arrived != Maze::NUM_DIRECTIONS) {
+				prev = m_pGrid->neighbor(idx, Maze::opposite((Maze::eDirection)arrived));
+			}
+			for (int dir=0; dir < Maze::NUM_DIRECTIONS; dir++) {
+				if (prev >= 0) {
+					if (dir == Maze::opposite((Maze::eDirection)arrived)) { continue; }
+					if (axisRank(dir) < axisRank(arrived) &&
+						m_pGrid->isOpen(m_pGrid->neighbor(prev, (Maze::eDirection)dir))) { continue; }
+				}
+
+				int steps = 0;
+				Maze::tIndex next = jump(idx, (Maze::eDirection)dir, destIdx, steps);
+				if (next < 0) { continue; }
+				if (m_visited.test(next) && m_cost[next] <= cost + steps) { continue; }
+
+				m_visited.set(next);
+				m_cost[next] = cost + steps;
+				m_parentDir[next] = dir;
+
+				Maze::tCoord nextLoc = loc;
+				Maze::tCoord offset = Maze::step((Maze::eDirection)dir);
+				nextLoc += Maze::tCoord(offset.x * steps, offset.y * steps, offset.z * steps);
+				size_t nextEstimate = cost + steps + nextLoc.distance(dest);
+				if (m_buckets.size() <= nextEstimate) { m_buckets.resize(nextEstimate + 1); }
+				m_buckets[nextEstimate].push_back(next);
+			}
+		}
+	}
+
+	return tRoute();
+}
+
+/**
+ * Moves from the cell in the direction provided until reaching a jump
+ * point: the destination, a cell with a forced neighbor, or a cell from
+ * which a jump along a later axis reaches a jump point.
+ * @param idx - cell to jump from
+ * @param dir - direction to jump in
+ * @param destIdx - destination of the search
+ * @param steps - set to the number of cells jumped
+ * @returns the jump point, or -1 if a wall was reached first
+ */
+Maze::tIndex PathFind::jump(Maze::tIndex idx, Maze::eDirection dir, Maze::tIndex destIdx, int &steps) {
+	steps = 0;
+	while (true) {
+		idx = m_pGrid->neighbor(idx, dir);
+		m_scanned++;
+		if (!m_pGrid->isOpen(idx)) { return -1; }
+		steps++;
+
+		if (idx == destIdx || hasForcedNeighbor(idx, dir)) { return idx; }
+
+		// Turning onto a later axis is canonical, so if a jump that way
+		// finds a jump point the route turns here.
+		for (int later=0; later < Maze::NUM_DIRECTIONS; later++) {
+			int laterSteps = 0;
+			if (axisRank(later) > axisRank(dir) && jump(idx, (Maze::eDirection)later, destIdx, laterSteps) >= 0) {
+				return idx;
+			}
+		}
+	}
+}
+
+/**
+ * Checks if a cell reached by moving in the direction provided has an
+ * open neighbor along an earlier axis that the previous cell didn't.
+ * A canonical route can only turn onto it from this cell.
+ * @param idx - cell to check
+ * @param dir - direction the cell was entered in
+ * @returns true if the cell has a forced neighbor
+ */
+bool PathFind::hasForcedNeighbor(Maze::tIndex idx, Maze::eDirection dir) {
+	Maze::tIndex prev = m_pGrid->neighbor(idx, Maze::opposite(dir));
+	for (int earlier=0; earlier < Maze::NUM_DIRECTIONS; earlier++) {
+		if (axisRank(earlier) >= axisRank(dir)) { continue; }
+		if (m_pGrid->isOpen(m_pGrid->neighbor(idx, (Maze::eDirection)earlier)) &&
+			!m_pGrid->isOpen(m_pGrid->neighbor(prev, (Maze::eDirection)earlier))) {
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+ * Builds the route from jump point search results, filling in the
+ * cells jumped over between each jump point and its parent.
+ * @param from starting point in the grid.
+ * @param dest destination of the route, must have been reached.
+ * @returns the route, not including the starting point.
+ */
+PathFind::tRoute PathFind::buildJumpPointRoute(Maze::tCoord from, Maze::tCoord dest) {
+	tRoute route;
+
+	// Walk back along each jump until reaching a jump point whose cost
+	// matches the steps walked. It is either the parent, or another jump
+	// point the same distance from the start.
+	Maze::tCoord loc = dest;
+	Maze::tIndex idx = m_pGrid->index(dest);
+	while (loc != from) {
+		Maze::eDirection back = Maze::opposite((Maze::eDirection)m_parentDir[idx]);
+		int cost = m_cost[idx];
+		do {
+			route.push(loc);
+			idx = m_pGrid->neighbor(idx, back);
+			loc += Maze::step(back);
+			cost--;
+		} while (!m_visited.test(idx) || m_cost[idx] != cost);
+	}
+
+	return route;
+}
+
+/**
+ * Finds the route with D* Lite. The search runs from the destination
+ * toward the starting point and is kept between calls, so when only the
+ * starting point moves or a few cells change only the cells whose
+ * distance to the destination changed are expanded again.
+ * @param from starting point in the grid.
+ * @param dest destination of the route.
+ * @returns the route, empty if the destination is unreachable.
+ */
+PathFind::tRoute PathFind::findIncrementalRoute(Maze::tCoord from, Maze::tCoord dest) {
+	// Start over if the search was for another destination or grid, or
+	// the grid has changed too much since to know which cells changed.
+	if (!m_incValid || m_incDest != dest || (Maze::tIndex)m_incDist.size() != m_pGrid->size ||
+			!m_pGrid->changesSince(m_incVersion, m_incChanged)) {
+		resetIncremental(from, dest);
+	}
+
+	Maze::tIndex destIdx = m_pGrid->index(dest);
+	Maze::tIndex fromIdx = m_pGrid->index(from);
+
+	// The keys already queued were estimated from the old starting point,
+	// and are low by at most the distance it moved. Raising the keys of
+	// every cell queued from now on by that much keeps the queue in order.
+	m_incKeyOffset += m_incLast.distance(from);
+	m_incLast = from;
+	m_incVersion = m_pGrid->version;
+
+	// Opening or walling off a cell changes the steps through it
+	for (vector<Maze::tIndex>::iterator it=m_incChanged.begin(); it != m_incChanged.end(); it++) {
+		updateIncremental(*it, destIdx);
+		for (int dir=0; dir < Maze::NUM_DIRECTIONS; dir++) {
+			updateIncremental(m_pGrid->neighbor(*it, (Maze::eDirection)dir), destIdx);
+		}
+	}
+	m_incChanged.clear();
+
+	// Settle the inconsistent cells in key order until the starting point's
+	// distance is known to be correct.
+	while (!m_incOpen.empty()) {
+		tOpenCell top = m_incOpen.top();
+		Maze::tIndex idx = top.idx;
+
+		// Cells are queued again rather than having their keys updated, skip
+		// the copies of cells that have since been settled.
+		if (m_incDist[idx] == m_incLookahead[idx]) {
+			m_incOpen.pop();
+			continue;
+		}
+		if (m_incDist[fromIdx] == m_incLookahead[fromIdx] && !(incrementalKey(fromIdx, from) > top)) {
+			break;
+		}
+		m_incOpen.pop();
+
+		tOpenCell key = incrementalKey(idx, from);
+		if (key > top) {
+			m_incOpen.push(key);
+			continue;
+		}
+
+		m_expanded++;
+		if (m_incDist[idx] > m_incLookahead[idx]) {
+			m_incDist[idx] = m_incLookahead[idx];
+		} else {
+			// The cell's route got longer, settle it again from its neighbors
+			m_incDist[idx] = UNREACHED;
+			updateIncremental(idx, destIdx);
+		}
+		for (int dir=0; dir < Maze::NUM_DIRECTIONS; dir++) {
+			updateIncremental(m_pGrid->neighbor(idx, (Maze::eDirection)dir), destIdx);
+		}
+	}
+
+	tRoute route;
+	if (m_incDist[fromIdx] >= UNREACHED) { return route; }
+
+	// Step to a neighbor one step closer until the destination is reached
+	vector<Maze::tCoord> cells;
+	Maze::tCoord loc = from;
+	Maze::tIndex idx = fromIdx;
+	while (idx != destIdx) {
+		int dir = 0;
+		for (; dir < Maze::NUM_DIRECTIONS; dir++) {
+			Maze::tIndex next = m_pGrid->neighbor(idx, (Maze::eDirection)dir);
+			if (m_pGrid->isOpen(next) && m_incDist[next] == m_incDist[idx] - 1) { break; }
+		}
+		if (dir == Maze::NUM_DIRECTIONS) {
+			// The distances are inconsistent, start over on the next search
+			// rather than guess at a route.
+			resetIncremental(from, dest);
+			return route;
+		}
+		idx = m_pGrid->neighbor(idx, (Maze::eDirection)dir);
+		loc += Maze::step((Maze::eDirection)dir);
+		cells.push_back(loc);
+	}
+
+	for (vector<Maze::tCoord>::reverse_iterator it=cells.rbegin(); it != cells.rend(); it++) {
+		route.push(*it);
+	}
+	return route;
+}
+
+/**
+ * Discards the incremental search state and starts a new search from
+ * the destination.
+ * @param from starting point in the grid.
+ * @param dest destination of the route.
+ */
+void PathFind::resetIncremental(Maze::tCoord from, Maze::tCoord dest) {
+	m_incDist.assign(m_pGrid->size, UNREACHED);
+	m_incLookahead.assign(m_pGrid->size, UNREACHED);
+	m_incOpen = tOpenQueue();
+	m_incChanged.clear();
+	m_incDest = dest;
+	m_incLast = from;
+	m_incKeyOffset = 0;
+	m_incVersion = m_pGrid->version;
+	m_incValid = true;
+
+	Maze::tIndex destIdx = m_pGrid->index(dest);
+	if (m_pGrid->isOpen(destIdx)) {
+		m_incLookahead[destIdx] = 0;
+		m_incOpen.push(incrementalKey(destIdx, from));
+	}
+}
+
+/**
+ * Recalculates the cell's lookahead from its neighbors, and queues
+ * the cell if it no longer matches the cell's distance.
+ * @param idx - cell to update
+ * @param destIdx - destination of the search
+ */
+void PathFind::updateIncremental(Maze::tIndex idx, Maze::tIndex destIdx) {
+	int lookahead = UNREACHED;
+	if (!m_pGrid->isOpen(idx)) {
+		// Walled off cells can't be passed through
+	} else if (idx == destIdx) {
+		lookahead = 0;
+	} else {
+		for (int dir=0; dir < Maze::NUM_DIRECTIONS; dir++) {
+			Maze::tIndex next = m_pGrid->neighbor(idx, (Maze::eDirection)dir);
+			if (m_pGrid->isOpen(next) && m_incDist[next] + 1 < lookahead) {
+				lookahead = m_incDist[next] + 1;
+			}
+		}
+	}
+
+	m_incLookahead[idx] = lookahead;
+	if (m_incDist[idx] != lookahead) {
+		m_incOpen.push(incrementalKey(idx, m_incLast));
+	}
+}
+
+/**
+ * Returns the queue key of a cell in the incremental search
+ * @param idx - cell to key
+ * @param from - starting point of the route
+ * @returns key of the cell
+ */
+PathFind::tOpenCell PathFind::incrementalKey(Maze::tIndex idx, Maze::tCoord from) {
+	int dist = m_incDist[idx] < m_incLookahead[idx] ? m_incDist[idx] : m_incLookahead[idx];
+	return tOpenCell(dist + from.distance(m_pGrid->coord(idx)) + m_incKeyOffset, dist, idx);
+}
+
+/**
+ * Picks the dead ends the next search may skip. They are only skipped
+ * if they were filled since the grid last changed, and no end of the
+ * route is one of them.
+ * @param fromIdx - starting point of the route
+ * @param dests - destinations of the route
+ */
+void PathFind::pruneDeadEnds(Maze::tIndex fromIdx, const Maze::tCoords &dests) {
+	m_pPruned = NULL;
+	if (!m_pGrid->hasDeadEnds() || m_pGrid->deadEnds.test(fromIdx)) { return; }
+
+	Maze::tCoords::const_iterator cIt;
+	for (cIt = dests.begin(); cIt != dests.end(); cIt++) {
+		if (m_pGrid->contains(*cIt) && m_pGrid->deadEnds.test(m_pGrid->index(*cIt))) { return; }
+	}
+	m_pPruned = &m_pGrid->deadEnds;
+}
+
+/**
+ * Sizes the search scratch space for the grid, and clears the visited cells.
+ * @param skipDeadEnds - if the dead ends picked by pruneDeadEnds() should
+ *                       start out visited, so they are never entered
+ */
+void PathFind::resetScratch(bool skipDeadEnds) {
+	if (m_parentDir.size() != (size_t)m_pGrid->size) {
+		m_parentDir.assign(m_pGrid->size, 0);
+	}
+	if (skipDeadEnds && m_pPruned != NULL) {
+		m_visited = *m_pPruned;
+	} else if (m_visited.size() != m_pGrid->size) {
+		m_visited.reset(m_pGrid->size);
+	} else {
+		m_visited.fill(false);
+	}
+	m_frontier.clear();
+}
+
+/**
+ * Builds the route by walking the parent directions back from the
+ * destination until the starting cell is reached.
+ * @param from starting point in the grid.
+ * @param dest destination of the route, must have been visited.
+ * @param route - steps already known past the destination, the route
+ *                to the destination is added on top of them.
+ * @returns the route, not including the starting point.
+ */
+PathFind::tRoute PathFind::buildRoute(Maze::tCoord from, Maze::tCoord dest, tRoute route) {
+	Maze::tCoord loc = dest;
+	Maze::tIndex idx = m_pGrid->index(dest);
+	while (loc != from) {
+		route.push(loc);
+
+		Maze::eDirection back = Maze::opposite((Maze::eDirection)m_parentDir[idx]);
+		idx = m_pGrid->neighbor(idx, back);
+		loc += Maze::step(back);
+	}
+
+	return route;
+}
 
 /**
  * Search over the grid, building the tree starting at the current location.
  * The pathfinder's current location and grid are used to generate the tree.
+ * The last search's tree is freed and the new one is built in its place.
  * @param from starting point in the grid.
  * @param dest destination the routes are being generated to reach.
- * @returns the tree of routes.
+ * @returns the destination's node in the tree, NULL if it wasn't reached.
  */
 PathTree* PathFind::generatePathTree(Maze::tCoord from, Maze::tCoord dest) {
-	PathTree* root = new PathTree(NULL, m_pGrid->at(from));
+	m_treeArena.release();
+	Maze::tDimension dim = m_treeIndex.getDim();
+	if (dim.width != m_pGrid->dim.width || dim.height != m_pGrid->dim.height || dim.depth != m_pGrid->dim.depth) {
+		m_treeIndex.reset(m_pGrid->dim);
+	} else {
+		m_treeIndex.clear();
+	}
+	m_pTree = PathTree::create(&m_treeArena, NULL, from);
+	m_pTree->setIndex(&m_treeIndex);
+	m_treeVersion = m_pGrid->version;
 	tTreeNodeQueue nodeQ;
-	nodeQ.push(root);
+	nodeQ.push(m_pTree);
 
 	PathTree* pNode = NULL;
 	while (!nodeQ.empty()) {
 		pNode = nodeQ.front();
 		nodeQ.pop();
+		m_expanded++;
 
 		if (*pNode == dest) { break; }
 		// Get the 6 adjacent cells adding them to the tree Only add cells which are not solid.  If the cell
 		// is the destination terminate there.
 
-		Maze::tCoord curCoord = pNode->getCell()->coord;
-		queueValidNodeAtCoord(pNode, curCoord + Maze::tCoord(0,0,-1), nodeQ); // North
-		queueValidNodeAtCoord(pNode, curCoord + Maze::tCoord(0,0,1), nodeQ);  // South
-		queueValidNodeAtCoord(pNode, curCoord + Maze::tCoord(1,0,0), nodeQ);  // East
-		queueValidNodeAtCoord(pNode, curCoord + Maze::tCoord(-1,0,0), nodeQ); // West
-		queueValidNodeAtCoord(pNode, curCoord + Maze::tCoord(0,1,0), nodeQ);  // Up
-		queueValidNodeAtCoord(pNode, curCoord + Maze::tCoord(0,-1,0), nodeQ); // Down
+		// The grid's solid border guarantees every neighbor is inside the grid.
+		Maze::tCoord curLoc = pNode->getLoc();
+		unsigned int open = m_pGrid->openNeighbors(m_pGrid->index(curLoc));
+		for (int dir=0; dir < Maze::NUM_DIRECTIONS; dir++) {
+			if (open & (1 << dir)) {
+				queueValidNode(pNode, curLoc + Maze::step((Maze::eDirection)dir), nodeQ);
+			}
+		}
 
 		pNode = NULL;
 	}
@@ -93,25 +934,55 @@ PathTree* PathFind::generatePathTree(Maze::tCoord from, Maze::tCoord dest) {
 }
 
 /**
- * Queues up a new node, while also adding it to the node tree.
+ * Makes the cell the root of the tree search's tree, pruning every
+ * branch that doesn't lead from it. Routes through the rest of the
+ * tree aren't the shortest from the cell, but every route down from
+ * it is a part of a shortest route from the old root, so is still the
+ * shortest. The tree is dropped if the cell isn't in it, or the grid
+ * has changed since it was built.
+ * @param loc - cell to make the root
+ */
+void PathFind::reRootTree(Maze::tCoord loc) {
+	PathTree* pNode = NULL;
+	if (m_pGrid != NULL && m_treeVersion == m_pGrid->version) {
+		pNode = m_treeIndex.find(loc);
+	}
+	if (pNode == NULL) {
+		m_pTree = NULL;
+		return;
+	}
+
+	// The old root's side of the tree ends up as the new root's last child.
+	// Its nodes stay in the arena until the next tree is generated.
+	PathTree* pParent = pNode->getParent();
+	pNode->makeRoot();
+	pParent->detach();
+	m_pTree = pNode;
+}
+
+/**
+ * Queues up a new node, while also adding it to the node tree. The cell
+ * must already be known to not be solid, and is skipped if it is already
+ * in the tree. Occupied cells are valid, because we expect the entity to
+ * be taking that cell to move.
  * @param parent node in the tree this is being appened to.
- * @param new coord to get get the cell from
+ * @param loc location of the cell the new node will represent
  * @param queye where the node will be added to, if valid
- * @returns the node if it was created, and it is not already an ancestor.
+ * @returns the node if it was created, NULL if the cell is already in the tree.
  */
-PathTree* PathFind::queueValidNodeAtCoord(PathTree* pParent, Maze::tCoord coord, tTreeNodeQueue &nodeQ) {
-	Maze::tCell* pCell = m_pGrid->at(coord);
-
-	// Make sure we didn't go out of bounds, and the cell is not solid. Occupied cells are
-	// valid, because we expect the entity to be taking that cell to move.
-	if (pCell == NULL || pCell->state == Maze::CELL_SOLID) {
-		return NULL;
-	}
+PathTree* PathFind::queueValidNode(PathTree* pParent, Maze::tCoord loc, tTreeNodeQueue &nodeQ) {
+	// Cells are reached in breadth first order, so a cell already in the
+	// tree was reached by a route at least as short. Looking the cell up
+	// in the index replaces walking the ancestors and siblings of the parent.
+	if (m_treeIndex.find(loc) != NULL) { return NULL; }
+	PathTree* pNode = pParent->addChild(PathTree::create(&m_treeArena, NULL, loc));
+	Maze::tIndex idx = m_pGrid->index(loc);
 
-	// The add child will return null, if the child already exists as an ancestor to the parent.
-	PathTree* pNode = pParent->addChild(pCell);
-	if (pNode != NULL) {
-		nodeQ.push(pNode);
+	// Dead ends are left in the tree as leaves, nothing past them is searched
+	if (m_pPruned != NULL && m_pPruned->test(idx)) {
+		pNode->setMeta(PathTree::DEAD_END);
+		return pNode;
 	}
+	nodeQ.push(pNode);
 	return pNode;
 }
@@ -7,21 +7,25 @@ using namespace std;
 /**
  * Initializes the node
  * @param parent the parent node of this child
- * @param c the cell to set the node to represent
+ * @param loc the location of the cell the node represents
  * @param children, list of children to be attached to this node
  */
-PathTree::PathTree(PathTree* p, Maze::tCell* c, PathTree::tChildren ch): m_parent(p), m_cell(c), m_children(ch), m_meta(VALID) {}
+PathTree::PathTree(PathTree* p, Maze::tCoord loc, PathTree::tChildren ch): m_parent(p), m_loc(loc), m_children(ch),
+	m_meta(VALID), m_pArena(ch.get_allocator().getArena()), m_pIndex(NULL) {}
 
 /** 
  * Takes care of deleting all children nodes still attached to this node
  */
 PathTree::~PathTree() {
-	// Delete all children still assigned to this node
+	if (m_pIndex != NULL) { m_pIndex->remove(this); }
+
+	// Delete all children still assigned to this node. Children in an
+	// arena are freed with it instead.
 	if (m_children.size() == 0) { return; }
 	tChildren::iterator it;
 	for (it = m_children.begin(); it != m_children.end(); it++) {
 		PathTree* child = *it;
-		if (child != NULL) {
+		if (child != NULL && child->m_pArena == NULL) {
 			delete child;
 			(*it) = NULL;
 		}
@@ -29,19 +33,38 @@ PathTree::~PathTree() {
 	m_children.clear();
 }
 
+/**
+ * Creates a node in the arena provided. The node, its children, and
+ * their lists of children are all freed by releasing the arena, and
+ * must never be deleted.
+ * @param pArena - arena to allocate from, NULL to create the node with new
+ * @param p - the parent node of this child
+ * @param loc - the location of the cell the node represents
+ * @returns the new node
+ */
+PathTree* PathTree::create(Arena* pArena, PathTree* p, Maze::tCoord loc) {
+	if (pArena == NULL) { return new PathTree(p, loc); }
+	void* pMem = pArena->allocate(sizeof(PathTree));
+	return new (pMem) PathTree(p, loc, tChildren(tChildren::allocator_type(pArena)));
+}
+
 /**
  * Appends a cell to this node as a child if it is not already
  * an ancestor of this node. It also makes sure that the cell adding
  * is not the same as this node's cell, and isn't already a sibling of
- * this node.
- * @param the cell to add as a child to this node
+ * this node. The child is created in the same arena as this node.
+ * @param the location of the cell to add as a child to this node
  * @returns the newly added child.
  */
-PathTree* PathTree::addChild(Maze::tCell* pCell) {
-	if (hasAncestor(*pCell) || *this == *pCell || hasSibling(*pCell)) { return NULL; }
+PathTree* PathTree::addChild(Maze::tCoord loc) {
+	if (hasAncestor(loc) || *this == loc || hasSibling(loc)) { return NULL; }
 
-	PathTree* pChild = new PathTree(this, pCell);
+	PathTree* pChild = create(m_pArena, this, loc);
 	m_children.push_back(pChild);
+	if (m_pIndex != NULL) {
+		pChild->m_pIndex = m_pIndex;
+		m_pIndex->add(pChild);
+	}
 
 	return pChild;
 }
@@ -55,12 +78,15 @@ PathTree* PathTree::addChild(PathTree* pChild) {
 	pChild->detach();
 	pChild->m_parent = this;
 	m_children.push_back(pChild);
+	// The child joins this tree's index, leaving any other it was in
+	if (m_pIndex != NULL || pChild->m_pIndex != NULL) { pChild->indexSubtree(m_pIndex); }
 	return pChild;
 }
 
 /**
  * Removes the parent reference from this node
- * while also removing it from the parent's child list
+ * while also removing it from the parent's child list.
+ * The node and its descendants are removed from the tree's index.
  */
 void PathTree::detach() {
 	if (m_parent != NULL) {
@@ -70,33 +96,47 @@ void PathTree::detach() {
 }
 
 /**
- * Removes the specified child from its parent's list of children
+ * Removes the specified child from its parent's list of children.
+ * The child and its descendants are removed from the tree's index.
  * @param child node to deref
  */
 void PathTree::removeChild(PathTree* pChild) {
+	if (unlinkChild(pChild) && pChild->m_pIndex != NULL) {
+		pChild->indexSubtree(NULL);
+	}
+}
+
+/**
+ * Removes the child from this node's list of children, leaving the
+ * child's parent and index as they are.
+ * @param pChild - node to unlink
+ * @returns true if the node was a child of this node
+ */
+bool PathTree::unlinkChild(PathTree* pChild) {
 	tChildren::iterator it;
 	for (it = m_children.begin(); it != m_children.end(); it++) {
 		PathTree* pNode = *it;
 		if (pNode == pChild) {
 			m_children.erase(it);
-			break;
+			return true;
 		}
 	}
+	return false;
 }
 
 /*
  * Searches up the tree looking if the cell specified already exists
  * as a parent to the node provided.
  * @param node to start from
- * @param cell to search for
+ * @param loc location of the cell to search for
  * @returns if the cell was found as an ancestor
  */
-bool PathTree::hasAncestor(Maze::tCell cell) {
+bool PathTree::hasAncestor(Maze::tCoord loc) {
 	if (m_parent == NULL) { return false; }
 
 	PathTree* pNode = this->m_parent;
 	while (pNode != NULL) {
-		if (*pNode == cell) {
+		if (*pNode == loc) {
 			return true;
 		}
 
@@ -109,16 +149,16 @@ bool PathTree::hasAncestor(Maze::tCell cell) {
 /**
  * Searches the children of the this node to make sure
  * this cell doesn't exist as a sibling
- * @param cell to search for
+ * @param loc location of the cell to search for
  * @returns true if this cell exists as a sibling
  */
-bool PathTree::hasSibling(Maze::tCell cell) {
+bool PathTree::hasSibling(Maze::tCoord loc) {
 	if (m_children.size() == 0) { return false; }
 
 	tChildren::const_iterator cIt;
 	for (cIt = m_children.begin(); cIt != m_children.end(); cIt++) {
 		PathTree* pNode = *cIt;
-		if (*pNode == cell) {
+		if (*pNode == loc) {
 			return true;
 		}
 	}
@@ -141,8 +181,9 @@ PathTree* PathTree::makeRoot() {
 	PathTree* oldParent = m_parent;
 	PathTree* node = this;
 	while (node != NULL) {
+		// The nodes stay in the tree, so they're left in its index
 		if (oldParent != NULL) {
-			oldParent->removeChild(node);
+			oldParent->unlinkChild(node);
 			node->m_children.push_back(oldParent);
 		}
 		node->m_parent = newParent;
@@ -174,24 +215,23 @@ PathTree* PathTree::getRoot() {
 	return NULL;
 }
 
-/**
- * returns the child cell specified as a child using breath first search
- * @param child node being serached for.
- * @returns the child if found, null otherwise
- */
-PathTree* PathTree::getNode(Maze::tCell cell) {
-	return getNode(cell.coord);
-}
-
 /**
  * Searchs through the tree looking for the node containing the coord
- * using breath first search.
+ * using breath first search. The root of an indexed tree looks the
+ * node up in the index instead.
  * @param coord the location of the cell we're looking for
  * @returns the node if found.
  */
 PathTree* PathTree::getNode(Maze::tCoord coord) {
 	if (*this == coord) { return this; }
 
+	// The index covers the whole tree, so only the root can use it. A
+	// cell missing from it may still have a node if it has duplicates.
+	if (m_pIndex != NULL && m_parent == NULL) {
+		PathTree* pNode = m_pIndex->find(coord);
+		if (pNode != NULL || !m_pIndex->hasDuplicates()) { return pNode; }
+	}
+
 	queue<PathTree*> nodeQ;
 	nodeQ.push(this);
 
@@ -212,3 +252,42 @@ PathTree* PathTree::getNode(Maze::tCoord coord) {
 
 	return NULL;
 }
+
+/**
+ * Indexes every node of the tree this node is in, and the nodes added
+ * to it from then on. Nodes leave the index when they are removed from
+ * the tree or deleted.
+ * @param pIndex - index to add the nodes to, not owned. NULL to remove
+ *                 the nodes from the index they are in.
+ */
+void PathTree::setIndex(PathTreeIndex* pIndex) {
+	PathTree* pRoot = getRoot();
+	if (pRoot != NULL) { pRoot->indexSubtree(pIndex); }
+}
+
+/**
+ * Moves this node and its descendants to the index provided
+ * @param pIndex - index to add the nodes to, NULL for none
+ */
+void PathTree::indexSubtree(PathTreeIndex* pIndex) {
+	// Leaves are the common case, added as the tree is built
+	if (m_children.empty()) {
+		if (m_pIndex != NULL) { m_pIndex->remove(this); }
+		m_pIndex = pIndex;
+		if (pIndex != NULL) { pIndex->add(this); }
+		return;
+	}
+
+	// Walked without recursion, the branches of a tree can be very deep
+	vector<PathTree*> nodes(1, this);
+	while (!nodes.empty()) {
+		PathTree* pNode = nodes.back();
+		nodes.pop_back();
+
+		if (pNode->m_pIndex != NULL) { pNode->m_pIndex->remove(pNode); }
+		pNode->m_pIndex = pIndex;
+		if (pIndex != NULL) { pIndex->add(pNode); }
+
+		nodes.insert(nodes.end(), pNode->m_children.begin(), pNode->m_children.end());
+	}
+}
@@ -0,0 +1,118 @@
+#include "pathtreeindex.hpp"
+#include "pathtree.hpp"
+
+using namespace std;
+
+/**
+ * Initializes an index of coordinates kept in a map, for trees that
+ * only cover a few cells of a large grid.
+ */
+PathTreeIndex::PathTreeIndex(): m_generation(1), m_size(0), m_duplicates(0) {}
+
+/**
+ * Initializes an index with a slot for every cell of the dimension
+ * @param dim - size of the grid the tree's cells are in
+ */
+PathTreeIndex::PathTreeIndex(Maze::tDimension dim): m_generation(1), m_size(0), m_duplicates(0) {
+	reset(dim);
+}
+
+/**
+ * Removes every node from the index, and resizes it for the dimension.
+ * Nodes that were in the index must not be removed from it afterwards.
+ * @param dim - size of the grid, 0 in any direction to only use the map
+ */
+void PathTreeIndex::reset(Maze::tDimension dim) {
+	if (dim.width <= 0 || dim.height <= 0 || dim.depth <= 0) {
+		dim = Maze::tDimension();
+	}
+	m_dim = dim;
+
+	long numSlots = (long)dim.width * dim.height * dim.depth;
+	m_slots.assign(numSlots, (PathTree*)NULL);
+	m_stamps.assign(numSlots, 0);
+	m_generation = 1;
+	m_sparse.clear();
+	m_size = 0;
+	m_duplicates = 0;
+}
+
+/**
+ * Removes every node from the index. Nodes that were in the index must
+ * not be removed from it afterwards, so this is meant for when their
+ * tree has been freed all at once.
+ */
+void PathTreeIndex::clear() {
+	// Stamps are only cleared when the generation wraps
+	if (++m_generation == 0) {
+		m_stamps.assign(m_stamps.size(), 0);
+		m_generation = 1;
+	}
+	m_sparse.clear();
+	m_size = 0;
+	m_duplicates = 0;
+}
+
+/**
+ * Adds a node to the index under its cell
+ * @param pNode - node to add
+ */
+void PathTreeIndex::add(PathTree* pNode) {
+	Maze::tCoord loc = pNode->getLoc();
+	m_size++;
+
+	long idx = slot(loc);
+	if (idx < 0) {
+		PathTree* &pSlot = m_sparse[loc];
+		if (pSlot != NULL) {
+			m_duplicates++;
+		} else {
+			pSlot = pNode;
+		}
+		return;
+	}
+
+	if (m_stamps[idx] == m_generation && m_slots[idx] != NULL) {
+		m_duplicates++;
+		return;
+	}
+	m_slots[idx] = pNode;
+	m_stamps[idx] = m_generation;
+}
+
+/**
+ * Removes a node from the index
+ * @param pNode - node to remove, must be in the index
+ */
+void PathTreeIndex::remove(PathTree* pNode) {
+	Maze::tCoord loc = pNode->getLoc();
+	m_size--;
+
+	// A node not in its cell's slot was counted as a duplicate
+	long idx = slot(loc);
+	if (idx < 0) {
+		tNodeMap::iterator it = m_sparse.find(loc);
+		if (it != m_sparse.end() && it->second == pNode) {
+			m_sparse.erase(it);
+			return;
+		}
+	} else if (m_stamps[idx] == m_generation && m_slots[idx] == pNode) {
+		m_slots[idx] = NULL;
+		return;
+	}
+	if (m_duplicates > 0) { m_duplicates--; }
+}
+
+/**
+ * Returns the node of the cell
+ * @param loc - coordinate of the cell
+ * @returns the node, NULL if the index doesn't hold one
+ */
+PathTree* PathTreeIndex::find(Maze::tCoord loc) {
+	long idx = slot(loc);
+	if (idx < 0) {
+		tNodeMap::iterator it = m_sparse.find(loc);
+		return (it != m_sparse.end()) ? it->second : NULL;
+	}
+	return (m_stamps[idx] == m_generation) ? m_slots[idx] : NULL;
+}
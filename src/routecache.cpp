@@ -0,0 +1,122 @@
+#include "routecache.hpp"
+
+using namespace std;
+
+/**
+ * Initializes an empty cache for the grid
+ * @param pGrid - grid the routes are found in, must outlive the cache
+ * @param capacity - most routes kept, the least recently used are dropped
+ */
+RouteCache::RouteCache(Maze::tGrid* pGrid, size_t capacity): m_pGrid(pGrid), m_capacity(capacity),
+		m_version(pGrid->version), m_hits(0), m_misses(0), m_invalidations(0) {
+	if (m_capacity < 1) { m_capacity = 1; }
+
+	// Keep the buckets at about one entry each when full
+	size_t numBuckets = 1;
+	while (numBuckets < m_capacity) { numBuckets <<= 1; }
+	m_buckets.resize(numBuckets);
+}
+
+/**
+ * Looks up a route, counting a hit or a miss
+ * @param strategy - search the route is found with
+ * @param from - grid index of the starting point
+ * @param dest - grid index of the destination
+ * @param route - set to the cached route on a hit
+ * @returns true if the route was cached
+ */
+bool RouteCache::lookup(int strategy, Maze::tIndex from, Maze::tIndex dest, tRoute &route) {
+	checkVersion();
+
+	vector<tEntries::iterator> &entries = bucket(strategy, from, dest);
+	for (size_t idx=0; idx < entries.size(); idx++) {
+		tEntries::iterator it = entries[idx];
+		if (it->from != from || it->dest != dest || it->strategy != strategy) { continue; }
+
+		// Move to the front of the list, the iterator stays valid
+		m_lru.splice(m_lru.begin(), m_lru, it);
+		route = it->route;
+		m_hits++;
+		return true;
+	}
+
+	m_misses++;
+	return false;
+}
+
+/**
+ * Adds a route to the cache, dropping the least recently used if full
+ * @param strategy - search the route was found with
+ * @param from - grid index of the starting point
+ * @param dest - grid index of the destination
+ * @param route - route found, empty if the destination is unreachable
+ */
+void RouteCache::store(int strategy, Maze::tIndex from, Maze::tIndex dest, const tRoute &route) {
+	checkVersion();
+
+	vector<tEntries::iterator> &entries = bucket(strategy, from, dest);
+	for (size_t idx=0; idx < entries.size(); idx++) {
+		tEntries::iterator it = entries[idx];
+		if (it->from == from && it->dest == dest && it->strategy == strategy) {
+			it->route = route;
+			m_lru.splice(m_lru.begin(), m_lru, it);
+			return;
+		}
+	}
+
+	if (m_lru.size() >= m_capacity) {
+		tEntries::iterator oldest = --m_lru.end();
+		vector<tEntries::iterator> &oldEntries = bucket(oldest->strategy, oldest->from, oldest->dest);
+		for (size_t idx=0; idx < oldEntries.size(); idx++) {
+			if (oldEntries[idx] == oldest) {
+				oldEntries[idx] = oldEntries.back();
+				oldEntries.pop_back();
+				break;
+			}
+		}
+		m_lru.erase(oldest);
+	}
+
+	tEntry entry;
+	entry.strategy = strategy;
+	entry.from = from;
+	entry.dest = dest;
+	entry.route = route;
+	m_lru.push_front(entry);
+	entries.push_back(m_lru.begin());
+}
+
+/**
+ * Drops every cached route. The hit and miss counts are kept.
+ */
+void RouteCache::clear() {
+	m_lru.clear();
+	for (size_t idx=0; idx < m_buckets.size(); idx++) {
+		m_buckets[idx].clear();
+	}
+}
+
+/**
+ * Empties the cache if the grid has changed since the routes were found
+ */
+void RouteCache::checkVersion() {
+	if (m_version == m_pGrid->version) { return; }
+
+	if (!m_lru.empty()) {
+		clear();
+		m_invalidations++;
+	}
+	m_version = m_pGrid->version;
+}
+
+/**
+ * Returns the bucket a key belongs in
+ */
+vector<RouteCache::tEntries::iterator> &RouteCache::bucket(int strategy, Maze::tIndex from, Maze::tIndex dest) {
+	// Mix the key's parts with large odd multipliers so nearby cells
+	// spread across the buckets.
+	unsigned long long hash = (unsigned long long)from * 0x9E3779B97F4A7C15ULL;
+	hash ^= (unsigned long long)dest * 0xC2B2AE3D27D4EB4FULL + (unsigned long long)strategy;
+	hash ^= hash >> 29;
+	return m_buckets[hash & (m_buckets.size() - 1)];
+}
@@ -0,0 +1,268 @@
+#include "wavefront.hpp"
+
+#include <string.h>
+
+using namespace std;
+
+// Vector of words the compiler can map onto SIMD registers
+typedef BitLayer::tWord tVec __attribute__((vector_size(sizeof(BitLayer::tWord) * 4)));
+
+/**
+ * Loads a vector from words that need not be aligned. Vectors are passed
+ * by reference so the ABI doesn't depend on the target having AVX.
+ * @param v - set to the words loaded
+ * @param pWords - first word to load
+ */
+static inline void loadVec(tVec &v, const BitLayer::tWord* pWords) {
+	memcpy(&v, pWords, sizeof(v));
+}
+
+/**
+ * Stores a vector to words that need not be aligned
+ * @param pWords - first word to store to
+ * @param v - vector to store
+ */
+static inline void storeVec(BitLayer::tWord* pWords, const tVec &v) {
+	memcpy(pWords, &v, sizeof(v));
+}
+
+/**
+ * Initializes the flood for the grid
+ * @param pGrid - grid of the maze, must outlive the flood
+ */
+WaveFront::WaveFront(Maze::tGrid* pGrid): m_pGrid(pGrid), m_levels(0), m_openVersion(0), m_openValid(false),
+		m_pad(0), m_numWords(0) {
+	for (int dir=0; dir < Maze::NUM_DIRECTIONS; dir++) {
+		m_wordShift[dir] = 0;
+		m_bitShift[dir] = 0;
+	}
+}
+
+/**
+ * Floods out from the cell until every reachable cell is visited
+ * @param from - cell to flood from
+ * @returns number of cells reached, including the first. 0 if the
+ *          cell is solid or the grid isn't supported.
+ */
+long WaveFront::flood(Maze::tCoord from) {
+	m_levels = 0;
+	if (!isSupported() || !m_pGrid->contains(from)) { return 0; }
+	snapshotOpen();
+
+	Maze::tIndex fromIdx = m_pGrid->index(from);
+	if (!m_pGrid->isOpen(fromIdx)) { return 0; }
+
+	long first, last;
+	start(fromIdx, first, last);
+	while (expand(first, last)) {}
+
+	long reached = 0;
+	const tWord* visited = &m_visited[m_pad];
+	for (long w=0; w < m_numWords; w++) {
+		reached += __builtin_popcountll(visited[w]);
+	}
+	return reached;
+}
+
+/**
+ * Floods out from the cell until the destination is reached
+ * @param from - cell to flood from
+ * @param dest - cell to measure to
+ * @returns steps between the cells, -1 if the destination can't be reached
+ */
+int WaveFront::distance(Maze::tCoord from, Maze::tCoord dest) {
+	m_levels = 0;
+	if (!isSupported() || !m_pGrid->contains(from) || !m_pGrid->contains(dest)) { return -1; }
+	snapshotOpen();
+
+	Maze::tIndex fromIdx = m_pGrid->index(from);
+	Maze::tIndex destIdx = m_pGrid->index(dest);
+	if (!m_pGrid->isOpen(fromIdx) || !m_pGrid->isOpen(destIdx)) { return -1; }
+
+	long first, last;
+	start(fromIdx, first, last);
+	const tWord* visited = &m_visited[m_pad];
+	tWord destBit = (tWord)1 << (destIdx % BitLayer::WORD_BITS);
+	while ((visited[destIdx / BitLayer::WORD_BITS] & destBit) == 0) {
+		if (!expand(first, last)) { return -1; }
+	}
+	return m_levels;
+}
+
+/**
+ * Floods out from the cell, recording the level each cell is reached at
+ * @param from - cell to flood from
+ * @param dist - set to the steps to each cell by grid index, -1 for
+ *               cells that aren't reached
+ */
+void WaveFront::distances(Maze::tCoord from, vector<int> &dist) {
+	m_levels = 0;
+	dist.assign(m_pGrid->size, -1);
+	if (!isSupported() || !m_pGrid->contains(from)) { return; }
+	snapshotOpen();
+
+	Maze::tIndex fromIdx = m_pGrid->index(from);
+	if (!m_pGrid->isOpen(fromIdx)) { return; }
+
+	long first, last;
+	start(fromIdx, first, last);
+	dist[fromIdx] = 0;
+
+	// Only the newly reached cells are left in the frontier after each level
+	while (expand(first, last)) {
+		const tWord* frontier = &m_frontier[m_pad];
+		for (long w=first; w < last; w++) {
+			tWord bits = frontier[w];
+			while (bits != 0) {
+				int bit = __builtin_ctzll(bits);
+				bits &= bits - 1;
+				dist[w * BitLayer::WORD_BITS + bit] = m_levels;
+			}
+		}
+	}
+}
+
+/**
+ * Returns if the cell was reached by the last flood
+ * @param loc - cell to check
+ */
+bool WaveFront::isReached(Maze::tCoord loc) {
+	if (!m_openValid || !m_pGrid->contains(loc)) { return false; }
+	Maze::tIndex idx = m_pGrid->index(loc);
+	return (m_visited[m_pad + idx / BitLayer::WORD_BITS] >> (idx % BitLayer::WORD_BITS)) & 1;
+}
+
+/**
+ * Sizes the layers for the grid and finds its open cells, if the grid
+ * has changed since they were last found.
+ */
+void WaveFront::snapshotOpen() {
+	long numWords = (m_pGrid->size + BitLayer::WORD_BITS - 1) / BitLayer::WORD_BITS;
+	numWords = (numWords + VECTOR_WORDS - 1) / VECTOR_WORDS * VECTOR_WORDS;
+	if (m_openValid && m_openVersion == m_pGrid->version && m_numWords == numWords) { return; }
+
+	// Split each neighbor offset into whole words and the bits left over,
+	// rounding down so the bits are always shifted the same way.
+	long maxShift = 0;
+	for (int dir=0; dir < Maze::NUM_DIRECTIONS; dir++) {
+		Maze::tIndex offset = m_pGrid->offsets[dir];
+		long words = offset / BitLayer::WORD_BITS;
+		if (offset % BitLayer::WORD_BITS < 0) { words--; }
+		m_wordShift[dir] = words;
+		m_bitShift[dir] = offset - words * BitLayer::WORD_BITS;
+
+		long reach = (words < 0) ? -words : words + 1;
+		if (reach > maxShift) { maxShift = reach; }
+	}
+
+	m_numWords = numWords;
+	m_pad = (maxShift + VECTOR_WORDS) / VECTOR_WORDS * VECTOR_WORDS;
+	m_open.assign(m_numWords + 2 * m_pad, 0);
+	m_visited.assign(m_open.size(), 0);
+	m_frontier.assign(m_open.size(), 0);
+	m_next.assign(m_open.size(), 0);
+
+	tWord* open = &m_open[m_pad];
+	if (m_pGrid->storage == Maze::STORAGE_PACKED) {
+		for (long w=0; w < m_pGrid->walls.numWords(); w++) {
+			open[w] = ~m_pGrid->walls.word(w);
+		}
+		// Bits past the end of the grid are never open
+		int used = m_pGrid->size % BitLayer::WORD_BITS;
+		if (used != 0) {
+			open[m_pGrid->size / BitLayer::WORD_BITS] &= ((tWord)1 << used) - 1;
+		}
+	} else {
+		for (Maze::tIndex idx=0; idx < m_pGrid->size; idx++) {
+			if (m_pGrid->isOpen(idx)) {
+				open[idx / BitLayer::WORD_BITS] |= (tWord)1 << (idx % BitLayer::WORD_BITS);
+			}
+		}
+	}
+
+	m_openVersion = m_pGrid->version;
+	m_openValid = true;
+}
+
+/**
+ * Clears the visited cells and starts the frontier at the cell
+ * @param idx - grid index of the first cell, must be open
+ * @param first - set to the first word of the frontier
+ * @param last - set to one past the last word of the frontier
+ */
+void WaveFront::start(Maze::tIndex idx, long &first, long &last) {
+	fill(m_visited.begin(), m_visited.end(), 0);
+	fill(m_frontier.begin(), m_frontier.end(), 0);
+	fill(m_next.begin(), m_next.end(), 0);
+
+	long w = idx / BitLayer::WORD_BITS;
+	tWord bit = (tWord)1 << (idx % BitLayer::WORD_BITS);
+	m_frontier[m_pad + w] = bit;
+	m_visited[m_pad + w] = bit;
+
+	first = w / VECTOR_WORDS * VECTOR_WORDS;
+	last = first + VECTOR_WORDS;
+}
+
+/**
+ * Expands the frontier a level, leaving only the newly reached cells
+ * in it and marking them visited.
+ * @param first - first word of the frontier, updated for the new one
+ * @param last - one past the last word of the frontier, updated for the new one
+ * @returns false if no new cells were reached
+ */
+bool WaveFront::expand(long &first, long &last) {
+	// New cells can only be found within a shift of the frontier
+	long lo = first - m_pad;
+	long hi = last + m_pad;
+	if (lo < 0) { lo = 0; }
+	if (hi > m_numWords) { hi = m_numWords; }
+
+	const tWord* frontier = &m_frontier[m_pad];
+	const tWord* open = &m_open[m_pad];
+	tWord* visited = &m_visited[m_pad];
+	tWord* next = &m_next[m_pad];
+
+	long newFirst = -1;
+	long newLast = -1;
+	for (long w=lo; w < hi; w += VECTOR_WORDS) {
+		// Each cell is reached from the frontier cell one offset away
+		tVec reached = {0, 0, 0, 0};
+		tVec low, high;
+		for (int dir=0; dir < Maze::NUM_DIRECTIONS; dir++) {
+			const tWord* src = frontier + w + m_wordShift[dir];
+			int bits = m_bitShift[dir];
+			loadVec(low, src);
+			if (bits == 0) {
+				reached |= low;
+			} else {
+				loadVec(high, src + 1);
+				reached |= (low >> bits) | (high << (BitLayer::WORD_BITS - bits));
+			}
+		}
+
+		tVec cells, seen;
+		loadVec(cells, open + w);
+		loadVec(seen, visited + w);
+		tVec found = reached & cells & ~seen;
+		storeVec(next + w, found);
+		seen |= found;
+		storeVec(visited + w, seen);
+
+		if ((found[0] | found[1] | found[2] | found[3]) != 0) {
+			if (newFirst < 0) { newFirst = w; }
+			newLast = w + VECTOR_WORDS;
+		}
+	}
+
+	// The old frontier becomes the scratch layer for the next level, and
+	// must be empty outside of the words that level writes.
+	m_frontier.swap(m_next);
+	fill(m_next.begin() + m_pad + first, m_next.begin() + m_pad + last, 0);
+
+	if (newFirst < 0) { return false; }
+	first = newFirst;
+	last = newLast;
+	m_levels++;
+	return true;
+}
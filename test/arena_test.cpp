@@ -0,0 +1,93 @@
+#include "arena_test.hpp"
+#include "arena.hpp"
+
+#include <stdio.h>
+#include <string.h>
+
+using namespace std;
+
+/**
+ * Initialize the test, and also make sure to initialize the 
+ * parent test unit as well.
+ */
+ArenaTest::ArenaTest(): TestUnit() {
+	m_tests["ArenaTest::TestAllocate"] = &TestAllocate;
+	m_tests["ArenaTest::TestReleaseReusesBlocks"] = &TestReleaseReusesBlocks;
+}
+
+/**
+ * Verify allocations are aligned, don't overlap, and larger than a
+ * block are still satisfied
+ * @param pTestData - pointer to test container, not used for these tests
+ * @returns error string if any.
+ */
+string ArenaTest::TestAllocate(TestUnit::tTestData* pTestData) {
+	char errStr[100] = {0x00};
+
+	Arena arena;
+	if (arena.getBytesReserved() != 0) {
+		return "Expected a new arena to not allocate any blocks";
+	}
+
+	char* pFirst = (char*)arena.allocate(3);
+	char* pSecond = (char*)arena.allocate(5);
+	if ((size_t)pFirst % sizeof(long double) != 0 || (size_t)pSecond % sizeof(long double) != 0) {
+		return "Expected allocations to be aligned for any type";
+	}
+	if (pSecond < pFirst + 3) {
+		return "Expected allocations to not overlap";
+	}
+	memset(pFirst, 1, 3);
+	memset(pSecond, 2, 5);
+	if (pFirst[2] != 1) {
+		return "Expected the first allocation to be left alone by the second";
+	}
+
+	// Larger than a block gets a block of its own
+	char* pLarge = (char*)arena.allocate(Arena::BLOCK_SIZE * 2);
+	memset(pLarge, 3, Arena::BLOCK_SIZE * 2);
+	if (arena.getBytesReserved() < Arena::BLOCK_SIZE * 3) {
+		sprintf(errStr, "%lu", (unsigned long)arena.getBytesReserved());
+		return "Expected a block to be added for the large allocation. Reserved: " + string(errStr);
+	}
+	if (pFirst[0] != 1 || pSecond[0] != 2) {
+		return "Expected the large allocation to not overlap the others";
+	}
+
+	return "";
+}
+
+/**
+ * Verify releasing the arena reuses its blocks instead of growing
+ * @param pTestData - pointer to test container, not used for these tests
+ * @returns error string if any.
+ */
+string ArenaTest::TestReleaseReusesBlocks(TestUnit::tTestData* pTestData) {
+	char errStr[100] = {0x00};
+
+	Arena arena;
+	void* pFirst = NULL;
+	size_t reserved = 0;
+	for (int pass=0; pass < 10; pass++) {
+		arena.release();
+		if (arena.getBytesUsed() != 0) {
+			return "Expected nothing to be in use after a release";
+		}
+
+		// Enough to span a few blocks
+		void* pMem = arena.allocate(64);
+		for (int count=0; count < 5000; count++) {
+			arena.allocate(48);
+		}
+
+		if (pass == 0) {
+			pFirst = pMem;
+			reserved = arena.getBytesReserved();
+		} else if (pMem != pFirst || arena.getBytesReserved() != reserved) {
+			sprintf(errStr, "%d", pass);
+			return "Expected the arena to allocate from the same blocks on pass " + string(errStr);
+		}
+	}
+
+	return "";
+}
@@ -0,0 +1,35 @@
+#ifndef _ARENA_TEST_HPP_
+#define _ARENA_TEST_HPP_
+
+#include <string>
+
+#include "test_unit.hpp"
+
+class ArenaTest : public TestUnit {
+public:
+
+	/**
+	 * Initialize the test, and also make sure to initialize the 
+	 * parent test unit as well.
+	 */
+	ArenaTest();
+
+private:
+
+	/**
+	 * Verify allocations are aligned, don't overlap, and larger than a
+	 * block are still satisfied
+	 * @param pTestData - pointer to test container, not used for these tests
+	 * @returns error string if any.
+	 */
+	static std::string TestAllocate(TestUnit::tTestData* pTestData);
+
+	/**
+	 * Verify releasing the arena reuses its blocks instead of growing
+	 * @param pTestData - pointer to test container, not used for these tests
+	 * @returns error string if any.
+	 */
+	static std::string TestReleaseReusesBlocks(TestUnit::tTestData* pTestData);
+};
+
+#endif //!defined(_ARENA_TEST_HPP_)
@@ -0,0 +1,77 @@
+#include "bitlayer_test.hpp"
+#include "bitlayer.hpp"
+
+#include <stdio.h>
+#include <iostream>
+
+using namespace std;
+
+/**
+ * Initialize the test, and also make sure to initialize the 
+ * parent test unit as well.
+ */
+BitLayerTest::BitLayerTest(): TestUnit() {
+	m_tests["BitLayerTest::TestSetAndClearBits"] = &TestSetAndClearBits;
+	m_tests["BitLayerTest::TestReadBitRuns"] = &TestReadBitRuns;
+}
+
+/**
+ * Verify bits can be set, cleared, and counted
+ * @param pTestData - pointer to test container, not used for these tests
+ * @returns error string if any.
+ */
+string BitLayerTest::TestSetAndClearBits(TestUnit::tTestData* pTestData) {
+	BitLayer layer(130);
+	if (layer.numWords() != 3 || layer.count() != 0) {
+		return "Layer of 130 bits was not created empty in 3 words.";
+	}
+
+	layer.set(0);
+	layer.set(64);
+	layer.set(129);
+	if (!layer.test(0) || !layer.test(64) || !layer.test(129) || layer.test(1)) {
+		return "Bits set do not match the bits tested.";
+	}
+	if (layer.count() != 3) {
+		return "Count of set bits is incorrect.";
+	}
+
+	layer.clear(64);
+	if (layer.test(64) || layer.count() != 2) {
+		return "Failed to clear bit 64.";
+	}
+
+	// Filling should never mark the unused bits in the last word
+	layer.fill(true);
+	if (layer.count() != 130) {
+		return "Filled layer does not have exactly 130 bits set.";
+	}
+
+	return "";
+}
+
+/**
+ * Verify runs of bits can be read, including across word boundaries
+ * @param pTestData - pointer to test container, not used for these tests
+ * @returns error string if any.
+ */
+string BitLayerTest::TestReadBitRuns(TestUnit::tTestData* pTestData) {
+	BitLayer layer(200);
+	layer.set(10);
+	layer.set(12);
+	if (layer.bits(10, 3) != 5) {
+		return "Failed to read a run of bits inside of a word.";
+	}
+
+	layer.set(63);
+	layer.set(65);
+	if (layer.bits(63, 3) != 5) {
+		return "Failed to read a run of bits spanning two words.";
+	}
+
+	if (layer.bits(0, 64) != (((BitLayer::tWord)1 << 10) | ((BitLayer::tWord)1 << 12) | ((BitLayer::tWord)1 << 63))) {
+		return "Failed to read a full word of bits.";
+	}
+
+	return "";
+}
@@ -0,0 +1,35 @@
+#ifndef _BITLAYER_TEST_HPP_
+#define _BITLAYER_TEST_HPP_
+
+#include <string>
+
+#include "test_unit.hpp"
+
+class BitLayerTest : public TestUnit {
+public:
+
+	/**
+	 * Initialize the test, and also make sure to initialize the 
+	 * parent test unit as well.
+	 */
+	BitLayerTest();
+
+private:
+
+	/**
+	 * Verify bits can be set, cleared, and counted
+	 * @param pTestData - pointer to test container, not used for these tests
+	 * @returns error string if any.
+	 */
+	static std::string TestSetAndClearBits(TestUnit::tTestData* pTestData);
+
+	/**
+	 * Verify runs of bits can be read, including across word boundaries
+	 * @param pTestData - pointer to test container, not used for these tests
+	 * @returns error string if any.
+	 */
+	static std::string TestReadBitRuns(TestUnit::tTestData* pTestData);
+
+};
+
+#endif //!defined(_BITLAYER_TEST_HPP_)
@@ -0,0 +1,148 @@
+#include "clustergraph_test.hpp"
+#include "clustergraph.hpp"
+#include "pathfind.hpp"
+#include "test_routes.hpp"
+#include "game.hpp"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+using namespace std;
+
+/**
+ * Initialize the test, and also make sure to initialize the 
+ * parent test unit as well.
+ */
+ClusterGraphTest::ClusterGraphTest(): TestUnit() {
+	m_tests["ClusterGraphTest::TestBuildPortals"] = &TestBuildPortals;
+	m_tests["ClusterGraphTest::TestFindRoute"] = &TestFindRoute;
+	m_tests["ClusterGraphTest::TestGameHierarchicalSearch"] = &TestGameHierarchicalSearch;
+}
+
+/**
+ * Verify portals are placed at the entrances between clusters
+ * @param pTestData - pointer to test container, not used for these tests
+ * @returns error string if any.
+ */
+string ClusterGraphTest::TestBuildPortals(TestUnit::tTestData* pTestData) {
+	char errStr[100] = {0x00};
+
+	// Two clusters side by side, the whole face between them is one entrance
+	Maze maze(Maze::tDimension(8, 4, 4));
+	ClusterGraph graph(maze.getGrid(), 4);
+	graph.build();
+	if (graph.getNumClusters() != 2 || graph.getNumPortals() != 2) {
+		sprintf(errStr, "%d clusters, %ld portals", graph.getNumClusters(), graph.getNumPortals());
+		return "Expected 2 clusters joined by 2 portals. Got: " + string(errStr);
+	}
+
+	// A wall down the middle of the face splits it into two entrances
+	for (int y=0; y < 4; y++) {
+		maze.updateCell(Maze::tCoord(3, y, 2), Maze::CELL_SOLID);
+	}
+	graph.build();
+	if (graph.getNumPortals() != 4) {
+		sprintf(errStr, "%ld", graph.getNumPortals());
+		return "Expected 4 portals for the two entrances. Got: " + string(errStr);
+	}
+	// Each entrance edge, and the portals on each side reach each other
+	if (graph.getNumEdges() != 8) {
+		sprintf(errStr, "%ld", graph.getNumEdges());
+		return "Expected 8 edges between the portals. Got: " + string(errStr);
+	}
+
+	// Walling off the face completely leaves no entrances
+	for (int y=0; y < 4; y++) {
+		for (int z=0; z < 4; z++) {
+			maze.updateCell(Maze::tCoord(4, y, z), Maze::CELL_SOLID);
+		}
+	}
+	graph.build();
+	if (graph.getNumPortals() != 0) {
+		return "Expected no portals between walled off clusters";
+	}
+
+	return "";
+}
+
+/**
+ * Verify routes found through the portal graph connect the start to the
+ * destination through open cells, and are close to the shortest route
+ * @param pTestData - pointer to test container, not used for these tests
+ * @returns error string if any.
+ */
+string ClusterGraphTest::TestFindRoute(TestUnit::tTestData* pTestData) {
+	char errStr[100] = {0x00};
+
+	Maze maze(Maze::tDimension(40, 24, 40));
+	srand(3);
+	for (int idx=0; idx < 40 * 24 * 40 / 5; idx++) {
+		maze.updateCell(Maze::tCoord(rand() % 40, rand() % 24, rand() % 40), Maze::CELL_SOLID);
+	}
+	Maze::tCoord from = Maze::tCoord(0,0,0);
+	Maze::tCoord dest = Maze::tCoord(39,23,39);
+	maze.updateCell(from, Maze::CELL_EMPTY);
+	maze.updateCell(dest, Maze::CELL_EMPTY);
+
+	ClusterGraph graph(maze.getGrid(), 8);
+	graph.build();
+	ClusterGraph::tRoute route = graph.findRoute(from, dest);
+
+	PathFind bfs;
+	bfs.setGrid(maze.getGrid());
+	bfs.setLoc(from);
+	PathFind::tRoute bfsRoute = bfs.findRoute(dest);
+	if (bfsRoute.empty() || route.size() < bfsRoute.size() || route.size() > bfsRoute.size() * 5 / 4) {
+		sprintf(errStr, "%d, shortest is %d", (int)route.size(), (int)bfsRoute.size());
+		return "Route length is not close to the shortest route: " + string(errStr);
+	}
+
+	// Each step of the route must move to an adjacent open cell
+	string err = TestRoutes::checkRoute(maze, from, dest, route);
+	if (err != "") { return err; }
+
+	// Routes within a single cluster don't need any portals
+	maze.updateCell(Maze::tCoord(1,0,0), Maze::CELL_EMPTY);
+	route = graph.findRoute(from, Maze::tCoord(1,0,0));
+	if (route.size() != 1) {
+		return "Failed to find route to the cell next to the start";
+	}
+
+	// Wall off the destination so it cannot be reached
+	TestRoutes::wallOff(maze, dest);
+	graph.build();
+	route = graph.findRoute(from, dest);
+	if (!route.empty()) {
+		return "Found a route to a walled off cell";
+	}
+
+	return "";
+}
+
+/**
+ * Verify a game using the hierarchical search builds the graph and
+ * its bots find their routes with it
+ * @param pTestData - pointer to test container, not used for these tests
+ * @returns error string if any.
+ */
+string ClusterGraphTest::TestGameHierarchicalSearch(TestUnit::tTestData* pTestData) {
+	EnvConfig cfg;
+	char fileName[] = "test/configs/input00";
+	if (!cfg.parseEnv(fileName)) {
+		return "Failed to load environment config file";
+	}
+
+	Game game(Maze::STORAGE_CELLS, Maze::LAYOUT_LINEAR, PathFind::SEARCH_HIERARCHICAL);
+	game.buildEnv(cfg);
+	if (game.getClusterGraph() == NULL || !game.getClusterGraph()->isBuilt()) {
+		return "Game did not build the cluster graph";
+	}
+
+	Bot bot(game.getMaze(), Maze::tCoord(0,0,0));
+	bot.setClusterGraph(game.getClusterGraph());
+	if (!bot.calcRoute(cfg.getExitCoord(), PathFind::SEARCH_HIERARCHICAL)) {
+		return "Bot failed to find a route to the exit";
+	}
+
+	return "";
+}
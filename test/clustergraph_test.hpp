@@ -0,0 +1,43 @@
+#ifndef _CLUSTERGRAPH_TEST_HPP_
+#define _CLUSTERGRAPH_TEST_HPP_
+
+#include <string>
+
+#include "test_unit.hpp"
+
+class ClusterGraphTest : public TestUnit {
+public:
+
+	/**
+	 * Initialize the test, and also make sure to initialize the 
+	 * parent test unit as well.
+	 */
+	ClusterGraphTest();
+
+private:
+
+	/**
+	 * Verify portals are placed at the entrances between clusters
+	 * @param pTestData - pointer to test container, not used for these tests
+	 * @returns error string if any.
+	 */
+	static std::string TestBuildPortals(TestUnit::tTestData* pTestData);
+
+	/**
+	 * Verify routes found through the portal graph connect the start to the
+	 * destination through open cells, and are close to the shortest route
+	 * @param pTestData - pointer to test container, not used for these tests
+	 * @returns error string if any.
+	 */
+	static std::string TestFindRoute(TestUnit::tTestData* pTestData);
+
+	/**
+	 * Verify a game using the hierarchical search builds the graph and
+	 * its bots find their routes with it
+	 * @param pTestData - pointer to test container, not used for these tests
+	 * @returns error string if any.
+	 */
+	static std::string TestGameHierarchicalSearch(TestUnit::tTestData* pTestData);
+};
+
+#endif //!defined(_CLUSTERGRAPH_TEST_HPP_)
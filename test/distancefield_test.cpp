@@ -0,0 +1,131 @@
+#include "distancefield_test.hpp"
+#include "distancefield.hpp"
+#include "pathfind.hpp"
+#include "test_routes.hpp"
+#include "game.hpp"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+using namespace std;
+
+/**
+ * Initialize the test, and also make sure to initialize the 
+ * parent test unit as well.
+ */
+DistanceFieldTest::DistanceFieldTest(): TestUnit() {
+	m_tests["DistanceFieldTest::TestDistances"] = &TestDistances;
+	m_tests["DistanceFieldTest::TestRouteFrom"] = &TestRouteFrom;
+	m_tests["DistanceFieldTest::TestGameSharesField"] = &TestGameSharesField;
+}
+
+/**
+ * Verify the distances of the field match the length of the routes
+ * found by breadth first search
+ * @param pTestData - pointer to test container, not used for these tests
+ * @returns error string if any.
+ */
+string DistanceFieldTest::TestDistances(TestUnit::tTestData* pTestData) {
+	char errStr[100] = {0x00};
+
+	Maze maze(Maze::tDimension(20, 12, 20));
+	srand(4);
+	for (int idx=0; idx < 20 * 12 * 20 / 4; idx++) {
+		maze.updateCell(Maze::tCoord(rand() % 20, rand() % 12, rand() % 20), Maze::CELL_SOLID);
+	}
+	Maze::tCoord dest = Maze::tCoord(10,6,10);
+	maze.updateCell(dest, Maze::CELL_EMPTY);
+
+	DistanceField field(maze.getGrid());
+	field.build(dest);
+	if (field.getDistance(dest) != 0) {
+		return "Expected the destination to be 0 steps from itself";
+	}
+
+	PathFind bfs;
+	bfs.setGrid(maze.getGrid());
+	for (int idx=0; idx < 50; idx++) {
+		Maze::tCoord from = Maze::tCoord(rand() % 20, rand() % 12, rand() % 20);
+		if (from == dest || maze.getState(from) == Maze::CELL_SOLID) { continue; }
+
+		bfs.setLoc(from);
+		PathFind::tRoute route = bfs.findRoute(dest);
+		int expected = route.empty() ? -1 : route.size();
+		if (field.getDistance(from) != expected) {
+			sprintf(errStr, "%d, expected %d", field.getDistance(from), expected);
+			return "Distance from " + from.String() + " does not match breadth first: " + string(errStr);
+		}
+	}
+
+	return "";
+}
+
+/**
+ * Verify routes stepping downhill reach the destination, and that
+ * unreachable cells have no route
+ * @param pTestData - pointer to test container, not used for these tests
+ * @returns error string if any.
+ */
+string DistanceFieldTest::TestRouteFrom(TestUnit::tTestData* pTestData) {
+	char errStr[100] = {0x00};
+
+	EnvConfig cfg;
+	char fileName[] = "test/configs/input00";
+	if (!cfg.parseEnv(fileName)) {
+		return "Failed to load environment config file";
+	}
+	Game game;
+	game.buildEnv(cfg);
+	Maze* pMaze = game.getMaze();
+
+	DistanceField field(pMaze->getGrid());
+	field.build(Maze::tCoord(2,1,2));
+	DistanceField::tRoute route = field.routeFrom(Maze::tCoord(0,0,0));
+	if (route.size() != 15) {
+		sprintf(errStr, "%d", (int)route.size());
+		return "Expected a route of 15 steps. Got: " + string(errStr);
+	}
+
+	// Each step of the route must move to an adjacent open cell
+	string err = TestRoutes::checkRoute(*pMaze, Maze::tCoord(0,0,0), Maze::tCoord(2,1,2), route);
+	if (err != "") { return err; }
+
+	// Solid cells can't reach the destination
+	if (field.getDistance(Maze::tCoord(1,0,0)) != -1 || !field.routeFrom(Maze::tCoord(1,0,0)).empty()) {
+		return "Expected no route from a solid cell";
+	}
+
+	return "";
+}
+
+/**
+ * Verify a game builds one field to its exit, and its bots route with it
+ * @param pTestData - pointer to test container, not used for these tests
+ * @returns error string if any.
+ */
+string DistanceFieldTest::TestGameSharesField(TestUnit::tTestData* pTestData) {
+	EnvConfig cfg;
+	char fileName[] = "test/configs/inputab";
+	if (!cfg.parseEnv(fileName)) {
+		return "Failed to load environment config file";
+	}
+
+	Game game(Maze::STORAGE_CELLS, Maze::LAYOUT_LINEAR, PathFind::SEARCH_DISTANCE_FIELD);
+	game.buildEnv(cfg);
+	DistanceField* pField = game.getDistanceField();
+	if (pField == NULL || !pField->isBuilt() || pField->getDest() != cfg.getExitCoord()) {
+		return "Game did not build the distance field to its exit";
+	}
+
+	EnvConfig::tBotCoords coords = cfg.getBotCoords();
+	EnvConfig::tBotCoords::const_iterator cIt;
+	for (cIt = coords.begin(); cIt != coords.end(); cIt++) {
+		Bot bot(game.getMaze(), (*cIt).second);
+		bot.setDistanceField(pField);
+		if (!bot.calcRoute(cfg.getExitCoord(), PathFind::SEARCH_DISTANCE_FIELD)) {
+			return "Bot failed to find a route to the exit with the distance field";
+		}
+	}
+
+	return "";
+}
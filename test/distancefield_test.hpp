@@ -0,0 +1,43 @@
+#ifndef _DISTANCEFIELD_TEST_HPP_
+#define _DISTANCEFIELD_TEST_HPP_
+
+#include <string>
+
+#include "test_unit.hpp"
+
+class DistanceFieldTest : public TestUnit {
+public:
+
+	/**
+	 * Initialize the test, and also make sure to initialize the 
+	 * parent test unit as well.
+	 */
+	DistanceFieldTest();
+
+private:
+
+	/**
+	 * Verify the distances of the field match the length of the routes
+	 * found by breadth first search
+	 * @param pTestData - pointer to test container, not used for these tests
+	 * @returns error string if any.
+	 */
+	static std::string TestDistances(TestUnit::tTestData* pTestData);
+
+	/**
+	 * Verify routes stepping downhill reach the destination, and that
+	 * unreachable cells have no route
+	 * @param pTestData - pointer to test container, not used for these tests
+	 * @returns error string if any.
+	 */
+	static std::string TestRouteFrom(TestUnit::tTestData* pTestData);
+
+	/**
+	 * Verify a game builds one field to its exit, and its bots route with it
+	 * @param pTestData - pointer to test container, not used for these tests
+	 * @returns error string if any.
+	 */
+	static std::string TestGameSharesField(TestUnit::tTestData* pTestData);
+};
+
+#endif //!defined(_DISTANCEFIELD_TEST_HPP_)
@@ -14,6 +14,7 @@ using namespace std;
 EnvConfigTest::EnvConfigTest(): TestUnit() {
 	m_tests["EnvConfigTest::TestLoadProvidedFile"] = &TestLoadProvidedFile;
 	m_tests["EnvConfigTest::TestCalcCoordFromRowDim"] = &TestCalcCoordFromRowDim;
+	m_tests["EnvConfigTest::TestMultipleExits"] = &TestMultipleExits;
 }
 
 /**
@@ -210,3 +211,32 @@ std::string EnvConfigTest::TestCalcCoordFromRowDim(TestUnit::tTestData* pTestDat
 
 	return "";
 }
+
+/**
+ * Loads a test file with two exits, and verifies both are found
+ * @param pTestData - pointer to test container, not used for these tests
+ * @returns error string if any.
+ */
+std::string EnvConfigTest::TestMultipleExits(TestUnit::tTestData* pTestData) {
+	char errStr[100] = {0x00};
+
+	EnvConfig cfg;
+	char fileName[] = "test/configs/inputab_exits";
+	if (!cfg.parseEnv(fileName)) {
+		return "Failed to load environment config file";
+	}
+
+	Maze::tCoords exits = cfg.getExitCoords();
+	if (exits.size() != 2) {
+		sprintf(errStr, "%d", (int)exits.size());
+		return "Expected 2 exits. Got: " + string(errStr);
+	}
+	if (exits[0] != Maze::tCoord(4,2,0) || exits[1] != Maze::tCoord(0,2,3)) {
+		return "Expected exits at (4,2,0) and (0,2,3). Got: " + exits[0].String() + " and " + exits[1].String();
+	}
+	if (cfg.getExitCoord() != Maze::tCoord(4,2,0)) {
+		return "Expected the first exit to be (4,2,0). Got: " + cfg.getExitCoord().String();
+	}
+
+	return "";
+}
@@ -30,6 +30,13 @@ private:
 	 */
 	static std::string TestCalcCoordFromRowDim(TestUnit::tTestData* pTestData);
 
+	/**
+	 * Loads a test file with two exits, and verifies both are found
+	 * @param pTestData - pointer to test container, not used for these tests
+	 * @returns error string if any.
+	 */
+	static std::string TestMultipleExits(TestUnit::tTestData* pTestData);
+
 };
 
 #endif //!defined(_ENV_CONFIG_TEST_HPP_)
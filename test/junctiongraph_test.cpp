@@ -0,0 +1,157 @@
+#include "junctiongraph_test.hpp"
+#include "junctiongraph.hpp"
+#include "pathfind.hpp"
+#include "test_routes.hpp"
+#include "game.hpp"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+using namespace std;
+
+/**
+ * Initialize the test, and also make sure to initialize the 
+ * parent test unit as well.
+ */
+JunctionGraphTest::JunctionGraphTest(): TestUnit() {
+	m_tests["JunctionGraphTest::TestBuildGraph"] = &TestBuildGraph;
+	m_tests["JunctionGraphTest::TestFindRoute"] = &TestFindRoute;
+	m_tests["JunctionGraphTest::TestGameJunctionSearch"] = &TestGameJunctionSearch;
+}
+
+/**
+ * Verify junctions, dead ends, and spawn points become nodes joined by
+ * their corridors, including corridors that loop without a junction
+ * @param pTestData - pointer to test container, not used for these tests
+ * @returns error string if any.
+ */
+string JunctionGraphTest::TestBuildGraph(TestUnit::tTestData* pTestData) {
+	char errStr[100] = {0x00};
+
+	// Two corridors crossing in the middle of a solid layer
+	Maze maze(Maze::tDimension(7, 1, 7));
+	for (int x=0; x < 7; x++) {
+		for (int z=0; z < 7; z++) {
+			if (x != 3 && z != 3) { maze.updateCell(Maze::tCoord(x, 0, z), Maze::CELL_SOLID); }
+		}
+	}
+	JunctionGraph graph(maze.getGrid());
+	graph.build();
+	if (graph.getNumNodes() != 5 || graph.getNumEdges() != 4) {
+		sprintf(errStr, "%ld nodes, %ld edges", graph.getNumNodes(), graph.getNumEdges());
+		return "Expected the crossing and 4 dead ends joined by 4 corridors. Got: " + string(errStr);
+	}
+
+	// A spawn point splits the corridor it is in
+	graph.build(Maze::tCoords(1, Maze::tCoord(1, 0, 3)));
+	if (graph.getNumNodes() != 6 || graph.getNumEdges() != 5) {
+		sprintf(errStr, "%ld nodes, %ld edges", graph.getNumNodes(), graph.getNumEdges());
+		return "Expected the spawn point to split a corridor. Got: " + string(errStr);
+	}
+
+	// A ring of corridor with no junction is still connected
+	Maze ring(Maze::tDimension(3, 1, 3));
+	ring.updateCell(Maze::tCoord(1, 0, 1), Maze::CELL_SOLID);
+	JunctionGraph ringGraph(ring.getGrid());
+	ringGraph.build();
+	if (ringGraph.getNumNodes() != 1 || ringGraph.getNumEdges() != 1) {
+		sprintf(errStr, "%ld nodes, %ld edges", ringGraph.getNumNodes(), ringGraph.getNumEdges());
+		return "Expected the ring to be a single looping corridor. Got: " + string(errStr);
+	}
+	JunctionGraph::tRoute route = ringGraph.findRoute(Maze::tCoord(0, 0, 1), Maze::tCoord(2, 0, 1));
+	if (route.size() != 4) {
+		sprintf(errStr, "%d", (int)route.size());
+		return "Expected a route of 4 steps around the ring. Got: " + string(errStr);
+	}
+
+	return "";
+}
+
+/**
+ * Verify routes between every pair of cells are as short as the breadth
+ * first search's, and step through open cells to the destination
+ * @param pTestData - pointer to test container, not used for these tests
+ * @returns error string if any.
+ */
+string JunctionGraphTest::TestFindRoute(TestUnit::tTestData* pTestData) {
+	char errStr[100] = {0x00};
+
+	Maze::tDimension dim = Maze::tDimension(6, 3, 6);
+	Maze maze(dim);
+	srand(11);
+	for (int idx=0; idx < 50; idx++) {
+		maze.updateCell(Maze::tCoord(rand() % 6, rand() % 3, rand() % 6), Maze::CELL_SOLID);
+	}
+	JunctionGraph graph(maze.getGrid());
+	graph.build();
+
+	Maze::tCoords open;
+	for (int x=0; x < dim.width; x++) {
+		for (int y=0; y < dim.height; y++) {
+			for (int z=0; z < dim.depth; z++) {
+				if (maze.getState(Maze::tCoord(x, y, z)) != Maze::CELL_SOLID) {
+					open.push_back(Maze::tCoord(x, y, z));
+				}
+			}
+		}
+	}
+
+	PathFind bfs;
+	bfs.setGrid(maze.getGrid());
+	for (size_t f=0; f < open.size(); f++) {
+		bfs.setLoc(open[f]);
+		for (size_t d=0; d < open.size(); d++) {
+			Maze::tCoord from = open[f];
+			Maze::tCoord dest = open[d];
+			JunctionGraph::tRoute route = graph.findRoute(from, dest);
+			PathFind::tRoute bfsRoute = bfs.findRoute(dest);
+			if (route.size() != bfsRoute.size()) {
+				sprintf(errStr, "%d, shortest is %d", (int)route.size(), (int)bfsRoute.size());
+				return "Route from " + from.String() + " to " + dest.String() + " is not the shortest: " + string(errStr);
+			}
+			if (route.empty()) { continue; }
+
+			// Each step of the route must move to an adjacent open cell
+			string err = TestRoutes::checkRoute(maze, from, dest, route);
+			if (err != "") { return err; }
+		}
+	}
+
+	return "";
+}
+
+/**
+ * Verify a game using the junction search builds the graph and its
+ * bots find their routes with it
+ * @param pTestData - pointer to test container, not used for these tests
+ * @returns error string if any.
+ */
+string JunctionGraphTest::TestGameJunctionSearch(TestUnit::tTestData* pTestData) {
+	EnvConfig cfg;
+	char fileName[] = "test/configs/inputab";
+	if (!cfg.parseEnv(fileName)) {
+		return "Failed to load environment config file";
+	}
+
+	Game game(Maze::STORAGE_CELLS, Maze::LAYOUT_LINEAR, PathFind::SEARCH_JUNCTION);
+	game.buildEnv(cfg);
+	if (game.getJunctionGraph() == NULL || !game.getJunctionGraph()->isCurrent()) {
+		return "Game did not build the junction graph";
+	}
+
+	Bot bot(game.getMaze(), cfg.getBotCoords()['A']);
+	bot.setJunctionGraph(game.getJunctionGraph());
+	if (!bot.calcRoute(cfg.getExitCoord(), PathFind::SEARCH_JUNCTION)) {
+		return "Bot failed to find a route to the exit";
+	}
+
+	// Bot A's shortest route to the exit is 9 steps
+	for (int turn=0; turn < 20 && bot.getLoc() != cfg.getExitCoord(); turn++) {
+		bot.move();
+	}
+	if (bot.getRouteUsed().size() != 9) {
+		return "Expected bot A to reach the exit in 9 steps. Got: " + bot.getRouteUsed();
+	}
+
+	return "";
+}
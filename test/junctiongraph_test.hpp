@@ -0,0 +1,44 @@
+#ifndef _JUNCTIONGRAPH_TEST_HPP_
+#define _JUNCTIONGRAPH_TEST_HPP_
+
+#include <string>
+
+#include "test_unit.hpp"
+
+class JunctionGraphTest : public TestUnit {
+public:
+
+	/**
+	 * Initialize the test, and also make sure to initialize the 
+	 * parent test unit as well.
+	 */
+	JunctionGraphTest();
+
+private:
+
+	/**
+	 * Verify junctions, dead ends, and spawn points become nodes joined by
+	 * their corridors, including corridors that loop without a junction
+	 * @param pTestData - pointer to test container, not used for these tests
+	 * @returns error string if any.
+	 */
+	static std::string TestBuildGraph(TestUnit::tTestData* pTestData);
+
+	/**
+	 * Verify routes between every pair of cells are as short as the breadth
+	 * first search's, and step through open cells to the destination
+	 * @param pTestData - pointer to test container, not used for these tests
+	 * @returns error string if any.
+	 */
+	static std::string TestFindRoute(TestUnit::tTestData* pTestData);
+
+	/**
+	 * Verify a game using the junction search builds the graph and its
+	 * bots find their routes with it
+	 * @param pTestData - pointer to test container, not used for these tests
+	 * @returns error string if any.
+	 */
+	static std::string TestGameJunctionSearch(TestUnit::tTestData* pTestData);
+};
+
+#endif //!defined(_JUNCTIONGRAPH_TEST_HPP_)
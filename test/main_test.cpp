@@ -6,6 +6,15 @@
 #include "env_config_test.hpp"
 #include "pathtree_test.hpp"
 #include "pathfind_test.hpp"
+#include "bitlayer_test.hpp"
+#include "clustergraph_test.hpp"
+#include "distancefield_test.hpp"
+#include "parallelbfs_test.hpp"
+#include "wavefront_test.hpp"
+#include "routecache_test.hpp"
+#include "packedroute_test.hpp"
+#include "junctiongraph_test.hpp"
+#include "arena_test.hpp"
 
 /**
  * Run through all of the test case and report failure for any testcase that fails
@@ -16,7 +25,16 @@ int main(int argc, char* argv[]) {
 		new MazeTest(),
 		new EnvConfigTest(),
 		new PathTreeTest(),
-		new PathFindTest()
+		new PathFindTest(),
+		new BitLayerTest(),
+		new ClusterGraphTest(),
+		new DistanceFieldTest(),
+		new ParallelBfsTest(),
+		new WaveFrontTest(),
+		new RouteCacheTest(),
+		new PackedRouteTest(),
+		new JunctionGraphTest(),
+		new ArenaTest()
 	};
 	int numTests = sizeof(tests)/sizeof(TestUnit*);
 
@@ -3,6 +3,7 @@
 
 #include <stdio.h>
 #include <iostream>
+#include <set>
 
 using namespace std;
 
@@ -14,6 +15,14 @@ MazeTest::MazeTest(): TestUnit() {
 	m_tests["MazeTest::TestCreateMaze"] = &TestCreateMaze;
 	m_tests["MazeTest::TestSetCellState"] = &TestSetCellState;
 	m_tests["MazeTest::TestCoordValidation"] = &TestCoordValidation;
+	m_tests["MazeTest::TestGridNeighbors"] = &TestGridNeighbors;
+	m_tests["MazeTest::TestPackedStorage"] = &TestPackedStorage;
+	m_tests["MazeTest::TestOccupancyOverlay"] = &TestOccupancyOverlay;
+	m_tests["MazeTest::TestGridLayouts"] = &TestGridLayouts;
+	m_tests["MazeTest::TestSparseStorage"] = &TestSparseStorage;
+	m_tests["MazeTest::TestChangeJournal"] = &TestChangeJournal;
+	m_tests["MazeTest::TestReachability"] = &TestReachability;
+	m_tests["MazeTest::TestFillDeadEnds"] = &TestFillDeadEnds;
 }
 
 /**
@@ -64,17 +73,23 @@ string MazeTest::TestCreateMaze(TestUnit::tTestData* pTestData) {
 		return "Maze grid dimensions do not match those specified.";
 	}
 
-	// They layout pointer is set
-	if (grid->layout == NULL) {
-		return "Maze grid layout was not defined.";
+	// They cell buffer is set
+	if (grid->cells == NULL) {
+		return "Maze grid cells were not defined.";
 	}
 
-	// All cells were intitlized to empty, and with their correct coords
+	// Cells only store their state, the coordinates come from the grid
+	if (sizeof(Maze::tCell) != 1) {
+		return "Maze cells are larger than a single byte.";
+	}
+
+	// All cells were intitlized to empty, and map back to their correct coords
 	for (int x=0; x < grid->dim.width; x++) {
 		for (int y=0; y < grid->dim.height; y++) {
 			for (int z=0; z < grid->dim.depth; z++) {
-				Maze::tCell cell = grid->layout[x][y][z];
-				if (cell.state != Maze::CELL_EMPTY || cell.coord.x != x || cell.coord.y != y || cell.coord.z != z) {
+				Maze::tCoord coord = Maze::tCoord(x, y, z);
+				Maze::tCell* pCell = grid->at(coord);
+				if (pCell->state != Maze::CELL_EMPTY || grid->coordOf(pCell) != coord) {
 					return "Maze grid layout not initialized correctly.";
 				}
 			}
@@ -118,10 +133,14 @@ string MazeTest::TestSetCellState(TestUnit::tTestData* pTestData) {
 	if (cell->state != Maze::CELL_SOLID) {
 		return "Unable to set cell to solid state.";
 	}
-	cell = pGrid->at(chg2);
-	if (cell->state != Maze::CELL_OCCUPIED) {
+	if (pMaze->getState(chg2) != Maze::CELL_OCCUPIED) {
 		return "Unable to set cell to occupied state.";
 	}
+	// Occupying a cell only changes the overlay, not the static grid
+	cell = pGrid->at(chg2);
+	if (cell->state != Maze::CELL_EMPTY) {
+		return "Occupying a cell changed the static grid.";
+	}
 	cell = pGrid->at(chg3);
 	if (cell->state != Maze::CELL_EXIT) {
 		return "Unable to set cell to exit state.";
@@ -172,3 +191,398 @@ string MazeTest::TestCoordValidation(TestUnit::tTestData* pTestData) {
 
 	return "";
 }
+
+/**
+ * Verifies neighbors can be found by index, and the grid's border is solid
+ * @params pTestData - test object to store the maze in so it
+ * will get cleaned up in all cases.
+ * @returns error string if there was an error
+ */
+string MazeTest::TestGridNeighbors(TestUnit::tTestData* pTestData) {
+	Maze* pMaze = (Maze*)pTestData->testObj;
+	Maze::tGrid* pGrid = pMaze->getGrid();
+
+	Maze::tCoord coord = Maze::tCoord(5, 3, 1);
+	Maze::tIndex idx = pGrid->index(coord);
+	if (pGrid->indexOf(pGrid->at(coord)) != idx) {
+		return "Cell index does not match the index of its coord.";
+	}
+
+	for (int dir=0; dir < Maze::NUM_DIRECTIONS; dir++) {
+		Maze::tCoord next = coord + Maze::step((Maze::eDirection)dir);
+		if (pGrid->cell(pGrid->neighbor(idx, (Maze::eDirection)dir)) != pGrid->at(next)) {
+			return "Neighbor by index does not match the cell at " + next.String();
+		}
+	}
+
+	// Stepping off of the maze's edge should land in the solid border
+	Maze::tIndex corner = pGrid->index(Maze::tCoord(0, 0, 0));
+	for (int dir=0; dir < Maze::NUM_DIRECTIONS; dir++) {
+		Maze::tIndex next = pGrid->neighbor(corner, (Maze::eDirection)dir);
+		if (next < 0 || next >= pGrid->size) {
+			return "Neighbor of the corner cell is outside of the cell buffer.";
+		}
+	}
+	if (pGrid->cell(pGrid->neighbor(corner, Maze::DIR_WEST))->state != Maze::CELL_SOLID) {
+		return "Maze grid border is not solid.";
+	}
+
+	return "";
+}
+
+/**
+ * Verifies a maze using packed storage tracks its cells' states
+ * @params pTestData - test object to store the maze in so it
+ * will get cleaned up in all cases.
+ * @returns error string if there was an error
+ */
+string MazeTest::TestPackedStorage(TestUnit::tTestData* pTestData) {
+	Maze maze(Maze::tDimension(10, 5, 7), Maze::STORAGE_PACKED);
+	Maze::tGrid* pGrid = maze.getGrid();
+
+	if (!maze.hasGrid() || pGrid->cells != NULL) {
+		return "Packed maze should have a grid without a cell buffer.";
+	}
+	if (pGrid->walls.numWords() != (pGrid->size + 63) / 64) {
+		return "Packed maze is not using one bit per cell for walls.";
+	}
+
+	Maze::tCoord solid = Maze::tCoord(0, 0, 0);
+	Maze::tCoord occupied = Maze::tCoord(5, 3, 1);
+	Maze::tCoord exit = Maze::tCoord(9, 4, 6);
+	if (!maze.updateCell(solid, Maze::CELL_SOLID) ||
+			!maze.updateCell(occupied, Maze::CELL_OCCUPIED) ||
+			!maze.updateCell(exit, Maze::CELL_EXIT)) {
+		return "Failed to update valid cell in packed maze";
+	}
+
+	if (maze.getState(solid) != Maze::CELL_SOLID ||
+			maze.getState(occupied) != Maze::CELL_OCCUPIED ||
+			maze.getState(exit) != Maze::CELL_EXIT ||
+			maze.getState(Maze::tCoord(2, 2, 2)) != Maze::CELL_EMPTY) {
+		return "Packed maze cell states do not match those set.";
+	}
+
+	// The occupied cell leaving should return it to empty
+	maze.updateCell(occupied, Maze::CELL_EMPTY);
+	if (maze.getState(occupied) != Maze::CELL_EMPTY || maze.isOccupied(occupied)) {
+		return "Packed maze failed to clear an occupied cell.";
+	}
+
+	// Only the neighbors inside of the maze, and not solid, are open
+	unsigned int open = pGrid->openNeighbors(pGrid->index(Maze::tCoord(1, 0, 0)));
+	unsigned int expected = (1 << Maze::DIR_SOUTH) | (1 << Maze::DIR_EAST) | (1 << Maze::DIR_UP);
+	if (open != expected) {
+		return "Packed maze open neighbors do not match the walls around the cell.";
+	}
+
+	return "";
+}
+
+/**
+ * Verifies entities can occupy and vacate cells without changing the grid
+ * @params pTestData - test object to store the maze in so it
+ * will get cleaned up in all cases.
+ * @returns error string if there was an error
+ */
+string MazeTest::TestOccupancyOverlay(TestUnit::tTestData* pTestData) {
+	Maze* pMaze = (Maze*)pTestData->testObj;
+	Maze::tGrid* pGrid = pMaze->getGrid();
+
+	Maze::tCoord bot = Maze::tCoord(1, 1, 1);
+	Maze::tCoord exit = Maze::tCoord(1, 1, 2);
+	pMaze->updateCell(exit, Maze::CELL_EXIT);
+
+	if (!pMaze->occupy(bot) || !pMaze->isOccupied(bot) || pMaze->getOccupied().size() != 1) {
+		return "Failed to occupy a cell.";
+	}
+	if (pMaze->occupy(Maze::tCoord(-1, 0, 0))) {
+		return "Occupied a cell outside of the maze.";
+	}
+
+	// An occupied exit is still reported as the exit
+	pMaze->occupy(exit);
+	if (pMaze->getState(exit) != Maze::CELL_EXIT) {
+		return "Occupied exit is no longer reported as an exit.";
+	}
+
+	pMaze->vacate(bot);
+	pMaze->vacate(exit);
+	if (pMaze->isOccupied(bot) || pMaze->getState(bot) != Maze::CELL_EMPTY || !pMaze->getOccupied().empty()) {
+		return "Failed to vacate a cell.";
+	}
+
+	// Walls replacing an occupied cell remove the occupant
+	pMaze->occupy(bot);
+	pMaze->updateCell(bot, Maze::CELL_SOLID);
+	if (pMaze->isOccupied(bot) || pGrid->state(pGrid->index(bot)) != Maze::CELL_SOLID) {
+		return "Making an occupied cell solid did not remove the occupant.";
+	}
+
+	return "";
+}
+
+/**
+ * Verifies the Morton and brick layouts map every cell to a unique index,
+ * and find the same neighbors as the linear layout
+ * @params pTestData - test object to store the maze in so it
+ * will get cleaned up in all cases.
+ * @returns error string if there was an error
+ */
+string MazeTest::TestGridLayouts(TestUnit::tTestData* pTestData) {
+	Maze::eLayout layouts[] = { Maze::LAYOUT_MORTON, Maze::LAYOUT_BRICK };
+	const char* names[] = { "Morton", "brick" };
+
+	for (int l=0; l < 2; l++) {
+		Maze maze(Maze::tDimension(10, 5, 7), Maze::STORAGE_CELLS, layouts[l]);
+		Maze::tGrid* pGrid = maze.getGrid();
+		string name = names[l];
+
+		std::set<Maze::tIndex> seen;
+		for (int x=0; x < 10; x++) {
+			for (int y=0; y < 5; y++) {
+				for (int z=0; z < 7; z++) {
+					Maze::tCoord coord = Maze::tCoord(x, y, z);
+					Maze::tIndex idx = pGrid->index(coord);
+					if (idx < 0 || idx >= pGrid->size || !seen.insert(idx).second) {
+						return name + " layout index is out of range or reused at " + coord.String();
+					}
+					if (pGrid->coord(idx) != coord) {
+						return name + " layout index does not map back to " + coord.String();
+					}
+					if (pGrid->state(idx) != Maze::CELL_EMPTY) {
+						return name + " layout cell was not cleared at " + coord.String();
+					}
+
+					for (int dir=0; dir < Maze::NUM_DIRECTIONS; dir++) {
+						Maze::tCoord next = coord + Maze::step((Maze::eDirection)dir);
+						Maze::tIndex nIdx = pGrid->neighbor(idx, (Maze::eDirection)dir);
+						if (pGrid->contains(next) && nIdx != pGrid->index(next)) {
+							return name + " layout neighbor does not match the cell at " + next.String();
+						}
+						if (!pGrid->contains(next) && pGrid->isOpen(nIdx)) {
+							return name + " layout border is not solid next to " + coord.String();
+						}
+					}
+				}
+			}
+		}
+	}
+
+	return "";
+}
+
+/**
+ * Verifies a maze using sparse storage starts solid, and only allocates
+ * the bricks containing open cells
+ * @params pTestData - test object to store the maze in so it
+ * will get cleaned up in all cases.
+ * @returns error string if there was an error
+ */
+string MazeTest::TestSparseStorage(TestUnit::tTestData* pTestData) {
+	Maze maze(Maze::tDimension(64, 64, 64), Maze::STORAGE_SPARSE);
+	Maze::tGrid* pGrid = maze.getGrid();
+
+	if (pGrid->layout != Maze::LAYOUT_BRICK || pGrid->numChunks != 0) {
+		return "Sparse maze should use bricks, and start with none allocated.";
+	}
+	if (maze.getDefaultState() != Maze::CELL_SOLID || maze.getState(Maze::tCoord(10, 10, 10)) != Maze::CELL_SOLID) {
+		return "Sparse maze did not start out solid.";
+	}
+	if (pGrid->at(Maze::tCoord(10, 10, 10)) != NULL) {
+		return "Sparse maze returned a cell for an unallocated brick.";
+	}
+
+	// Cells within the same brick share its allocation
+	Maze::tCoord open1 = Maze::tCoord(10, 10, 10);
+	Maze::tCoord open2 = Maze::tCoord(11, 10, 10);
+	Maze::tCoord exit = Maze::tCoord(40, 40, 40);
+	maze.updateCell(open1, Maze::CELL_EMPTY);
+	maze.updateCell(open2, Maze::CELL_OCCUPIED);
+	maze.updateCell(exit, Maze::CELL_EXIT);
+	if (pGrid->numChunks != 2) {
+		return "Sparse maze allocated more bricks than cells opened.";
+	}
+
+	if (maze.getState(open1) != Maze::CELL_EMPTY ||
+			maze.getState(open2) != Maze::CELL_OCCUPIED ||
+			maze.getState(exit) != Maze::CELL_EXIT ||
+			maze.getState(Maze::tCoord(12, 10, 10)) != Maze::CELL_SOLID) {
+		return "Sparse maze cell states do not match those set.";
+	}
+
+	unsigned int open = pGrid->openNeighbors(pGrid->index(open1));
+	if (open != (1 << Maze::DIR_EAST)) {
+		return "Sparse maze open neighbors do not match the opened cells.";
+	}
+
+	// Filling an unallocated brick with walls should not allocate it
+	maze.updateCell(Maze::tCoord(60, 0, 0), Maze::CELL_SOLID);
+	if (pGrid->numChunks != 2) {
+		return "Sparse maze allocated a brick for a solid cell.";
+	}
+
+	return "";
+}
+
+/**
+ * Verify the grid records the cells opened or walled off, and reports
+ * when too many have changed to list
+ * @params pTestData - test object to store the maze in so it
+ * will get cleaned up in all cases.
+ * @returns error string if there was an error
+ */
+string MazeTest::TestChangeJournal(TestUnit::tTestData* pTestData) {
+	Maze maze(Maze::tDimension(8, 8, 8));
+	Maze::tGrid* pGrid = maze.getGrid();
+	unsigned long start = pGrid->version;
+
+	// Only changes between open and solid are recorded
+	Maze::tCoord wall = Maze::tCoord(1, 2, 3);
+	Maze::tCoord exit = Maze::tCoord(4, 5, 6);
+	maze.updateCell(wall, Maze::CELL_EMPTY);
+	maze.updateCell(wall, Maze::CELL_SOLID);
+	maze.updateCell(exit, Maze::CELL_SOLID);
+	maze.updateCell(exit, Maze::CELL_EXIT);
+	maze.updateCell(exit, Maze::CELL_OCCUPIED);
+	if (pGrid->version != start + 3) {
+		return "Grid version did not count the cells opened and walled off.";
+	}
+
+	vector<Maze::tIndex> cells;
+	if (!pGrid->changesSince(start, cells) || cells.size() != 3 ||
+			cells[0] != pGrid->index(wall) || cells[1] != pGrid->index(exit) || cells[2] != pGrid->index(exit)) {
+		return "Grid did not list the cells changed in order.";
+	}
+	if (!pGrid->changesSince(pGrid->version, cells) || !cells.empty()) {
+		return "Grid listed changes for its current version.";
+	}
+
+	// Occupying a solid cell opens it
+	maze.updateCell(wall, Maze::CELL_OCCUPIED);
+	if (!pGrid->changesSince(start + 3, cells) || cells.size() != 1 || cells[0] != pGrid->index(wall)) {
+		return "Grid did not record occupying a solid cell.";
+	}
+
+	// Once the oldest changes are dropped they can't be listed
+	for (size_t idx=0; idx < Maze::tGrid::MAX_CHANGES; idx++) {
+		maze.updateCell(wall, idx % 2 == 0 ? Maze::CELL_SOLID : Maze::CELL_EMPTY);
+	}
+	if (pGrid->changesSince(start, cells)) {
+		return "Grid listed changes older than it keeps.";
+	}
+	if (!pGrid->changesSince(pGrid->version - 10, cells) || cells.size() != 10) {
+		return "Grid did not list its most recent changes.";
+	}
+
+	return "";
+}
+
+/**
+ * Verify cells are only reachable from the same connected area, as
+ * walls are added and removed
+ * @params pTestData - test object to store the maze in so it
+ * will get cleaned up in all cases.
+ * @returns error string if there was an error
+ */
+string MazeTest::TestReachability(TestUnit::tTestData* pTestData) {
+	Maze::eStorage storages[] = { Maze::STORAGE_CELLS, Maze::STORAGE_PACKED, Maze::STORAGE_CELLS };
+	Maze::eLayout layouts[] = { Maze::LAYOUT_LINEAR, Maze::LAYOUT_LINEAR, Maze::LAYOUT_MORTON };
+
+	for (int variant=0; variant < 3; variant++) {
+		Maze maze(Maze::tDimension(6, 5, 7), storages[variant], layouts[variant]);
+		Maze::tCoord west = Maze::tCoord(0, 0, 0);
+		Maze::tCoord east = Maze::tCoord(5, 4, 6);
+
+		if (!maze.isReachable(west, east)) {
+			return "Corners of an open maze are not reachable from each other.";
+		}
+
+		// A wall across the X axis splits the maze in two
+		for (int y=0; y < 5; y++) {
+			for (int z=0; z < 7; z++) {
+				maze.updateCell(Maze::tCoord(3, y, z), Maze::CELL_SOLID);
+			}
+		}
+		if (maze.isReachable(west, east)) {
+			return "Cells on either side of a wall are reachable.";
+		}
+		if (!maze.isReachable(west, Maze::tCoord(2, 4, 6)) || !maze.isReachable(east, Maze::tCoord(4, 0, 0))) {
+			return "Cells on the same side of a wall are not reachable.";
+		}
+		if (maze.isReachable(west, Maze::tCoord(3, 2, 2)) || maze.isReachable(west, Maze::tCoord(9, 0, 0))) {
+			return "Solid or invalid cells are reachable.";
+		}
+
+		// A hole in the wall joins the two sides again, then closing it splits them
+		maze.updateCell(Maze::tCoord(3, 2, 2), Maze::CELL_OCCUPIED);
+		if (!maze.isReachable(west, east)) {
+			return "Cells are not reachable through a hole in the wall.";
+		}
+		maze.updateCell(Maze::tCoord(3, 2, 2), Maze::CELL_SOLID);
+		if (maze.isReachable(west, east)) {
+			return "Cells are reachable through a hole that was walled off.";
+		}
+	}
+
+	return "";
+}
+
+/**
+ * Verify cul-de-sacs are filled back to their junction, leaving the
+ * exits and occupied cells open, until the grid changes
+ * @params pTestData - test object to store the maze in so it
+ * will get cleaned up in all cases.
+ * @returns error string if there was an error
+ */
+string MazeTest::TestFillDeadEnds(TestUnit::tTestData* pTestData) {
+	char errStr[100] = {0x00};
+
+	Maze::eStorage storages[] = { Maze::STORAGE_CELLS, Maze::STORAGE_PACKED, Maze::STORAGE_SPARSE };
+	for (int s=0; s < 3; s++) {
+		// A corridor from the bot to the exit, with a branch two cells long
+		Maze maze(Maze::tDimension(5, 1, 5), storages[s]);
+		for (int x=0; x < 5; x++) {
+			for (int z=0; z < 5; z++) {
+				maze.updateCell(Maze::tCoord(x, 0, z), Maze::CELL_SOLID);
+			}
+		}
+		for (int x=0; x < 5; x++) {
+			maze.updateCell(Maze::tCoord(x, 0, 2), Maze::CELL_EMPTY);
+		}
+		maze.updateCell(Maze::tCoord(2, 0, 1), Maze::CELL_EMPTY);
+		maze.updateCell(Maze::tCoord(2, 0, 0), Maze::CELL_EMPTY);
+		maze.updateCell(Maze::tCoord(0, 0, 2), Maze::CELL_OCCUPIED);
+		maze.updateCell(Maze::tCoord(4, 0, 2), Maze::CELL_EXIT);
+
+		long filled = maze.fillDeadEnds();
+		if (filled != 2 || maze.getDeadEndCount() != 2) {
+			sprintf(errStr, "%ld", filled);
+			return "Expected the branch's 2 cells to be filled. Got: " + string(errStr);
+		}
+		if (!maze.isDeadEnd(Maze::tCoord(2, 0, 0)) || !maze.isDeadEnd(Maze::tCoord(2, 0, 1))) {
+			return "Expected the branch to be filled.";
+		}
+		for (int x=0; x < 5; x++) {
+			if (maze.isDeadEnd(Maze::tCoord(x, 0, 2))) {
+				return "Corridor between the bot and exit was filled at " + Maze::tCoord(x, 0, 2).String();
+			}
+		}
+
+		// Without the bot the whole corridor is a cul-de-sac of the exit
+		maze.vacate(Maze::tCoord(0, 0, 2));
+		filled = maze.fillDeadEnds();
+		if (filled != 6 || maze.isDeadEnd(Maze::tCoord(4, 0, 2))) {
+			sprintf(errStr, "%ld", filled);
+			return "Expected every cell but the exit to be filled. Got: " + string(errStr);
+		}
+
+		// Changing the grid leaves the filled cells out of date
+		maze.updateCell(Maze::tCoord(0, 0, 3), Maze::CELL_EMPTY);
+		if (maze.isDeadEnd(Maze::tCoord(2, 0, 0)) || maze.getGrid()->hasDeadEnds()) {
+			return "Filled cells are still reported after the grid changed.";
+		}
+	}
+
+	return "";
+}
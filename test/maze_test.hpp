@@ -40,6 +40,75 @@ private:
 	 */
 	static std::string TestCoordValidation(TestUnit::tTestData* pTestData);
 
+	/**
+	 * Verifies neighbors can be found by index, and the grid's border is solid
+	 * @params pTestData - test object to store the maze in so it
+	 * will get cleaned up in all cases.
+	 * @returns error string if there was an error
+	 */
+	static std::string TestGridNeighbors(TestUnit::tTestData* pTestData);
+
+	/**
+	 * Verifies a maze using packed storage tracks its cells' states
+	 * @params pTestData - test object to store the maze in so it
+	 * will get cleaned up in all cases.
+	 * @returns error string if there was an error
+	 */
+	static std::string TestPackedStorage(TestUnit::tTestData* pTestData);
+
+	/**
+	 * Verifies entities can occupy and vacate cells without changing the grid
+	 * @params pTestData - test object to store the maze in so it
+	 * will get cleaned up in all cases.
+	 * @returns error string if there was an error
+	 */
+	static std::string TestOccupancyOverlay(TestUnit::tTestData* pTestData);
+
+	/**
+	 * Verifies the Morton and brick layouts map every cell to a unique index,
+	 * and find the same neighbors as the linear layout
+	 * @params pTestData - test object to store the maze in so it
+	 * will get cleaned up in all cases.
+	 * @returns error string if there was an error
+	 */
+	static std::string TestGridLayouts(TestUnit::tTestData* pTestData);
+
+	/**
+	 * Verifies a maze using sparse storage starts solid, and only allocates
+	 * the bricks containing open cells
+	 * @params pTestData - test object to store the maze in so it
+	 * will get cleaned up in all cases.
+	 * @returns error string if there was an error
+	 */
+	static std::string TestSparseStorage(TestUnit::tTestData* pTestData);
+
+	/**
+	 * Verify the grid records the cells opened or walled off, and reports
+	 * when too many have changed to list
+	 * @params pTestData - test object to store the maze in so it
+	 * will get cleaned up in all cases.
+	 * @returns error string if there was an error
+	 */
+	static std::string TestChangeJournal(TestUnit::tTestData* pTestData);
+
+	/**
+	 * Verify cells are only reachable from the same connected area, as
+	 * walls are added and removed
+	 * @params pTestData - test object to store the maze in so it
+	 * will get cleaned up in all cases.
+	 * @returns error string if there was an error
+	 */
+	static std::string TestReachability(TestUnit::tTestData* pTestData);
+
+	/**
+	 * Verify cul-de-sacs are filled back to their junction, leaving the
+	 * exits and occupied cells open, until the grid changes
+	 * @params pTestData - test object to store the maze in so it
+	 * will get cleaned up in all cases.
+	 * @returns error string if there was an error
+	 */
+	static std::string TestFillDeadEnds(TestUnit::tTestData* pTestData);
+
 	/**
 	 * Create a new maze object before each test which is nitialized.
 	 * @returns test data object container.
@@ -0,0 +1,99 @@
+#include "packedroute_test.hpp"
+#include "packedroute.hpp"
+#include "pathfind.hpp"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+using namespace std;
+
+/**
+ * Initialize the test, and also make sure to initialize the 
+ * parent test unit as well.
+ */
+PackedRouteTest::PackedRouteTest(): TestUnit() {
+	m_tests["PackedRouteTest::TestAppendSteps"] = &TestAppendSteps;
+	m_tests["PackedRouteTest::TestWalkFoundRoute"] = &TestWalkFoundRoute;
+}
+
+/**
+ * Verify steps appended across several words are read back in order
+ * @param pTestData - pointer to test container, not used for these tests
+ * @returns error string if any.
+ */
+string PackedRouteTest::TestAppendSteps(TestUnit::tTestData* pTestData) {
+	char errStr[100] = {0x00};
+
+	PackedRoute route(Maze::tCoord(5,5,5));
+	if (!route.done() || route.size() != 0 || route.String() != "") {
+		return "Expected a new route to be empty";
+	}
+
+	// Enough steps to fill more than two words
+	int numSteps = PackedRoute::STEPS_PER_WORD * 2 + 5;
+	string expected;
+	for (int pos=0; pos < numSteps; pos++) {
+		route.append((Maze::eDirection)(pos % Maze::NUM_DIRECTIONS));
+		expected += "NSEWUD"[pos % Maze::NUM_DIRECTIONS];
+	}
+	if (route.size() != (size_t)numSteps || route.String() != expected) {
+		return "Expected the steps back in order. Got: " + route.String();
+	}
+	if (route.bytes() > 3 * sizeof(uint64_t) * 2) {
+		sprintf(errStr, "%d", (int)route.bytes());
+		return "Expected the steps to be packed into a few words. Got bytes: " + string(errStr);
+	}
+
+	// North then south returns to the start
+	route.advance();
+	if (route.getLoc() != Maze::tCoord(5,5,4) || route.next() != Maze::tCoord(5,5,5)) {
+		return "Expected the cursor to step north. At: " + route.getLoc().String();
+	}
+	if (route.remaining() != (size_t)numSteps - 1) {
+		return "Expected one step to be taken";
+	}
+
+	return "";
+}
+
+/**
+ * Verify a route found by PathFind is walked cell by cell with the cursor
+ * @param pTestData - pointer to test container, not used for these tests
+ * @returns error string if any.
+ */
+string PackedRouteTest::TestWalkFoundRoute(TestUnit::tTestData* pTestData) {
+	Maze maze(Maze::tDimension(8, 8, 8));
+	srand(3);
+	for (int idx=0; idx < 100; idx++) {
+		maze.updateCell(Maze::tCoord(rand() % 8, rand() % 8, rand() % 8), Maze::CELL_SOLID);
+	}
+	Maze::tCoord from = Maze::tCoord(0,0,0);
+	Maze::tCoord dest = Maze::tCoord(7,7,7);
+	maze.updateCell(from, Maze::CELL_EMPTY);
+	maze.updateCell(dest, Maze::CELL_EMPTY);
+
+	PathFind pathfinder;
+	pathfinder.setGrid(maze.getGrid());
+	pathfinder.setLoc(from);
+	PathFind::tRoute found = pathfinder.findRoute(dest);
+	if (found.empty()) {
+		return "Expected a route through the maze";
+	}
+
+	PackedRoute route(from, found);
+	if (route.size() != found.size()) {
+		return "Expected a packed step for every cell of the route";
+	}
+	while (!found.empty()) {
+		if (route.done() || route.next() != found.top()) {
+			return "Packed route leaves the found route at " + route.getLoc().String();
+		}
+		route.advance();
+		found.pop();
+	}
+	if (!route.done() || route.getLoc() != dest) {
+		return "Expected the packed route to end at the destination";
+	}
+
+	return "";
+}
@@ -0,0 +1,34 @@
+#ifndef _PACKEDROUTE_TEST_HPP_
+#define _PACKEDROUTE_TEST_HPP_
+
+#include <string>
+
+#include "test_unit.hpp"
+
+class PackedRouteTest : public TestUnit {
+public:
+
+	/**
+	 * Initialize the test, and also make sure to initialize the 
+	 * parent test unit as well.
+	 */
+	PackedRouteTest();
+
+private:
+
+	/**
+	 * Verify steps appended across several words are read back in order
+	 * @param pTestData - pointer to test container, not used for these tests
+	 * @returns error string if any.
+	 */
+	static std::string TestAppendSteps(TestUnit::tTestData* pTestData);
+
+	/**
+	 * Verify a route found by PathFind is walked cell by cell with the cursor
+	 * @param pTestData - pointer to test container, not used for these tests
+	 * @returns error string if any.
+	 */
+	static std::string TestWalkFoundRoute(TestUnit::tTestData* pTestData);
+};
+
+#endif //!defined(_PACKEDROUTE_TEST_HPP_)
@@ -0,0 +1,120 @@
+#include "parallelbfs_test.hpp"
+#include "parallelbfs.hpp"
+#include "pathfind.hpp"
+#include "test_routes.hpp"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+using namespace std;
+
+/**
+ * Initialize the test, and also make sure to initialize the 
+ * parent test unit as well.
+ */
+ParallelBfsTest::ParallelBfsTest(): TestUnit() {
+	m_tests["ParallelBfsTest::TestRouteLengths"] = &TestRouteLengths;
+	m_tests["ParallelBfsTest::TestBottomUp"] = &TestBottomUp;
+	m_tests["ParallelBfsTest::TestUnreachable"] = &TestUnreachable;
+}
+
+/**
+ * Verify the routes found with several threads are as long as the
+ * routes found by the serial breadth first search, and are valid
+ * @param pTestData - pointer to test container, not used for these tests
+ * @returns error string if any.
+ */
+string ParallelBfsTest::TestRouteLengths(TestUnit::tTestData* pTestData) {
+	char errStr[100] = {0x00};
+
+	Maze::eLayout layouts[] = { Maze::LAYOUT_LINEAR, Maze::LAYOUT_MORTON };
+	for (int l=0; l < 2; l++) {
+		Maze maze(Maze::tDimension(20, 12, 20), Maze::STORAGE_CELLS, layouts[l]);
+		srand(7);
+		for (int idx=0; idx < 20 * 12 * 20 / 4; idx++) {
+			maze.updateCell(Maze::tCoord(rand() % 20, rand() % 12, rand() % 20), Maze::CELL_SOLID);
+		}
+
+		ParallelBfs parallel(maze.getGrid(), 4);
+		PathFind bfs, pathfinder;
+		bfs.setGrid(maze.getGrid());
+		pathfinder.setGrid(maze.getGrid());
+		pathfinder.setStrategy(PathFind::SEARCH_PARALLEL_BFS);
+		pathfinder.setParallelBfs(&parallel);
+
+		for (int idx=0; idx < 50; idx++) {
+			Maze::tCoord from = Maze::tCoord(rand() % 20, rand() % 12, rand() % 20);
+			Maze::tCoord dest = Maze::tCoord(rand() % 20, rand() % 12, rand() % 20);
+			if (maze.getState(from) == Maze::CELL_SOLID || maze.getState(dest) == Maze::CELL_SOLID) { continue; }
+
+			bfs.setLoc(from);
+			pathfinder.setLoc(from);
+			PathFind::tRoute expected = bfs.findRoute(dest);
+			PathFind::tRoute route = pathfinder.findRoute(dest);
+			if (route.size() != expected.size()) {
+				sprintf(errStr, "%d, expected %d", (int)route.size(), (int)expected.size());
+				return "Route from " + from.String() + " to " + dest.String() + " has the wrong length: " + string(errStr);
+			}
+
+			if (route.empty()) { continue; }
+
+			// Each step of the route must move to an adjacent open cell
+			string err = TestRoutes::checkRoute(maze, from, dest, route);
+			if (err != "") { return err; }
+		}
+	}
+
+	return "";
+}
+
+/**
+ * Verify levels of an open maze are expanded bottom up, and the route
+ * is still the shortest
+ * @param pTestData - pointer to test container, not used for these tests
+ * @returns error string if any.
+ */
+string ParallelBfsTest::TestBottomUp(TestUnit::tTestData* pTestData) {
+	char errStr[100] = {0x00};
+
+	Maze maze(Maze::tDimension(16, 16, 16));
+	ParallelBfs parallel(maze.getGrid(), 3);
+	if (parallel.getNumThreads() != 3) {
+		return "Expected the search to use 3 threads";
+	}
+
+	ParallelBfs::tRoute route = parallel.findRoute(Maze::tCoord(0,0,0), Maze::tCoord(15,15,15));
+	if (route.size() != 45) {
+		sprintf(errStr, "%d", (int)route.size());
+		return "Expected a route of 45 steps. Got: " + string(errStr);
+	}
+	if (parallel.getBottomUpLevels() == 0) {
+		return "Expected the widest levels of an open maze to be expanded bottom up";
+	}
+
+	return "";
+}
+
+/**
+ * Verify walled off destinations have no route, and that walls added
+ * after a search are seen by the next one
+ * @param pTestData - pointer to test container, not used for these tests
+ * @returns error string if any.
+ */
+string ParallelBfsTest::TestUnreachable(TestUnit::tTestData* pTestData) {
+	Maze maze(Maze::tDimension(8, 8, 8));
+	ParallelBfs parallel(maze.getGrid(), 2);
+	if (parallel.findRoute(Maze::tCoord(0,0,0), Maze::tCoord(7,7,7)).empty()) {
+		return "Expected a route across the open maze";
+	}
+
+	// Wall off the destination's corner
+	TestRoutes::wallOff(maze, Maze::tCoord(7,7,7));
+	if (!parallel.findRoute(Maze::tCoord(0,0,0), Maze::tCoord(7,7,7)).empty()) {
+		return "Expected no route to the walled off corner";
+	}
+	if (!parallel.findRoute(Maze::tCoord(0,0,0), Maze::tCoord(7,7,6)).empty()) {
+		return "Expected no route to a solid cell";
+	}
+
+	return "";
+}
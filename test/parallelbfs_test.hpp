@@ -0,0 +1,44 @@
+#ifndef _PARALLELBFS_TEST_HPP_
+#define _PARALLELBFS_TEST_HPP_
+
+#include <string>
+
+#include "test_unit.hpp"
+
+class ParallelBfsTest : public TestUnit {
+public:
+
+	/**
+	 * Initialize the test, and also make sure to initialize the 
+	 * parent test unit as well.
+	 */
+	ParallelBfsTest();
+
+private:
+
+	/**
+	 * Verify the routes found with several threads are as long as the
+	 * routes found by the serial breadth first search, and are valid
+	 * @param pTestData - pointer to test container, not used for these tests
+	 * @returns error string if any.
+	 */
+	static std::string TestRouteLengths(TestUnit::tTestData* pTestData);
+
+	/**
+	 * Verify levels of an open maze are expanded bottom up, and the route
+	 * is still the shortest
+	 * @param pTestData - pointer to test container, not used for these tests
+	 * @returns error string if any.
+	 */
+	static std::string TestBottomUp(TestUnit::tTestData* pTestData);
+
+	/**
+	 * Verify walled off destinations have no route, and that walls added
+	 * after a search are seen by the next one
+	 * @param pTestData - pointer to test container, not used for these tests
+	 * @returns error string if any.
+	 */
+	static std::string TestUnreachable(TestUnit::tTestData* pTestData);
+};
+
+#endif //!defined(_PARALLELBFS_TEST_HPP_)
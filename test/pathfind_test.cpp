@@ -1,5 +1,7 @@
 #include "pathfind_test.hpp"
+#include "test_routes.hpp"
 
+#include <stdlib.h>
 #include <stdio.h>
 #include <iostream>
 
@@ -12,6 +14,16 @@ using namespace std;
  */
 PathFindTest::PathFindTest(): TestUnit() {
 	m_tests["PathFindTest::TestGeneratePathTreeFromGrid"] = &TestGeneratePathTreeFromGrid;
+	m_tests["PathFindTest::TestRouteOnGridVariants"] = &TestRouteOnGridVariants;
+	m_tests["PathFindTest::TestBfsRoute"] = &TestBfsRoute;
+	m_tests["PathFindTest::TestAStarRoute"] = &TestAStarRoute;
+	m_tests["PathFindTest::TestBidirectionalRoute"] = &TestBidirectionalRoute;
+	m_tests["PathFindTest::TestJumpPointRoute"] = &TestJumpPointRoute;
+	m_tests["PathFindTest::TestIncrementalRoute"] = &TestIncrementalRoute;
+	m_tests["PathFindTest::TestNearestRoute"] = &TestNearestRoute;
+	m_tests["PathFindTest::TestDeadEndPruning"] = &TestDeadEndPruning;
+	m_tests["PathFindTest::TestTreeReuse"] = &TestTreeReuse;
+	m_tests["PathFindTest::TestBlockedBot"] = &TestBlockedBot;
 }
 
 /**
@@ -53,7 +65,8 @@ void PathFindTest::afterEach(TestUnit::tTestData* pTestData) {
 }
 
 /**
- * Verifies a grid can be loaded, and a path tree generated from it.
+ * Verifies a grid can be loaded, and a path tree generated from it. Open
+ * mazes must not add a cell to the tree more than once.
  * @param pTestData - pointer to test container, not used for these tests
  * @returns error string if any.
  */
@@ -66,11 +79,12 @@ string PathFindTest::TestGeneratePathTreeFromGrid(TestUnit::tTestData* pTestData
 
 	PathFind pathfinder;
 	pathfinder.setGrid(pMaze->getGrid());
+	pathfinder.setStrategy(PathFind::SEARCH_TREE);
 
 	pathfinder.setLoc(Maze::tCoord(0,0,0));
 	Maze::tCoord destCoord = Maze::tCoord(0,0,1);
 	PathFind::tRoute route = pathfinder.findRoute(destCoord);
-	if (route.size() != 1 && route.top()->coord == destCoord) {
+	if (route.size() != 1 && route.top() == destCoord) {
 		return "Failed to find route to cell directly south of starting point";
 	}
 
@@ -82,5 +96,617 @@ string PathFindTest::TestGeneratePathTreeFromGrid(TestUnit::tTestData* pTestData
 		return "Failed to find route dest at " + destCoord.String();
 	}
 
+	// Every cell of an open cube joins the tree once, however many
+	// routes without loops lead to it
+	Maze openMaze(Maze::tDimension(16, 16, 16));
+	pathfinder.setGrid(openMaze.getGrid());
+	pathfinder.setLoc(Maze::tCoord(0,0,0));
+	destCoord = Maze::tCoord(15,15,15);
+	route = pathfinder.findRoute(destCoord);
+	if (route.size() != 45) {
+		sprintf(errStr, "%d", (int)route.size());
+		return "Expected a route of 45 steps across the open cube. Got: " + string(errStr);
+	}
+	if (pathfinder.getExpandedCount() > 16 * 16 * 16) {
+		return "Tree search expanded cells more than once";
+	}
+
+	// The next search starts a new tree
+	pathfinder.setLoc(Maze::tCoord(15,0,0));
+	route = pathfinder.findRoute(Maze::tCoord(0,0,0));
+	if (route.size() != 15 || *(pathfinder.getTree()) != Maze::tCoord(15,0,0)) {
+		return "Expected a new tree for the second search across the open cube";
+	}
+
+	return "";
+}
+
+/**
+ * Verifies a route is found through mazes using the packed and sparse
+ * storage, and the non linear layouts
+ * @param pTestData - pointer to test container, not used for these tests
+ * @returns error string if any.
+ */
+string PathFindTest::TestRouteOnGridVariants(TestUnit::tTestData* pTestData) {
+	EnvConfig cfg;
+	char fileName[] = "test/configs/input00";
+	if (!cfg.parseEnv(fileName)) {
+		return "Failed to load environment config file";
+	}
+
+	// Cover the packed and sparse storage, and the non linear layouts
+	Maze::eStorage storages[] = { Maze::STORAGE_PACKED, Maze::STORAGE_PACKED, Maze::STORAGE_CELLS, Maze::STORAGE_SPARSE };
+	Maze::eLayout layouts[] = { Maze::LAYOUT_LINEAR, Maze::LAYOUT_MORTON, Maze::LAYOUT_BRICK, Maze::LAYOUT_BRICK };
+	for (int idx=0; idx < 4; idx++) {
+		Game game(storages[idx], layouts[idx]);
+		game.buildEnv(cfg);
+
+		PathFind pathfinder;
+		pathfinder.setGrid(game.getMaze()->getGrid());
+		pathfinder.setLoc(Maze::tCoord(0,0,0));
+		Maze::tCoord destCoord = Maze::tCoord(2,1,2);
+		PathFind::tRoute route = pathfinder.findRoute(destCoord);
+		if (route.size() != 15) {
+			return "Failed to find route dest at " + destCoord.String() + " in grid variant " + string(1, '0' + idx);
+		}
+	}
+
+	return "";
+}
+
+/**
+ * Verifies the breadth first search finds the shortest route, handles
+ * large open mazes, and returns no route for unreachable cells.
+ * @param pTestData - pointer to test container, not used for these tests
+ * @returns error string if any.
+ */
+string PathFindTest::TestBfsRoute(TestUnit::tTestData* pTestData) {
+	char errStr[100] = {0x00};
+
+	tTestCont* pCont = (tTestCont*)pTestData->testObj;
+	if (pCont == NULL || pCont->pMaze == NULL) { return "Test data not loaded."; }
+
+	PathFind pathfinder;
+	pathfinder.setGrid(pCont->pMaze->getGrid());
+	pathfinder.setStrategy(PathFind::SEARCH_BFS);
+	pathfinder.setLoc(Maze::tCoord(0,0,0));
+	Maze::tCoord destCoord = Maze::tCoord(2,1,2);
+	PathFind::tRoute route = pathfinder.findRoute(destCoord);
+	if (route.size() != 15) {
+		sprintf(errStr, "%d", (int)route.size());
+		return "Expected a route of 15 steps to " + destCoord.String() + ". Got: " + string(errStr);
+	}
+
+	// Each step of the route must move to an adjacent open cell
+	string err = TestRoutes::checkRoute(*(pCont->pMaze), Maze::tCoord(0,0,0), destCoord, route);
+	if (err != "") { return err; }
+
+	// Open cube, the route must be the manhattan distance between the corners
+	Maze openMaze(Maze::tDimension(64, 64, 64));
+	pathfinder.setGrid(openMaze.getGrid());
+	pathfinder.setLoc(Maze::tCoord(0,0,0));
+	destCoord = Maze::tCoord(63,63,63);
+	route = pathfinder.findRoute(destCoord);
+	if (route.size() != 189) {
+		sprintf(errStr, "%d", (int)route.size());
+		return "Expected a route of 189 steps across the open cube. Got: " + string(errStr);
+	}
+	if (pathfinder.getExpandedCount() > 64 * 64 * 64) {
+		return "Search expanded cells more than once";
+	}
+
+	// Wall off the destination so it cannot be reached
+	err = TestRoutes::checkWalledOff(openMaze, pathfinder, destCoord);
+	if (err != "") { return err; }
+
+	return "";
+}
+
+/**
+ * Verifies A* finds routes as short as the breadth first search while
+ * expanding fewer cells.
+ * @param pTestData - pointer to test container, not used for these tests
+ * @returns error string if any.
+ */
+string PathFindTest::TestAStarRoute(TestUnit::tTestData* pTestData) {
+	char errStr[100] = {0x00};
+
+	tTestCont* pCont = (tTestCont*)pTestData->testObj;
+	if (pCont == NULL || pCont->pMaze == NULL) { return "Test data not loaded."; }
+
+	PathFind pathfinder;
+	pathfinder.setGrid(pCont->pMaze->getGrid());
+	pathfinder.setStrategy(PathFind::SEARCH_ASTAR);
+	pathfinder.setLoc(Maze::tCoord(0,0,0));
+	Maze::tCoord destCoord = Maze::tCoord(2,1,2);
+	PathFind::tRoute route = pathfinder.findRoute(destCoord);
+	if (route.size() != 15) {
+		sprintf(errStr, "%d", (int)route.size());
+		return "Expected a route of 15 steps to " + destCoord.String() + ". Got: " + string(errStr);
+	}
+
+	// Heading straight across an open cube only expands the cells along the route
+	Maze openMaze(Maze::tDimension(64, 64, 64));
+	pathfinder.setGrid(openMaze.getGrid());
+	destCoord = Maze::tCoord(63,63,63);
+	route = pathfinder.findRoute(destCoord);
+	if (route.size() != 189) {
+		sprintf(errStr, "%d", (int)route.size());
+		return "Expected a route of 189 steps across the open cube. Got: " + string(errStr);
+	}
+	if (pathfinder.getExpandedCount() > 190) {
+		sprintf(errStr, "%ld", pathfinder.getExpandedCount());
+		return "Expected A* to only expand the route across the open cube. Expanded: " + string(errStr);
+	}
+
+	// Walls forcing detours must give the same route length as breadth first
+	string err = TestRoutes::checkDetours(openMaze, PathFind::SEARCH_ASTAR, 5);
+	if (err != "") { return err; }
+
+	// Wall off the destination so it cannot be reached
+	err = TestRoutes::checkWalledOff(openMaze, pathfinder, destCoord);
+	if (err != "") { return err; }
+
+	return "";
+}
+
+/**
+ * Verifies the bidirectional search finds routes as short as the
+ * breadth first search, which are connected from start to destination.
+ * @param pTestData - pointer to test container, not used for these tests
+ * @returns error string if any.
+ */
+string PathFindTest::TestBidirectionalRoute(TestUnit::tTestData* pTestData) {
+	char errStr[100] = {0x00};
+
+	tTestCont* pCont = (tTestCont*)pTestData->testObj;
+	if (pCont == NULL || pCont->pMaze == NULL) { return "Test data not loaded."; }
+
+	PathFind pathfinder;
+	pathfinder.setGrid(pCont->pMaze->getGrid());
+	pathfinder.setStrategy(PathFind::SEARCH_BIDIRECTIONAL);
+	pathfinder.setLoc(Maze::tCoord(0,0,0));
+	Maze::tCoord destCoord = Maze::tCoord(2,1,2);
+	PathFind::tRoute route = pathfinder.findRoute(destCoord);
+	if (route.size() != 15) {
+		sprintf(errStr, "%d", (int)route.size());
+		return "Expected a route of 15 steps to " + destCoord.String() + ". Got: " + string(errStr);
+	}
+
+	// Directly next to the start, the sides meet at the destination
+	route = pathfinder.findRoute(Maze::tCoord(0,0,1));
+	if (route.size() != 1 || route.top() != Maze::tCoord(0,0,1)) {
+		return "Failed to find route to cell directly south of starting point";
+	}
+
+	// Walls forcing detours must give the same route length as breadth
+	// first, while expanding fewer cells
+	Maze maze(Maze::tDimension(48, 48, 48));
+	long expanded = 0, bfsExpanded = 0;
+	string err = TestRoutes::checkDetours(maze, PathFind::SEARCH_BIDIRECTIONAL, 9, &expanded, &bfsExpanded);
+	if (err != "") { return err; }
+	if (expanded >= bfsExpanded) {
+		return "Bidirectional search expanded as many cells as breadth first";
+	}
+
+	// Wall off the destination so it cannot be reached
+	pathfinder.setGrid(maze.getGrid());
+	destCoord = Maze::tCoord(47,47,47);
+	err = TestRoutes::checkWalledOff(maze, pathfinder, destCoord);
+	if (err != "") { return err; }
+
+	return "";
+}
+
+/**
+ * Verifies the jump point search finds routes as short as the breadth
+ * first search, filled in with every cell, while expanding few cells
+ * in open rooms.
+ * @param pTestData - pointer to test container, not used for these tests
+ * @returns error string if any.
+ */
+string PathFindTest::TestJumpPointRoute(TestUnit::tTestData* pTestData) {
+	char errStr[100] = {0x00};
+
+	tTestCont* pCont = (tTestCont*)pTestData->testObj;
+	if (pCont == NULL || pCont->pMaze == NULL) { return "Test data not loaded."; }
+
+	PathFind pathfinder;
+	pathfinder.setGrid(pCont->pMaze->getGrid());
+	pathfinder.setStrategy(PathFind::SEARCH_JUMP_POINT);
+	pathfinder.setLoc(Maze::tCoord(0,0,0));
+	Maze::tCoord destCoord = Maze::tCoord(2,1,2);
+	PathFind::tRoute route = pathfinder.findRoute(destCoord);
+	if (route.size() != 15) {
+		sprintf(errStr, "%d", (int)route.size());
+		return "Expected a route of 15 steps to " + destCoord.String() + ". Got: " + string(errStr);
+	}
+
+	// Across an open room only the corners of the route are expanded
+	Maze maze(Maze::tDimension(48, 48, 48));
+	pathfinder.setGrid(maze.getGrid());
+	destCoord = Maze::tCoord(47,47,47);
+	route = pathfinder.findRoute(destCoord);
+	if (route.size() != 141) {
+		sprintf(errStr, "%d", (int)route.size());
+		return "Expected a route of 141 steps across the open room. Got: " + string(errStr);
+	}
+	if (pathfinder.getExpandedCount() > 4) {
+		sprintf(errStr, "%ld", pathfinder.getExpandedCount());
+		return "Expected only the route's corners to be expanded. Expanded: " + string(errStr);
+	}
+	// The cells jumped over are still scanned, at least every cell of the route
+	if (pathfinder.getScannedCount() < (long)route.size()) {
+		sprintf(errStr, "%ld", pathfinder.getScannedCount());
+		return "Expected the jumps to scan every cell of the route. Scanned: " + string(errStr);
+	}
+
+	// Walls forcing detours must give the same route length as breadth
+	// first, with every cell of the route filled in
+	string err = TestRoutes::checkDetours(maze, PathFind::SEARCH_JUMP_POINT, 11);
+	if (err != "") { return err; }
+
+	// Wall off the destination so it cannot be reached
+	err = TestRoutes::checkWalledOff(maze, pathfinder, destCoord);
+	if (err != "") { return err; }
+
+	return "";
+}
+
+/**
+ * Verifies the incremental search keeps finding routes as short as the
+ * breadth first search while the starting point moves and cells change,
+ * and that a single changed cell is repaired without searching again.
+ * @param pTestData - pointer to test container, not used for these tests
+ * @returns error string if any.
+ */
+string PathFindTest::TestIncrementalRoute(TestUnit::tTestData* pTestData) {
+	char errStr[100] = {0x00};
+
+	tTestCont* pCont = (tTestCont*)pTestData->testObj;
+	if (pCont == NULL || pCont->pMaze == NULL) { return "Test data not loaded."; }
+
+	PathFind pathfinder;
+	pathfinder.setGrid(pCont->pMaze->getGrid());
+	pathfinder.setStrategy(PathFind::SEARCH_INCREMENTAL);
+	pathfinder.setLoc(Maze::tCoord(0,0,0));
+	Maze::tCoord destCoord = Maze::tCoord(2,1,2);
+	PathFind::tRoute route = pathfinder.findRoute(destCoord);
+	if (route.size() != 15) {
+		sprintf(errStr, "%d", (int)route.size());
+		return "Expected a route of 15 steps to " + destCoord.String() + ". Got: " + string(errStr);
+	}
+
+	// Walk a route through random walls, changing cells along the way
+	Maze maze(Maze::tDimension(24, 12, 24));
+	srand(13);
+	for (int idx=0; idx < 24 * 12 * 24 / 4; idx++) {
+		maze.updateCell(Maze::tCoord(rand() % 24, rand() % 12, rand() % 24), Maze::CELL_SOLID);
+	}
+	Maze::tCoord loc = Maze::tCoord(0,0,0);
+	destCoord = Maze::tCoord(23,11,23);
+	maze.updateCell(loc, Maze::CELL_EMPTY);
+	maze.updateCell(destCoord, Maze::CELL_EMPTY);
+
+	pathfinder.setGrid(maze.getGrid());
+	PathFind bfs;
+	bfs.setGrid(maze.getGrid());
+	bfs.setStrategy(PathFind::SEARCH_BFS);
+	for (int move=0; move < 200 && loc != destCoord; move++) {
+		// Open or wall off a few cells, sometimes on the current route
+		for (int change=0; change < 3; change++) {
+			Maze::tCoord cell = Maze::tCoord(rand() % 24, rand() % 12, rand() % 24);
+			if (!route.empty() && rand() % 2 == 0) { cell = route.top(); }
+			if (cell == loc || cell == destCoord) { continue; }
+			maze.updateCell(cell, maze.getState(cell) == Maze::CELL_SOLID ? Maze::CELL_EMPTY : Maze::CELL_SOLID);
+		}
+
+		pathfinder.setLoc(loc);
+		bfs.setLoc(loc);
+		route = pathfinder.findRoute(destCoord);
+		PathFind::tRoute bfsRoute = bfs.findRoute(destCoord);
+		if (route.size() != bfsRoute.size()) {
+			sprintf(errStr, "%d != %d", (int)route.size(), (int)bfsRoute.size());
+			return "Incremental route length from " + loc.String() + " does not match breadth first: " + string(errStr);
+		}
+		if (route.empty()) { continue; }
+
+		// Each step of the route must move to an adjacent open cell
+		string err = TestRoutes::checkRoute(maze, loc, destCoord, route);
+		if (err != "") { return err; }
+
+		loc = route.top();
+		route.pop();
+	}
+
+	// Walling off a cell of the route across an open cube only repairs the
+	// cells around it
+	Maze openMaze(Maze::tDimension(32, 32, 32));
+	pathfinder.setGrid(openMaze.getGrid());
+	pathfinder.setLoc(Maze::tCoord(0,0,0));
+	destCoord = Maze::tCoord(31,31,31);
+	route = pathfinder.findRoute(destCoord);
+	long fullExpanded = pathfinder.getExpandedCount();
+	for (int idx=0; idx < 40; idx++) { route.pop(); }
+	openMaze.updateCell(route.top(), Maze::CELL_SOLID);
+
+	route = pathfinder.findRoute(destCoord);
+	if (route.size() != 93) {
+		sprintf(errStr, "%d", (int)route.size());
+		return "Expected a route of 93 steps around the wall. Got: " + string(errStr);
+	}
+	if (pathfinder.getExpandedCount() * 100 > fullExpanded) {
+		sprintf(errStr, "%ld of %ld", pathfinder.getExpandedCount(), fullExpanded);
+		return "Repairing a single wall expanded too many cells: " + string(errStr);
+	}
+
+	// Wall off the destination so it cannot be reached
+	string err = TestRoutes::checkWalledOff(openMaze, pathfinder, destCoord);
+	if (err != "") { return err; }
+
+	return "";
+}
+
+/**
+ * Verifies routes to the nearest of several exits are as short as the
+ * shortest route to any one of them, with and without a distance field.
+ * @param pTestData - pointer to test container, not used for these tests
+ * @returns error string if any.
+ */
+string PathFindTest::TestNearestRoute(TestUnit::tTestData* pTestData) {
+	char errStr[100] = {0x00};
+
+	EnvConfig cfg;
+	char fileName[] = "test/configs/inputab_exits";
+	if (!cfg.parseEnv(fileName)) {
+		return "Failed to load environment config file";
+	}
+	Game game;
+	game.buildEnv(cfg);
+	Maze* pMaze = game.getMaze();
+	Maze::tCoords exits = cfg.getExitCoords();
+
+	DistanceField field(pMaze->getGrid());
+	field.build(exits);
+
+	Maze::tDimension dim = cfg.getDim();
+	for (int x=0; x < dim.width; x++) {
+		for (int y=0; y < dim.height; y++) {
+			for (int z=0; z < dim.depth; z++) {
+				Maze::tCoord from = Maze::tCoord(x, y, z);
+				if (pMaze->getState(from) == Maze::CELL_SOLID) { continue; }
+
+				// Shortest route to any single exit
+				PathFind pathfinder;
+				pathfinder.setGrid(pMaze->getGrid());
+				pathfinder.setLoc(from);
+				int shortest = -1;
+				for (size_t e=0; e < exits.size(); e++) {
+					int steps = (from == exits[e]) ? 0 : pathfinder.findRoute(exits[e]).size();
+					if (steps == 0 && from != exits[e]) { continue; }
+					if (shortest < 0 || steps < shortest) { shortest = steps; }
+				}
+
+				for (int f=0; f < 2; f++) {
+					pathfinder.setStrategy(f == 0 ? PathFind::SEARCH_BFS : PathFind::SEARCH_DISTANCE_FIELD);
+					pathfinder.setDistanceField(&field);
+					Maze::tCoord dest;
+					PathFind::tRoute route = pathfinder.findNearestRoute(exits, dest);
+					if ((int)route.size() != shortest) {
+						sprintf(errStr, "%d, expected %d", (int)route.size(), shortest);
+						return "Nearest route from " + from.String() + " has the wrong length: " + string(errStr);
+					}
+					if (!route.empty() && dest != exits[0] && dest != exits[1]) {
+						return "Nearest route from " + from.String() + " leads to " + dest.String() + " instead of an exit";
+					}
+				}
+			}
+		}
+	}
+
+	// Bot A is 4 steps from the exit added on the bottom layer, and 9 from
+	// the first. Bot B is one step closer to the first.
+	Bot botA(pMaze, cfg.getBotCoords()['A']);
+	if (!botA.calcNearestRoute(exits) || botA.getDest() != Maze::tCoord(0,2,3)) {
+		return "Expected bot A to head for the exit at (0,2,3). Got: " + botA.getDest().String();
+	}
+	Bot botB(pMaze, cfg.getBotCoords()['B']);
+	if (!botB.calcNearestRoute(exits) || botB.getDest() != Maze::tCoord(4,2,0)) {
+		return "Expected bot B to head for the exit at (4,2,0). Got: " + botB.getDest().String();
+	}
+
+	return "";
+}
+
+/**
+ * Verifies the searches skip filled dead ends, finding routes as short
+ * as without them, and still find routes starting in a dead end.
+ * @param pTestData - pointer to test container, not used for these tests
+ * @returns error string if any.
+ */
+string PathFindTest::TestDeadEndPruning(TestUnit::tTestData* pTestData) {
+	char errStr[100] = {0x00};
+
+	// A corridor along the north wall, with a long tooth hanging off
+	// every other cell of it.
+	Maze maze(Maze::tDimension(7, 1, 7));
+	for (int x=0; x < 7; x++) {
+		for (int z=1; z < 7; z++) {
+			if (x % 2 == 0) { maze.updateCell(Maze::tCoord(x, 0, z), Maze::CELL_SOLID); }
+		}
+	}
+	Maze::tCoord from = Maze::tCoord(0,0,0);
+	Maze::tCoord dest = Maze::tCoord(6,0,0);
+	maze.updateCell(dest, Maze::CELL_EXIT);
+	maze.occupy(from);
+	if (maze.fillDeadEnds() != 18) {
+		return "Expected the 3 teeth to be filled.";
+	}
+
+	PathFind::eStrategy strategies[] = { PathFind::SEARCH_TREE, PathFind::SEARCH_BFS, PathFind::SEARCH_ASTAR,
+		PathFind::SEARCH_BIDIRECTIONAL };
+	for (int s=0; s < 4; s++) {
+		PathFind pathfinder;
+		pathfinder.setGrid(maze.getGrid());
+		pathfinder.setStrategy(strategies[s]);
+		pathfinder.setLoc(from);
+		PathFind::tRoute route = pathfinder.findRoute(dest);
+		if (route.size() != 6) {
+			sprintf(errStr, "%d, strategy %d", (int)route.size(), s);
+			return "Expected a route of 6 steps along the corridor. Got: " + string(errStr);
+		}
+		if (pathfinder.getExpandedCount() > 7) {
+			sprintf(errStr, "%ld, strategy %d", pathfinder.getExpandedCount(), s);
+			return "Expected the teeth to be skipped. Cells expanded: " + string(errStr);
+		}
+
+		// Routes out of a tooth don't skip it
+		pathfinder.setLoc(Maze::tCoord(3,0,6));
+		route = pathfinder.findRoute(dest);
+		if (route.size() != 9) {
+			sprintf(errStr, "%d, strategy %d", (int)route.size(), s);
+			return "Expected a route of 9 steps out of the tooth. Got: " + string(errStr);
+		}
+	}
+
+	// Nearest of several exits skips them too
+	PathFind pathfinder;
+	pathfinder.setGrid(maze.getGrid());
+	pathfinder.setLoc(from);
+	Maze::tCoords exits;
+	exits.push_back(dest);
+	exits.push_back(Maze::tCoord(5,0,6));
+	Maze::tCoord reached;
+	PathFind::tRoute route = pathfinder.findNearestRoute(exits, reached);
+	if (route.size() != 6 || reached != dest) {
+		sprintf(errStr, "%d", (int)route.size());
+		return "Expected the nearest route to lead along the corridor. Got: " + string(errStr);
+	}
+
+	return "";
+}
+
+/**
+ * Verifies the tree search re-roots its tree as the entity steps along
+ * a route, instead of searching again, and still finds the shortest routes.
+ * @param pTestData - pointer to test container, not used for these tests
+ * @returns error string if any.
+ */
+string PathFindTest::TestTreeReuse(TestUnit::tTestData* pTestData) {
+	char errStr[100] = {0x00};
+
+	tTestCont* pCont = (tTestCont*)pTestData->testObj;
+	if (pCont == NULL || pCont->pMaze == NULL) { return "Test data not loaded."; }
+	Maze* pMaze = pCont->pMaze;
+
+	PathFind pathfinder, bfs;
+	pathfinder.setGrid(pMaze->getGrid());
+	pathfinder.setStrategy(PathFind::SEARCH_TREE);
+	bfs.setGrid(pMaze->getGrid());
+
+	Maze::tCoord loc = Maze::tCoord(0,0,0);
+	Maze::tCoord destCoord = Maze::tCoord(2,1,2);
+	pathfinder.setLoc(loc);
+	PathFind::tRoute route = pathfinder.findRoute(destCoord);
+	if (route.size() != 15) {
+		sprintf(errStr, "%d", (int)route.size());
+		return "Expected a route of 15 steps to " + destCoord.String() + ". Got: " + string(errStr);
+	}
+
+	// Each step along the route re-roots the tree, and the rest of the
+	// route is read from it without expanding any cells.
+	long treeSize = pathfinder.getTree()->getIndex()->size();
+	while (route.size() > 1) {
+		loc = route.top();
+		pathfinder.setLoc(loc);
+		PathFind::tRoute next = pathfinder.findRoute(destCoord);
+		route.pop();
+		if (next.size() != route.size() || next.top() != route.top()) {
+			return "Expected the rest of the route from " + loc.String();
+		}
+		if (pathfinder.getExpandedCount() != 0 || *(pathfinder.getTree()) != loc) {
+			return "Expected the tree to be re-rooted at " + loc.String() + " instead of searched again";
+		}
+		long size = pathfinder.getTree()->getIndex()->size();
+		if (size > treeSize || pathfinder.getTree()->getParent() != NULL) {
+			return "Expected the tree's other branches to be pruned at " + loc.String();
+		}
+		treeSize = size;
+	}
+
+	// Other cells still in the tree are the shortest routes from the new root
+	Maze::tDimension dim = pMaze->getGrid()->dim;
+	for (int x=0; x < dim.width; x++) {
+		for (int y=0; y < dim.height; y++) {
+			for (int z=0; z < dim.depth; z++) {
+				Maze::tCoord cell = Maze::tCoord(x, y, z);
+				if (cell == loc || pathfinder.getTree()->getNode(cell) == NULL) { continue; }
+
+				bfs.setLoc(loc);
+				pathfinder.setLoc(loc);
+				int steps = pathfinder.findRoute(cell).size();
+				if (pathfinder.getExpandedCount() != 0 || steps != (int)bfs.findRoute(cell).size()) {
+					return "Expected the kept tree's route to " + cell.String() + " to be the shortest";
+				}
+			}
+		}
+	}
+
+	// Moving off of the tree drops it
+	pathfinder.setLoc(Maze::tCoord(0,0,0));
+	if (pathfinder.getTree() != NULL) {
+		return "Expected the tree to be dropped when moving off of it";
+	}
+	route = pathfinder.findRoute(destCoord);
+	if (route.size() != 15 || pathfinder.getExpandedCount() == 0) {
+		return "Expected a new tree to be searched after moving off of the old one";
+	}
+
+	// A wall change means the tree has to be searched again
+	pMaze->updateCell(Maze::tCoord(1,0,0), Maze::CELL_EMPTY);
+	pathfinder.setLoc(route.top());
+	if (pathfinder.getTree() != NULL) {
+		return "Expected the tree to be dropped after the grid changed";
+	}
+
+	return "";
+}
+
+/**
+ * Verifies a bot whose next cell stays occupied waits a few rounds,
+ * then takes a route around the occupant.
+ * @param pTestData - pointer to test container, not used for these tests
+ * @returns error string if any.
+ */
+string PathFindTest::TestBlockedBot(TestUnit::tTestData* pTestData) {
+	// A ring of cells around a wall, with a way round either side
+	Maze maze(Maze::tDimension(5, 1, 3));
+	for (int x=1; x < 4; x++) {
+		maze.updateCell(Maze::tCoord(x, 0, 1), Maze::CELL_SOLID);
+	}
+
+	Maze::tCoord start = Maze::tCoord(0,0,0);
+	Maze::tCoord dest = Maze::tCoord(4,0,0);
+	Bot bot(&maze, start);
+	maze.occupy(start);
+	if (!bot.calcRoute(dest) || bot.getRouteUsed() != "") {
+		return "Expected a route along the ring to " + dest.String();
+	}
+
+	// An entity that never moves sits on the bot's route
+	maze.occupy(Maze::tCoord(1,0,0));
+	for (int turn=0; turn < Bot::MAX_BLOCKED_TURNS; turn++) {
+		if (bot.move() || bot.getLoc() != start) {
+			return "Expected the bot to wait for the occupied cell";
+		}
+	}
+
+	for (int turn=0; turn < 10 && bot.getLoc() != dest; turn++) {
+		bot.move();
+	}
+	if (bot.getLoc() != dest || bot.getRouteUsed() != "SSEEEENN") {
+		return "Expected the bot to go around the occupied cell. Got: " + bot.getRouteUsed();
+	}
+
 	return "";
 }
@@ -32,11 +32,94 @@ private:
 	void afterEach(TestUnit::tTestData* pTestData);
 
 	/**
-	 * Verifies a grid can be loaded, and a path tree generated from it.
+	 * Verifies a grid can be loaded, and a path tree generated from it. Open
+	 * mazes must not add a cell to the tree more than once.
 	 * @param pTestData - pointer to test container, not used for these tests
 	 * @returns error string if any.
 	 */
 	static std::string TestGeneratePathTreeFromGrid(TestUnit::tTestData* pTestData);
+
+	/**
+	 * Verifies a route is found through mazes using the packed and sparse
+	 * storage, and the non linear layouts
+	 * @param pTestData - pointer to test container, not used for these tests
+	 * @returns error string if any.
+	 */
+	static std::string TestRouteOnGridVariants(TestUnit::tTestData* pTestData);
+
+	/**
+	 * Verifies the breadth first search finds the shortest route, handles
+	 * large open mazes, and returns no route for unreachable cells.
+	 * @param pTestData - pointer to test container, not used for these tests
+	 * @returns error string if any.
+	 */
+	static std::string TestBfsRoute(TestUnit::tTestData* pTestData);
+
+	/**
+	 * Verifies A* finds routes as short as the breadth first search while
+	 * expanding fewer cells.
+	 * @param pTestData - pointer to test container, not used for these tests
+	 * @returns error string if any.
+	 */
+	static std::string TestAStarRoute(TestUnit::tTestData* pTestData);
+
+	/**
+	 * Verifies the bidirectional search finds routes as short as the
+	 * breadth first search, which are connected from start to destination.
+	 * @param pTestData - pointer to test container, not used for these tests
+	 * @returns error string if any.
+	 */
+	static std::string TestBidirectionalRoute(TestUnit::tTestData* pTestData);
+
+	/**
+	 * Verifies the jump point search finds routes as short as the breadth
+	 * first search, filled in with every cell, while expanding few cells
+	 * in open rooms.
+	 * @param pTestData - pointer to test container, not used for these tests
+	 * @returns error string if any.
+	 */
+	static std::string TestJumpPointRoute(TestUnit::tTestData* pTestData);
+
+	/**
+	 * Verifies the incremental search keeps finding routes as short as the
+	 * breadth first search while the starting point moves and cells change,
+	 * and that a single changed cell is repaired without searching again.
+	 * @param pTestData - pointer to test container, not used for these tests
+	 * @returns error string if any.
+	 */
+	static std::string TestIncrementalRoute(TestUnit::tTestData* pTestData);
+
+	/**
+	 * Verifies routes to the nearest of several exits are as short as the
+	 * shortest route to any one of them, with and without a distance field.
+	 * @param pTestData - pointer to test container, not used for these tests
+	 * @returns error string if any.
+	 */
+	static std::string TestNearestRoute(TestUnit::tTestData* pTestData);
+
+	/**
+	 * Verifies the searches skip filled dead ends, finding routes as short
+	 * as without them, and still find routes starting in a dead end.
+	 * @param pTestData - pointer to test container, not used for these tests
+	 * @returns error string if any.
+	 */
+	static std::string TestDeadEndPruning(TestUnit::tTestData* pTestData);
+
+	/**
+	 * Verifies the tree search re-roots its tree as the entity steps along
+	 * a route, instead of searching again, and still finds the shortest routes.
+	 * @param pTestData - pointer to test container, not used for these tests
+	 * @returns error string if any.
+	 */
+	static std::string TestTreeReuse(TestUnit::tTestData* pTestData);
+
+	/**
+	 * Verifies a bot whose next cell stays occupied waits a few rounds,
+	 * then takes a route around the occupant.
+	 * @param pTestData - pointer to test container, not used for these tests
+	 * @returns error string if any.
+	 */
+	static std::string TestBlockedBot(TestUnit::tTestData* pTestData);
 };
 
 #endif //!defined(_PATHFIND_TEST_HPP)
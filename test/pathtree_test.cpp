@@ -19,6 +19,9 @@ PathTreeTest::PathTreeTest(): TestUnit() {
 	m_tests["PathTreeTest::TestAncstorCellSearch"] = &TestAncstorCellSearch;
 	m_tests["PathTreeTest::TestChangeTreeRoot"] = &TestChangeTreeRoot;
 	m_tests["PathTreeTest::TestSearchForNode"] = &TestSearchForNode;
+	m_tests["PathTreeTest::TestArenaTree"] = &TestArenaTree;
+	m_tests["PathTreeTest::TestIndexedTree"] = &TestIndexedTree;
+	m_tests["PathTreeTest::TestIndexedDuplicates"] = &TestIndexedDuplicates;
 }
 
 /**
@@ -40,11 +43,11 @@ void PathTreeTest::afterEach(TestUnit::tTestData* pTestData) {
  * @returns error string if any.
  */
 string PathTreeTest::TestCompareNodeToCell(TestUnit::tTestData* pTestData) {
-	Maze::tCell cell1 = Maze::tCell(Maze::CELL_EMPTY, Maze::tCoord(1,1,1));
-	Maze::tCell cell2 = Maze::tCell(Maze::CELL_EMPTY, Maze::tCoord(1,1,1));
-	Maze::tCell cell3 = Maze::tCell(Maze::CELL_EMPTY, Maze::tCoord(2,2,2));
+	Maze::tCoord cell1 = Maze::tCoord(1,1,1);
+	Maze::tCoord cell2 = Maze::tCoord(1,1,1);
+	Maze::tCoord cell3 = Maze::tCoord(2,2,2);
 
-	PathTree* root = new PathTree(NULL, &cell1);
+	PathTree* root = new PathTree(NULL, cell1);
 
 	if (*root != cell2) {
 		delete root;
@@ -67,15 +70,15 @@ string PathTreeTest::TestCompareNodeToCell(TestUnit::tTestData* pTestData) {
  * @returns error string if any.
  */
 string PathTreeTest::TestAddCellsToPathTree(TestUnit::tTestData* pTestData) {
-	Maze::tCell cell1 = Maze::tCell(Maze::CELL_EMPTY, Maze::tCoord(1,1,1));
-	Maze::tCell cell2 = Maze::tCell(Maze::CELL_EMPTY, Maze::tCoord(2,2,2));
-	Maze::tCell cell3 = Maze::tCell(Maze::CELL_EMPTY, Maze::tCoord(3,3,3));
-	Maze::tCell dupCell = Maze::tCell(Maze::CELL_EMPTY, Maze::tCoord(3,3,3));
+	Maze::tCoord cell1 = Maze::tCoord(1,1,1);
+	Maze::tCoord cell2 = Maze::tCoord(2,2,2);
+	Maze::tCoord cell3 = Maze::tCoord(3,3,3);
+	Maze::tCoord dupCell = Maze::tCoord(3,3,3);
 
-	PathTree* root = new PathTree(NULL, &cell1);
+	PathTree* root = new PathTree(NULL, cell1);
 
-	root->addChild(&cell2);
-	root->addChild(&cell3);
+	root->addChild(cell2);
+	root->addChild(cell3);
 
 	PathTree::tChildren children = root->getChildren();
 	if (*(children[0]) != cell2) {
@@ -86,7 +89,7 @@ string PathTreeTest::TestAddCellsToPathTree(TestUnit::tTestData* pTestData) {
 		delete root;
 		return "Child node 1 does not match cell 3";
 	}
-	if (root->addChild(&dupCell)) {
+	if (root->addChild(dupCell)) {
 		delete root;
 		return "Was able to add a duplicate cell to as a child to the node.";
 	}
@@ -101,26 +104,26 @@ string PathTreeTest::TestAddCellsToPathTree(TestUnit::tTestData* pTestData) {
  * @returns error string if any.
  */
 string PathTreeTest::TestAncstorCellSearch(TestUnit::tTestData* pTestData) {
-	Maze::tCell cell1 = Maze::tCell(Maze::CELL_EMPTY, Maze::tCoord(1,1,1));
-	Maze::tCell cell2 = Maze::tCell(Maze::CELL_EMPTY, Maze::tCoord(2,2,2));
-	Maze::tCell cell3 = Maze::tCell(Maze::CELL_EMPTY, Maze::tCoord(3,3,3));
-	Maze::tCell cell4 = Maze::tCell(Maze::CELL_EMPTY, Maze::tCoord(4,4,4));
+	Maze::tCoord cell1 = Maze::tCoord(1,1,1);
+	Maze::tCoord cell2 = Maze::tCoord(2,2,2);
+	Maze::tCoord cell3 = Maze::tCoord(3,3,3);
+	Maze::tCoord cell4 = Maze::tCoord(4,4,4);
 
-	PathTree* root = new PathTree(NULL, &cell1);
-	root->addChild(&cell2);
-	root->addChild(&cell4);
+	PathTree* root = new PathTree(NULL, cell1);
+	root->addChild(cell2);
+	root->addChild(cell4);
 
 	PathTree::tChildren children = root->getChildren();
-	if (!children[0]->addChild(&cell3)) {
+	if (!children[0]->addChild(cell3)) {
 		delete root;
 		return "Failed to add a cell to a child.";
 	}
 	children = children[0]->getChildren();
-	if (children[0]->addChild(&cell2)) {
+	if (children[0]->addChild(cell2)) {
 		delete root;
 		return "Incorrectly added a child cell which is an ancestor in this tree.";
 	}
-	if (!children[0]->addChild(&cell4)) {
+	if (!children[0]->addChild(cell4)) {
 		delete root;
 		return "Failed to add cell which is not a ancestor of this branch, but another.";
 	}
@@ -135,17 +138,17 @@ string PathTreeTest::TestAncstorCellSearch(TestUnit::tTestData* pTestData) {
  * @returns error string if any.
  */
 string PathTreeTest::TestChangeTreeRoot(TestUnit::tTestData* pTestData) {
-	Maze::tCell cell1 = Maze::tCell(Maze::CELL_EMPTY, Maze::tCoord(1,1,1));
-	Maze::tCell cell2 = Maze::tCell(Maze::CELL_EMPTY, Maze::tCoord(2,2,2));
-	Maze::tCell cell3 = Maze::tCell(Maze::CELL_EMPTY, Maze::tCoord(3,3,3));
-	Maze::tCell cell4 = Maze::tCell(Maze::CELL_EMPTY, Maze::tCoord(4,4,4));
-	Maze::tCell cell5 = Maze::tCell(Maze::CELL_EMPTY, Maze::tCoord(5,5,5));
-
-	PathTree* root = new PathTree(NULL, &cell1);
-	PathTree* last = root->addChild(&cell2);
-	last = last->addChild(&cell3);
-	last = last->addChild(&cell4);
-	last = last->addChild(&cell5);
+	Maze::tCoord cell1 = Maze::tCoord(1,1,1);
+	Maze::tCoord cell2 = Maze::tCoord(2,2,2);
+	Maze::tCoord cell3 = Maze::tCoord(3,3,3);
+	Maze::tCoord cell4 = Maze::tCoord(4,4,4);
+	Maze::tCoord cell5 = Maze::tCoord(5,5,5);
+
+	PathTree* root = new PathTree(NULL, cell1);
+	PathTree* last = root->addChild(cell2);
+	last = last->addChild(cell3);
+	last = last->addChild(cell4);
+	last = last->addChild(cell5);
 
 	last->makeRoot();
 
@@ -189,18 +192,18 @@ string PathTreeTest::TestChangeTreeRoot(TestUnit::tTestData* pTestData) {
  * @returns error string if any.
  */
 string PathTreeTest::TestSearchForNode(TestUnit::tTestData* pTestData) {
-	Maze::tCell cell1 = Maze::tCell(Maze::CELL_EMPTY, Maze::tCoord(1,1,1));
-	Maze::tCell cell2 = Maze::tCell(Maze::CELL_EMPTY, Maze::tCoord(2,2,2));
-	Maze::tCell cell3 = Maze::tCell(Maze::CELL_EMPTY, Maze::tCoord(3,3,3));
-	Maze::tCell cell4 = Maze::tCell(Maze::CELL_EMPTY, Maze::tCoord(4,4,4));
-	Maze::tCell cell5 = Maze::tCell(Maze::CELL_EMPTY, Maze::tCoord(5,5,5));
-
-	PathTree* root = new PathTree(NULL, &cell1);
-	PathTree* last = root->addChild(&cell2);
-	root->addChild(&cell5);
-	last = last->addChild(&cell3);
-	last = last->addChild(&cell4);
-	last = last->addChild(&cell5);
+	Maze::tCoord cell1 = Maze::tCoord(1,1,1);
+	Maze::tCoord cell2 = Maze::tCoord(2,2,2);
+	Maze::tCoord cell3 = Maze::tCoord(3,3,3);
+	Maze::tCoord cell4 = Maze::tCoord(4,4,4);
+	Maze::tCoord cell5 = Maze::tCoord(5,5,5);
+
+	PathTree* root = new PathTree(NULL, cell1);
+	PathTree* last = root->addChild(cell2);
+	root->addChild(cell5);
+	last = last->addChild(cell3);
+	last = last->addChild(cell4);
+	last = last->addChild(cell5);
 
 	PathTree* node = root->getNode(cell3);
 	if (node == NULL || *node != cell3) {
@@ -216,3 +219,167 @@ string PathTreeTest::TestSearchForNode(TestUnit::tTestData* pTestData) {
 
 	return "";
 }
+
+/**
+ * Verify a tree created in an arena keeps its children there, and
+ * can still be re-rooted and searched.
+ * @param pTestData - pointer to test container, not used for these tests
+ * @returns error string if any.
+ */
+string PathTreeTest::TestArenaTree(TestUnit::tTestData* pTestData) {
+	Maze::tCoord cell1 = Maze::tCoord(1,1,1);
+	Maze::tCoord cell2 = Maze::tCoord(2,2,2);
+	Maze::tCoord cell3 = Maze::tCoord(3,3,3);
+	Maze::tCoord cell4 = Maze::tCoord(4,4,4);
+
+	// Nodes in the arena are freed by releasing it, never deleted
+	Arena arena;
+	PathTree* root = PathTree::create(&arena, NULL, cell1);
+	PathTree* last = root->addChild(cell2);
+	root->addChild(cell4);
+	last = last->addChild(cell3);
+
+	if (root->getArena() != &arena || last->getArena() != &arena) {
+		return "Expected the children to be created in the root's arena.";
+	}
+	if (root->getChildren().get_allocator().getArena() != &arena) {
+		return "Expected the list of children to be kept in the arena.";
+	}
+	if (arena.getBytesUsed() < 4 * sizeof(PathTree)) {
+		return "Expected the nodes to be allocated from the arena.";
+	}
+	if (root->addChild(cell4) != NULL || last->addChild(cell2) != NULL) {
+		return "Was able to add a sibling or ancestor cell to an arena tree.";
+	}
+
+	last->makeRoot();
+	if (last->getParent() != NULL || last->getNode(cell4) == NULL || *(last->getNode(cell1)->getParent()) != cell2) {
+		return "The arena tree was not re-rooted correctly.";
+	}
+
+	arena.release();
+	if (arena.getBytesUsed() != 0) {
+		return "Expected releasing the arena to free the tree.";
+	}
+
+	return "";
+}
+
+/**
+ * Verify an indexed tree finds nodes through its index, and keeps the
+ * index up to date as nodes are added, removed, and re-rooted.
+ * @param pTestData - pointer to test container, not used for these tests
+ * @returns error string if any.
+ */
+string PathTreeTest::TestIndexedTree(TestUnit::tTestData* pTestData) {
+	Maze::tCoord cell1 = Maze::tCoord(1,1,1);
+	Maze::tCoord cell2 = Maze::tCoord(2,2,2);
+	Maze::tCoord cell3 = Maze::tCoord(3,3,3);
+	Maze::tCoord cell4 = Maze::tCoord(4,4,4);
+	// Outside of the dense index, kept in its map
+	Maze::tCoord cell5 = Maze::tCoord(9,9,9);
+
+	// Dense for cells within the dimension, and only the map without one
+	for (int dense=0; dense < 2; dense++) {
+		PathTreeIndex index = dense ? PathTreeIndex(Maze::tDimension(5, 5, 5)) : PathTreeIndex();
+
+		PathTree* root = new PathTree(NULL, cell1);
+		PathTree* second = root->addChild(cell2);
+		root->setIndex(&index);
+		PathTree* third = second->addChild(cell3);
+		PathTree* fifth = root->addChild(cell5);
+
+		if (index.size() != 4 || root->getNode(cell3) != third || root->getNode(cell5) != fifth) {
+			delete root;
+			return "Expected the nodes added before and after indexing to be found.";
+		}
+		if (root->getNode(cell4) != NULL) {
+			delete root;
+			return "Found a node for a cell that isn't in the tree.";
+		}
+
+		// Removed branches leave the index, and join it again when re-added
+		second->detach();
+		if (index.size() != 2 || root->getNode(cell3) != NULL || second->getIndex() != NULL) {
+			delete second;
+			delete root;
+			return "Expected a detached branch to be removed from the index.";
+		}
+		fifth->addChild(second);
+		if (index.size() != 4 || root->getNode(cell3) != third || third->getIndex() != &index) {
+			delete root;
+			return "Expected a re-added branch to be indexed again.";
+		}
+		root->removeChild(fifth);
+		if (index.size() != 1 || root->getNode(cell2) != NULL) {
+			delete fifth;
+			delete root;
+			return "Expected a removed child to be removed from the index.";
+		}
+		root->addChild(fifth);
+
+		// Re-rooting keeps every node in the index
+		third->makeRoot();
+		if (index.size() != 4 || third->getNode(cell1) != root || third->getNode(cell5) != fifth) {
+			delete third;
+			return "Expected the nodes to stay in the index when the tree is re-rooted.";
+		}
+
+		// Deleted nodes leave the index
+		PathTree* fourth = second->addChild(cell4);
+		if (third->getNode(cell4) != fourth) {
+			delete third;
+			return "Expected a child of the re-rooted tree to be indexed.";
+		}
+		fourth->detach();
+		delete fourth;
+		delete third;
+		if (index.size() != 0) {
+			return "Expected deleted nodes to be removed from the index.";
+		}
+	}
+
+	return "";
+}
+
+/**
+ * Verify a cell on more than one branch of an indexed tree is still
+ * found once the node in the index is removed.
+ * @param pTestData - pointer to test container, not used for these tests
+ * @returns error string if any.
+ */
+string PathTreeTest::TestIndexedDuplicates(TestUnit::tTestData* pTestData) {
+	Maze::tCoord cell1 = Maze::tCoord(1,1,1);
+	Maze::tCoord cell2 = Maze::tCoord(2,2,2);
+	Maze::tCoord cell3 = Maze::tCoord(3,3,3);
+	Maze::tCoord cell4 = Maze::tCoord(4,4,4);
+
+	PathTreeIndex index(Maze::tDimension(5, 5, 5));
+	PathTree* root = new PathTree(NULL, cell1);
+	root->setIndex(&index);
+
+	// Cell 4 is on both branches
+	PathTree* first = root->addChild(cell2)->addChild(cell4);
+	PathTree* second = root->addChild(cell3)->addChild(cell4);
+	if (!index.hasDuplicates() || root->getNode(cell4) != first) {
+		delete root;
+		return "Expected the first node of a cell to be the one indexed.";
+	}
+
+	first->detach();
+	delete first;
+	if (root->getNode(cell4) != second) {
+		delete root;
+		return "Expected the cell's other node to be found once the first was removed.";
+	}
+
+	second->detach();
+	delete second;
+	if (index.hasDuplicates() || root->getNode(cell4) != NULL) {
+		delete root;
+		return "Expected the cell to be gone once both nodes were removed.";
+	}
+
+	delete root;
+	return "";
+}
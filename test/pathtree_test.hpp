@@ -58,6 +58,30 @@ private:
 	 */
 	static std::string TestSearchForNode(TestUnit::tTestData* pTestData);
 
+	/**
+	 * Verify a tree created in an arena keeps its children there, and
+	 * can still be re-rooted and searched.
+	 * @param pTestData - pointer to test container, not used for these tests
+	 * @returns error string if any.
+	 */
+	static std::string TestArenaTree(TestUnit::tTestData* pTestData);
+
+	/**
+	 * Verify an indexed tree finds nodes through its index, and keeps the
+	 * index up to date as nodes are added, removed, and re-rooted.
+	 * @param pTestData - pointer to test container, not used for these tests
+	 * @returns error string if any.
+	 */
+	static std::string TestIndexedTree(TestUnit::tTestData* pTestData);
+
+	/**
+	 * Verify a cell on more than one branch of an indexed tree is still
+	 * found once the node in the index is removed.
+	 * @param pTestData - pointer to test container, not used for these tests
+	 * @returns error string if any.
+	 */
+	static std::string TestIndexedDuplicates(TestUnit::tTestData* pTestData);
+
 };
 
 #endif //!defined(_PATHTREE_TEST_HPP_)
@@ -0,0 +1,143 @@
+#include "routecache_test.hpp"
+#include "routecache.hpp"
+#include "pathfind.hpp"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+using namespace std;
+
+/**
+ * Initialize the test, and also make sure to initialize the 
+ * parent test unit as well.
+ */
+RouteCacheTest::RouteCacheTest(): TestUnit() {
+	m_tests["RouteCacheTest::TestCachedRoutes"] = &TestCachedRoutes;
+	m_tests["RouteCacheTest::TestEviction"] = &TestEviction;
+	m_tests["RouteCacheTest::TestInvalidation"] = &TestInvalidation;
+}
+
+/**
+ * Verify repeated queries are answered from the cache with the same
+ * route, and counted as hits
+ * @param pTestData - pointer to test container, not used for these tests
+ * @returns error string if any.
+ */
+string RouteCacheTest::TestCachedRoutes(TestUnit::tTestData* pTestData) {
+	char errStr[100] = {0x00};
+
+	Maze maze(Maze::tDimension(10, 10, 10));
+	maze.updateCell(Maze::tCoord(5,5,5), Maze::CELL_SOLID);
+	RouteCache cache(maze.getGrid());
+
+	PathFind pathfinder;
+	pathfinder.setGrid(maze.getGrid());
+	pathfinder.setRouteCache(&cache);
+	pathfinder.setLoc(Maze::tCoord(0,0,0));
+
+	PathFind::tRoute first = pathfinder.findRoute(Maze::tCoord(9,9,9));
+	if (cache.getMisses() != 1 || cache.getHits() != 0 || cache.size() != 1) {
+		return "Expected the first query to miss and be stored";
+	}
+
+	PathFind::tRoute second = pathfinder.findRoute(Maze::tCoord(9,9,9));
+	if (cache.getHits() != 1 || pathfinder.getExpandedCount() != 0) {
+		return "Expected the repeated query to hit without searching";
+	}
+	if (second != first) {
+		return "Expected the cached route to match the route found";
+	}
+
+	// Another strategy or destination is a separate route
+	pathfinder.setStrategy(PathFind::SEARCH_ASTAR);
+	pathfinder.findRoute(Maze::tCoord(9,9,9));
+	pathfinder.findRoute(Maze::tCoord(9,9,8));
+	if (cache.getMisses() != 3 || cache.size() != 3) {
+		sprintf(errStr, "%ld misses, %d cached", cache.getMisses(), (int)cache.size());
+		return "Expected other strategies and destinations to miss. Got: " + string(errStr);
+	}
+
+	// A cache of another grid is ignored
+	Maze other(Maze::tDimension(10, 10, 10));
+	RouteCache otherCache(other.getGrid());
+	pathfinder.setRouteCache(&otherCache);
+	if (pathfinder.findRoute(Maze::tCoord(9,9,9)).empty() || otherCache.getMisses() != 0) {
+		return "Expected a cache of another grid to be ignored";
+	}
+
+	return "";
+}
+
+/**
+ * Verify the least recently used route is dropped when the cache is full
+ * @param pTestData - pointer to test container, not used for these tests
+ * @returns error string if any.
+ */
+string RouteCacheTest::TestEviction(TestUnit::tTestData* pTestData) {
+	Maze maze(Maze::tDimension(4, 4, 4));
+	RouteCache cache(maze.getGrid(), 2);
+	RouteCache::tRoute route;
+	route.push(Maze::tCoord(1,0,0));
+
+	cache.store(0, 1, 2, route);
+	cache.store(0, 1, 3, route);
+	// Using the first route makes the second the least recently used
+	if (!cache.lookup(0, 1, 2, route)) {
+		return "Expected the first route to be cached";
+	}
+	cache.store(0, 1, 4, route);
+
+	if (cache.size() != 2) {
+		return "Expected the cache to stay at its capacity";
+	}
+	if (cache.lookup(0, 1, 3, route)) {
+		return "Expected the least recently used route to be dropped";
+	}
+	if (!cache.lookup(0, 1, 2, route) || !cache.lookup(0, 1, 4, route)) {
+		return "Expected the recently used routes to be kept";
+	}
+
+	return "";
+}
+
+/**
+ * Verify walling off a cell empties the cache, and moving bots don't
+ * @param pTestData - pointer to test container, not used for these tests
+ * @returns error string if any.
+ */
+string RouteCacheTest::TestInvalidation(TestUnit::tTestData* pTestData) {
+	Maze maze(Maze::tDimension(1, 1, 5));
+	RouteCache cache(maze.getGrid());
+	PathFind pathfinder;
+	pathfinder.setGrid(maze.getGrid());
+	pathfinder.setRouteCache(&cache);
+	pathfinder.setLoc(Maze::tCoord(0,0,0));
+
+	if (pathfinder.findRoute(Maze::tCoord(0,0,4)).size() != 4) {
+		return "Expected a route along the corridor";
+	}
+
+	// Occupancy is kept out of the grid, so the route is still valid
+	maze.occupy(Maze::tCoord(0,0,2));
+	pathfinder.findRoute(Maze::tCoord(0,0,4));
+	if (cache.getHits() != 1 || cache.getInvalidations() != 0) {
+		return "Expected an occupied cell to leave the cache alone";
+	}
+	maze.vacate(Maze::tCoord(0,0,2));
+
+	maze.updateCell(Maze::tCoord(0,0,2), Maze::CELL_SOLID);
+	if (!pathfinder.findRoute(Maze::tCoord(0,0,4)).empty()) {
+		return "Expected the cached route to be dropped once the corridor is walled off";
+	}
+	if (cache.getInvalidations() != 1 || cache.getMisses() != 2) {
+		return "Expected the wall to invalidate the cache";
+	}
+
+	// Unreachable destinations are cached too
+	pathfinder.findRoute(Maze::tCoord(0,0,4));
+	if (cache.getHits() != 2) {
+		return "Expected the unreachable destination to be cached";
+	}
+
+	return "";
+}
@@ -0,0 +1,42 @@
+#ifndef _ROUTECACHE_TEST_HPP_
+#define _ROUTECACHE_TEST_HPP_
+
+#include <string>
+
+#include "test_unit.hpp"
+
+class RouteCacheTest : public TestUnit {
+public:
+
+	/**
+	 * Initialize the test, and also make sure to initialize the 
+	 * parent test unit as well.
+	 */
+	RouteCacheTest();
+
+private:
+
+	/**
+	 * Verify repeated queries are answered from the cache with the same
+	 * route, and counted as hits
+	 * @param pTestData - pointer to test container, not used for these tests
+	 * @returns error string if any.
+	 */
+	static std::string TestCachedRoutes(TestUnit::tTestData* pTestData);
+
+	/**
+	 * Verify the least recently used route is dropped when the cache is full
+	 * @param pTestData - pointer to test container, not used for these tests
+	 * @returns error string if any.
+	 */
+	static std::string TestEviction(TestUnit::tTestData* pTestData);
+
+	/**
+	 * Verify walling off a cell empties the cache, and moving bots don't
+	 * @param pTestData - pointer to test container, not used for these tests
+	 * @returns error string if any.
+	 */
+	static std::string TestInvalidation(TestUnit::tTestData* pTestData);
+};
+
+#endif //!defined(_ROUTECACHE_TEST_HPP_)
@@ -0,0 +1,109 @@
+#include "test_routes.hpp"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+using namespace std;
+
+/**
+ * Verifies every step of the route moves to an adjacent open cell, and
+ * that the route ends at the destination.
+ * @param maze - maze the route was found in
+ * @param from - starting point of the route, not part of the route
+ * @param dest - destination the route must end at
+ * @param route - route to check
+ * @returns error string if any.
+ */
+string TestRoutes::checkRoute(Maze &maze, Maze::tCoord from, Maze::tCoord dest, stack<Maze::tCoord> route) {
+	Maze::tCoord loc = from;
+	while (!route.empty()) {
+		Maze::tCoord next = route.top();
+		route.pop();
+		if (loc.distance(next) != 1 || maze.getState(next) == Maze::CELL_SOLID) {
+			return "Route moves from " + loc.String() + " to invalid cell " + next.String();
+		}
+		loc = next;
+	}
+	if (loc != dest) {
+		return "Route ended at " + loc.String() + " instead of " + dest.String();
+	}
+
+	return "";
+}
+
+/**
+ * Walls off every neighbor of the cell inside of the maze, so the cell
+ * can't be reached from anywhere else.
+ * @param maze - maze to update
+ * @param cell - cell to wall off
+ */
+void TestRoutes::wallOff(Maze &maze, Maze::tCoord cell) {
+	for (int dir=0; dir < Maze::NUM_DIRECTIONS; dir++) {
+		Maze::tCoord next = cell + Maze::step((Maze::eDirection)dir);
+		if (maze.getGrid()->contains(next)) {
+			maze.updateCell(next, Maze::CELL_SOLID);
+		}
+	}
+}
+
+/**
+ * Walls off the destination, and verifies the pathfinder no longer
+ * finds a route to it.
+ * @param maze - maze the pathfinder searches
+ * @param pathfinder - pathfinder with its grid and location set
+ * @param dest - destination to wall off
+ * @returns error string if any.
+ */
+string TestRoutes::checkWalledOff(Maze &maze, PathFind &pathfinder, Maze::tCoord dest) {
+	wallOff(maze, dest);
+	if (!pathfinder.findRoute(dest).empty()) {
+		return "Found a route to a walled off cell";
+	}
+
+	return "";
+}
+
+/**
+ * Walls off a random quarter of the maze's cells, forcing detours
+ * between its first and last corners, and verifies the strategy finds
+ * a route between them as short as the breadth first search's.
+ * @param maze - maze to add the walls to
+ * @param strategy - search to compare with breadth first
+ * @param seed - seed of the random walls, same seed same walls
+ * @param pExpanded - set to the cells the strategy expanded, if not NULL
+ * @param pBfsExpanded - set to the cells breadth first expanded, if not NULL
+ * @returns error string if any.
+ */
+string TestRoutes::checkDetours(Maze &maze, PathFind::eStrategy strategy, unsigned int seed,
+		long* pExpanded, long* pBfsExpanded) {
+	char errStr[100] = {0x00};
+
+	Maze::tDimension dim = maze.getGrid()->dim;
+	srand(seed);
+	for (long idx=0; idx < (long)dim.width * dim.height * dim.depth / 4; idx++) {
+		maze.updateCell(Maze::tCoord(rand() % dim.width, rand() % dim.height, rand() % dim.depth), Maze::CELL_SOLID);
+	}
+	Maze::tCoord from = Maze::tCoord(0,0,0);
+	Maze::tCoord dest = Maze::tCoord(dim.width - 1, dim.height - 1, dim.depth - 1);
+	maze.updateCell(from, Maze::CELL_EMPTY);
+	maze.updateCell(dest, Maze::CELL_EMPTY);
+
+	PathFind bfs, pathfinder;
+	bfs.setGrid(maze.getGrid());
+	bfs.setStrategy(PathFind::SEARCH_BFS);
+	bfs.setLoc(from);
+	pathfinder.setGrid(maze.getGrid());
+	pathfinder.setStrategy(strategy);
+	pathfinder.setLoc(from);
+
+	PathFind::tRoute bfsRoute = bfs.findRoute(dest);
+	PathFind::tRoute route = pathfinder.findRoute(dest);
+	if (pExpanded != NULL) { *pExpanded = pathfinder.getExpandedCount(); }
+	if (pBfsExpanded != NULL) { *pBfsExpanded = bfs.getExpandedCount(); }
+	if (route.size() != bfsRoute.size()) {
+		sprintf(errStr, "%d != %d", (int)route.size(), (int)bfsRoute.size());
+		return "Route length around the walls does not match breadth first: " + string(errStr);
+	}
+
+	return checkRoute(maze, from, dest, route);
+}
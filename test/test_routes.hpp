@@ -0,0 +1,59 @@
+#ifndef _TEST_ROUTES_HPP_
+#define _TEST_ROUTES_HPP_
+
+#include "maze.hpp"
+#include "pathfind.hpp"
+
+#include <stack>
+#include <string>
+
+/**
+ * Checks shared by the tests of the different ways routes are found
+ */
+namespace TestRoutes {
+
+	/**
+	 * Verifies every step of the route moves to an adjacent open cell, and
+	 * that the route ends at the destination.
+	 * @param maze - maze the route was found in
+	 * @param from - starting point of the route, not part of the route
+	 * @param dest - destination the route must end at
+	 * @param route - route to check
+	 * @returns error string if any.
+	 */
+	std::string checkRoute(Maze &maze, Maze::tCoord from, Maze::tCoord dest, std::stack<Maze::tCoord> route);
+
+	/**
+	 * Walls off every neighbor of the cell inside of the maze, so the cell
+	 * can't be reached from anywhere else.
+	 * @param maze - maze to update
+	 * @param cell - cell to wall off
+	 */
+	void wallOff(Maze &maze, Maze::tCoord cell);
+
+	/**
+	 * Walls off the destination, and verifies the pathfinder no longer
+	 * finds a route to it.
+	 * @param maze - maze the pathfinder searches
+	 * @param pathfinder - pathfinder with its grid and location set
+	 * @param dest - destination to wall off
+	 * @returns error string if any.
+	 */
+	std::string checkWalledOff(Maze &maze, PathFind &pathfinder, Maze::tCoord dest);
+
+	/**
+	 * Walls off a random quarter of the maze's cells, forcing detours
+	 * between its first and last corners, and verifies the strategy finds
+	 * a route between them as short as the breadth first search's.
+	 * @param maze - maze to add the walls to
+	 * @param strategy - search to compare with breadth first
+	 * @param seed - seed of the random walls, same seed same walls
+	 * @param pExpanded - set to the cells the strategy expanded, if not NULL
+	 * @param pBfsExpanded - set to the cells breadth first expanded, if not NULL
+	 * @returns error string if any.
+	 */
+	std::string checkDetours(Maze &maze, PathFind::eStrategy strategy, unsigned int seed,
+		long* pExpanded=NULL, long* pBfsExpanded=NULL);
+}
+
+#endif // !defined(_TEST_ROUTES_HPP_)
@@ -0,0 +1,112 @@
+#include "wavefront_test.hpp"
+#include "wavefront.hpp"
+#include "distancefield.hpp"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+using namespace std;
+
+/**
+ * Initialize the test, and also make sure to initialize the 
+ * parent test unit as well.
+ */
+WaveFrontTest::WaveFrontTest(): TestUnit() {
+	m_tests["WaveFrontTest::TestDistances"] = &TestDistances;
+	m_tests["WaveFrontTest::TestFlood"] = &TestFlood;
+}
+
+/**
+ * Verify the distances found a word at a time match the distance
+ * field's, for both cell and packed storage
+ * @param pTestData - pointer to test container, not used for these tests
+ * @returns error string if any.
+ */
+string WaveFrontTest::TestDistances(TestUnit::tTestData* pTestData) {
+	char errStr[100] = {0x00};
+
+	// Rows of 62 cells fill a word exactly with the border, so whole
+	// word and part word shifts are both covered.
+	Maze::tDimension dims[] = { Maze::tDimension(20, 12, 20), Maze::tDimension(9, 7, 62) };
+	Maze::eStorage storages[] = { Maze::STORAGE_CELLS, Maze::STORAGE_PACKED };
+	for (int d=0; d < 2; d++) {
+		for (int s=0; s < 2; s++) {
+			Maze::tDimension dim = dims[d];
+			Maze maze(dim, storages[s]);
+			srand(11);
+			for (int idx=0; idx < dim.width * dim.height * dim.depth / 4; idx++) {
+				maze.updateCell(Maze::tCoord(rand() % dim.width, rand() % dim.height, rand() % dim.depth), Maze::CELL_SOLID);
+			}
+			Maze::tCoord from = Maze::tCoord(dim.width / 2, dim.height / 2, dim.depth / 2);
+			maze.updateCell(from, Maze::CELL_EMPTY);
+
+			DistanceField field(maze.getGrid());
+			field.build(from);
+			WaveFront wave(maze.getGrid());
+			vector<int> dist;
+			wave.distances(from, dist);
+
+			for (int x=0; x < dim.width; x++) {
+				for (int y=0; y < dim.height; y++) {
+					for (int z=0; z < dim.depth; z++) {
+						Maze::tCoord loc = Maze::tCoord(x, y, z);
+						int expected = field.getDistance(loc);
+						if (dist[maze.getGrid()->index(loc)] != expected) {
+							sprintf(errStr, "%d, expected %d", dist[maze.getGrid()->index(loc)], expected);
+							return "Distance to " + loc.String() + " does not match the distance field: " + string(errStr);
+						}
+						if (expected > 0 && wave.distance(from, loc) != expected) {
+							return "Distance between " + from.String() + " and " + loc.String() + " does not match";
+						}
+					}
+				}
+			}
+		}
+	}
+
+	return "";
+}
+
+/**
+ * Verify the flood reaches the cells of an area and no others, and
+ * sees walls added after the last flood
+ * @param pTestData - pointer to test container, not used for these tests
+ * @returns error string if any.
+ */
+string WaveFrontTest::TestFlood(TestUnit::tTestData* pTestData) {
+	char errStr[100] = {0x00};
+
+	Maze maze(Maze::tDimension(8, 8, 8));
+	WaveFront wave(maze.getGrid());
+	if (!wave.isSupported()) {
+		return "Expected the linear layout to be supported";
+	}
+	if (wave.flood(Maze::tCoord(0,0,0)) != 512 || wave.getLevels() != 21) {
+		sprintf(errStr, "%ld cells in %d levels", wave.flood(Maze::tCoord(0,0,0)), wave.getLevels());
+		return "Expected the open maze to flood 512 cells in 21 levels. Got: " + string(errStr);
+	}
+
+	// Split the maze in two along X
+	for (int y=0; y < 8; y++) {
+		for (int z=0; z < 8; z++) {
+			maze.updateCell(Maze::tCoord(3,y,z), Maze::CELL_SOLID);
+		}
+	}
+	if (wave.flood(Maze::tCoord(7,7,7)) != 4 * 64) {
+		return "Expected the flood to stop at the wall";
+	}
+	if (wave.isReached(Maze::tCoord(0,0,0)) || !wave.isReached(Maze::tCoord(4,0,0))) {
+		return "Expected only the cells on the flooded side to be reached";
+	}
+	if (wave.distance(Maze::tCoord(7,7,7), Maze::tCoord(0,0,0)) != -1) {
+		return "Expected no distance across the wall";
+	}
+
+	Maze morton(Maze::tDimension(8, 8, 8), Maze::STORAGE_CELLS, Maze::LAYOUT_MORTON);
+	WaveFront unsupported(morton.getGrid());
+	if (unsupported.isSupported() || unsupported.flood(Maze::tCoord(0,0,0)) != 0) {
+		return "Expected the Morton layout to be unsupported";
+	}
+
+	return "";
+}
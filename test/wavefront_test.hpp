@@ -0,0 +1,36 @@
+#ifndef _WAVEFRONT_TEST_HPP_
+#define _WAVEFRONT_TEST_HPP_
+
+#include <string>
+
+#include "test_unit.hpp"
+
+class WaveFrontTest : public TestUnit {
+public:
+
+	/**
+	 * Initialize the test, and also make sure to initialize the 
+	 * parent test unit as well.
+	 */
+	WaveFrontTest();
+
+private:
+
+	/**
+	 * Verify the distances found a word at a time match the distance
+	 * field's, for both cell and packed storage
+	 * @param pTestData - pointer to test container, not used for these tests
+	 * @returns error string if any.
+	 */
+	static std::string TestDistances(TestUnit::tTestData* pTestData);
+
+	/**
+	 * Verify the flood reaches the cells of an area and no others, and
+	 * sees walls added after the last flood
+	 * @param pTestData - pointer to test container, not used for these tests
+	 * @returns error string if any.
+	 */
+	static std::string TestFlood(TestUnit::tTestData* pTestData);
+};
+
+#endif //!defined(_WAVEFRONT_TEST_HPP_)